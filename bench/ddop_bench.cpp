@@ -0,0 +1,460 @@
+//================================================================================================
+/// @file ddop_bench.cpp
+///
+/// @brief Measures how fast DDOPs of various sizes can be loaded, serialized, exported and walked
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso and the Open-Agriculture developers
+//================================================================================================
+#include "iso_xml_writer.hpp"
+#include "isobus/isobus/isobus_data_dictionary.hpp"
+#include "isobus/isobus/isobus_device_descriptor_object_pool.hpp"
+#include "json_writer.hpp"
+#include "logsink.hpp"
+#include "object_label_cache.hpp"
+#include "object_pool_snapshot.hpp"
+#include "object_tree_index.hpp"
+#include "synthetic_pool.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace
+{
+	struct BenchmarkOptions
+	{
+		std::vector<SyntheticPoolShape> shapes;
+		std::string outputPath;
+		std::string runLabel;
+		std::uint32_t iterations = 10;
+		std::uint8_t taskControllerVersion = 4;
+	};
+
+	struct TimingResult
+	{
+		std::string name;
+		double minimum_ms = 0.0;
+		double median_ms = 0.0;
+		double mean_ms = 0.0;
+		double maximum_ms = 0.0;
+		bool succeeded = true;
+	};
+
+	/// @brief Runs a function once to warm up, then times it for a number of iterations
+	TimingResult time_operation(const std::string &name, std::uint32_t iterations, const std::function<bool()> &operation)
+	{
+		TimingResult retVal;
+		std::vector<double> samples_ms;
+
+		retVal.name = name;
+		retVal.succeeded = operation();
+
+		for (std::uint32_t i = 0; retVal.succeeded && (i < iterations); i++)
+		{
+			auto startTime = std::chrono::steady_clock::now();
+			retVal.succeeded = operation();
+			samples_ms.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count());
+		}
+
+		if (!samples_ms.empty())
+		{
+			std::sort(samples_ms.begin(), samples_ms.end());
+			retVal.minimum_ms = samples_ms.front();
+			retVal.maximum_ms = samples_ms.back();
+			retVal.median_ms = samples_ms[samples_ms.size() / 2];
+
+			for (double sample_ms : samples_ms)
+			{
+				retVal.mean_ms += sample_ms;
+			}
+			retVal.mean_ms /= static_cast<double>(samples_ms.size());
+		}
+		return retVal;
+	}
+
+	/// @brief A stream buffer that throws away everything written to it, to time a writer without any I/O
+	class DiscardBuffer : public std::streambuf
+	{
+	protected:
+		int_type overflow(int_type character) override
+		{
+			return traits_type::not_eof(character);
+		}
+
+		std::streamsize xsputn(const char *, std::streamsize count) override
+		{
+			return count;
+		}
+	};
+
+	/// @brief Builds a tree node label the same way the GUI does
+	std::string build_object_label(ObjectView object)
+	{
+		std::string displayName = object->get_designator();
+
+		if (displayName.empty() || ("Designator" == displayName))
+		{
+			if (auto processData = object.as_process_data())
+			{
+				displayName = isobus::DataDictionary::get_entry(processData->get_ddi()).name;
+			}
+			else if (auto property = object.as_property())
+			{
+				displayName = isobus::DataDictionary::get_entry(property->get_ddi()).name;
+			}
+		}
+		return displayName + " (" + object->get_table_id() + " " + std::to_string(object->get_object_id()) + ")";
+	}
+
+	const std::string &get_object_label(ObjectLabelCache &labelCache, ObjectView object)
+	{
+		auto cachedLabel = labelCache.get(object->get_object_id(), ObjectLabelCache::LabelType::Name);
+
+		if (nullptr == cachedLabel)
+		{
+			cachedLabel = &labelCache.set(object->get_object_id(), ObjectLabelCache::LabelType::Name, build_object_label(object));
+		}
+		return *cachedLabel;
+	}
+
+	/// @brief Visits every element and child object the way the GUI does when the whole tree is expanded
+	std::size_t walk_elements(ObjectTreeIndex &treeIndex, ObjectLabelCache &labelCache, std::uint16_t parentID)
+	{
+		std::size_t retVal = 0;
+
+		for (auto &element : treeIndex.get_child_elements(parentID))
+		{
+			retVal += get_object_label(labelCache, element).size();
+
+			for (std::uint16_t i = 0; i < element->get_number_child_objects(); i++)
+			{
+				ObjectView child = treeIndex.get_object_view(element->get_child_object_id(i));
+
+				if (child.is_valid() &&
+				    (isobus::task_controller_object::ObjectTypes::DeviceElement != child.get_type()))
+				{
+					retVal += get_object_label(labelCache, child).size();
+				}
+			}
+			retVal += walk_elements(treeIndex, labelCache, element->get_object_id());
+		}
+		return retVal;
+	}
+
+	std::size_t walk_tree(ObjectTreeIndex &treeIndex, ObjectLabelCache &labelCache)
+	{
+		std::size_t retVal = 0;
+		auto &device = treeIndex.get_device();
+
+		if (nullptr != device)
+		{
+			retVal = get_object_label(labelCache, device).size() + walk_elements(treeIndex, labelCache, device->get_object_id());
+		}
+		return retVal;
+	}
+
+	void write_timing(JsonWriter &json, const TimingResult &timing)
+	{
+		json.begin_object(timing.name);
+		json.write("succeeded", timing.succeeded);
+		json.write("minMs", timing.minimum_ms);
+		json.write("medianMs", timing.median_ms);
+		json.write("meanMs", timing.mean_ms);
+		json.write("maxMs", timing.maximum_ms);
+		json.end_object();
+	}
+
+	/// @brief Returns the DDI of the first process data object, so the DDI filters have something to find
+	std::uint16_t find_first_ddi(isobus::DeviceDescriptorObjectPool &pool)
+	{
+		for (std::uint32_t i = 0; i < pool.size(); i++)
+		{
+			auto object = pool.get_object_by_index(i);
+
+			if ((nullptr != object) && (isobus::task_controller_object::ObjectTypes::DeviceProcessData == object->get_object_type()))
+			{
+				return std::static_pointer_cast<isobus::task_controller_object::DeviceProcessDataObject>(object)->get_ddi();
+			}
+		}
+		return 0;
+	}
+
+	/// @brief Finds the process data and properties with a DDI by walking the pool's objects one by one
+	void select_ddi_from_pool(isobus::DeviceDescriptorObjectPool &pool, std::uint16_t ddi, std::vector<std::uint32_t> &rows)
+	{
+		for (std::uint32_t i = 0; i < pool.size(); i++)
+		{
+			auto object = pool.get_object_by_index(i);
+
+			if (nullptr == object)
+			{
+				continue;
+			}
+
+			if ((isobus::task_controller_object::ObjectTypes::DeviceProcessData == object->get_object_type()) &&
+			    (ddi == std::static_pointer_cast<isobus::task_controller_object::DeviceProcessDataObject>(object)->get_ddi()))
+			{
+				rows.push_back(i);
+			}
+			else if ((isobus::task_controller_object::ObjectTypes::DeviceProperty == object->get_object_type()) &&
+			         (ddi == std::static_pointer_cast<isobus::task_controller_object::DevicePropertyObject>(object)->get_ddi()))
+			{
+				rows.push_back(i);
+			}
+		}
+	}
+
+	void run_shape(const SyntheticPoolShape &shape, const BenchmarkOptions &options, JsonWriter &json)
+	{
+		isobus::DeviceDescriptorObjectPool sourcePool;
+		sourcePool.set_task_controller_compatibility_level(options.taskControllerVersion);
+
+		json.begin_object();
+		json.write("name", shape.name);
+		json.write("depth", shape.depth);
+		json.write("fanOut", shape.fanOut);
+		json.write("processDataPerElement", shape.processDataPerElement);
+		json.write("propertiesPerElement", shape.propertiesPerElement);
+		json.write("presentations", shape.presentations);
+
+		if (!generate_synthetic_pool(shape, sourcePool))
+		{
+			std::fprintf(stderr, "Could not generate shape \"%s\" with %llu objects. A DDOP can hold at most 65534.\n", shape.name.c_str(), static_cast<unsigned long long>(shape.get_number_of_objects()));
+			json.write("error", "could not generate pool");
+			json.end_object();
+			return;
+		}
+
+		std::vector<std::uint8_t> binaryPool;
+		std::string isoXML;
+		sourcePool.generate_binary_object_pool(binaryPool);
+		sourcePool.generate_task_data_iso_xml(isoXML);
+
+		json.write("objects", sourcePool.size());
+		json.write("binarySize", binaryPool.size());
+		json.write("isoXmlSize", isoXML.size());
+		json.begin_object("results");
+
+		write_timing(json, time_operation("deserialize", options.iterations, [&]() {
+			isobus::DeviceDescriptorObjectPool pool;
+			pool.set_task_controller_compatibility_level(options.taskControllerVersion);
+			return pool.deserialize_binary_object_pool(binaryPool, isobus::NAME(0));
+		}));
+
+		write_timing(json, time_operation("serialize", options.iterations, [&]() {
+			std::vector<std::uint8_t> output;
+			return sourcePool.generate_binary_object_pool(output);
+		}));
+
+		write_timing(json, time_operation("exportIsoXml", options.iterations, [&]() {
+			std::string output;
+			return sourcePool.generate_task_data_iso_xml(output);
+		}));
+
+		write_timing(json, time_operation("streamIsoXml", options.iterations, [&]() {
+			DiscardBuffer discardBuffer;
+			std::ostream output(&discardBuffer);
+			return IsoXmlWriter::write_task_data(sourcePool, output);
+		}));
+
+		ObjectTreeIndex treeIndex;
+		write_timing(json, time_operation("treeIndexBuild", options.iterations, [&]() {
+			treeIndex.rebuild(sourcePool);
+			return nullptr != treeIndex.get_device();
+		}));
+
+		// A steady state GUI frame, where every label is already cached
+		ObjectLabelCache labelCache;
+		write_timing(json, time_operation("treeWalk", options.iterations, [&]() {
+			return 0 != walk_tree(treeIndex, labelCache);
+		}));
+
+		// The first frame after loading, or after every label was invalidated
+		write_timing(json, time_operation("treeWalkColdLabels", options.iterations, [&]() {
+			labelCache.clear();
+			return 0 != walk_tree(treeIndex, labelCache);
+		}));
+
+		ObjectPoolSnapshot snapshot;
+		write_timing(json, time_operation("snapshotBuild", options.iterations, [&]() {
+			snapshot.rebuild(sourcePool);
+			return snapshot.size() == sourcePool.size();
+		}));
+
+		// Filtering by DDI the way the GUI did before the snapshot, and then with it
+		const std::uint16_t searchedDDI = find_first_ddi(sourcePool);
+		std::vector<std::uint32_t> matchingRows;
+		write_timing(json, time_operation("poolSelectDdi", options.iterations, [&]() {
+			matchingRows.clear();
+			select_ddi_from_pool(sourcePool, searchedDDI, matchingRows);
+			return true;
+		}));
+
+		write_timing(json, time_operation("snapshotSelectDdi", options.iterations, [&]() {
+			matchingRows.clear();
+			snapshot.select_ddi(searchedDDI, matchingRows);
+			return true;
+		}));
+
+		json.end_object();
+		json.end_object();
+
+		std::fprintf(stderr, "Finished \"%s\" (%u objects)\n", shape.name.c_str(), sourcePool.size());
+	}
+
+	void print_usage(const char *programName)
+	{
+		std::fprintf(stderr,
+		             "Usage: %s [options]\n"
+		             "\n"
+		             "Without any shape options, a small, medium and large pool are benchmarked.\n"
+		             "\n"
+		             "Options:\n"
+		             "  --iterations <count>  Timed runs of each operation (default 10)\n"
+		             "  --tc-version <3|4>    TC version used to parse the DDOPs (default 4)\n"
+		             "  --output <file>       Write the JSON results to a file instead of stdout\n"
+		             "  --label <text>        Label stored in the results, such as a commit hash\n"
+		             "  --depth <count>       Number of element levels below the device\n"
+		             "  --fan-out <count>     Number of child elements of each element\n"
+		             "  --dpd <count>         Process data objects per element\n"
+		             "  --dpt <count>         Property objects per element\n"
+		             "  --dvp <count>         Value presentations shared by all process data and properties\n",
+		             programName);
+	}
+
+	bool parse_arguments(int argumentCount, char *argumentValues[], BenchmarkOptions &options)
+	{
+		SyntheticPoolShape customShape;
+		bool hasCustomShape = false;
+
+		customShape.name = "custom";
+
+		for (int i = 1; i < argumentCount; i++)
+		{
+			std::string argument(argumentValues[i]);
+
+			if (i + 1 >= argumentCount)
+			{
+				std::fprintf(stderr, "%s requires a value\n", argument.c_str());
+				return false;
+			}
+
+			std::string value(argumentValues[++i]);
+			auto number = static_cast<std::uint32_t>(std::strtoul(value.c_str(), nullptr, 10));
+
+			if ("--iterations" == argument)
+			{
+				options.iterations = std::max<std::uint32_t>(number, 1);
+			}
+			else if ("--tc-version" == argument)
+			{
+				options.taskControllerVersion = static_cast<std::uint8_t>(number);
+			}
+			else if ("--output" == argument)
+			{
+				options.outputPath = value;
+			}
+			else if ("--label" == argument)
+			{
+				options.runLabel = value;
+			}
+			else if ("--depth" == argument)
+			{
+				customShape.depth = number;
+				hasCustomShape = true;
+			}
+			else if ("--fan-out" == argument)
+			{
+				customShape.fanOut = number;
+				hasCustomShape = true;
+			}
+			else if ("--dpd" == argument)
+			{
+				customShape.processDataPerElement = number;
+				hasCustomShape = true;
+			}
+			else if ("--dpt" == argument)
+			{
+				customShape.propertiesPerElement = number;
+				hasCustomShape = true;
+			}
+			else if ("--dvp" == argument)
+			{
+				customShape.presentations = number;
+				hasCustomShape = true;
+			}
+			else
+			{
+				std::fprintf(stderr, "Unknown option \"%s\"\n", argument.c_str());
+				return false;
+			}
+		}
+
+		if (hasCustomShape)
+		{
+			options.shapes.push_back(customShape);
+		}
+		else
+		{
+			options.shapes.push_back({ "small", 2, 4, 4, 2, 8 });
+			options.shapes.push_back({ "medium", 3, 6, 4, 2, 16 });
+			options.shapes.push_back({ "large", 4, 7, 4, 2, 32 });
+		}
+		return true;
+	}
+}
+
+int main(int argumentCount, char *argumentValues[])
+{
+	BenchmarkOptions options;
+
+	if (!parse_arguments(argumentCount, argumentValues, options))
+	{
+		print_usage(argumentValues[0]);
+		return 2;
+	}
+
+	// Keep the stack's log output out of the results
+	LogContext benchmarkLog;
+	ScopedLogContext logScope(benchmarkLog);
+	isobus::CANStackLogger::set_can_stack_logger_sink(&logger);
+
+	std::ofstream outputFile;
+	if (!options.outputPath.empty())
+	{
+		outputFile.open(options.outputPath, std::ios_base::trunc);
+
+		if (!outputFile)
+		{
+			std::fprintf(stderr, "Could not open \"%s\"\n", options.outputPath.c_str());
+			return 1;
+		}
+	}
+	std::ostream &output = options.outputPath.empty() ? std::cout : outputFile;
+
+	JsonWriter json(output);
+	json.begin_object();
+	json.write("benchmark", "ddop_bench");
+	json.write("label", options.runLabel);
+	json.write("taskControllerVersion", options.taskControllerVersion);
+	json.write("iterations", options.iterations);
+	json.begin_array("shapes");
+
+	for (const auto &shape : options.shapes)
+	{
+		run_shape(shape, options, json);
+	}
+
+	json.end_array();
+	json.end_object();
+	output << '\n';
+	return 0;
+}
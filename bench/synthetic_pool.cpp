@@ -0,0 +1,118 @@
+//================================================================================================
+/// @file synthetic_pool.cpp
+///
+/// @brief Implements a generator of synthetic DDOPs of configurable size and shape for benchmarking
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso and the Open-Agriculture developers
+//================================================================================================
+#include "synthetic_pool.hpp"
+
+#include <array>
+#include <memory>
+#include <vector>
+
+std::uint64_t SyntheticPoolShape::get_number_of_objects() const
+{
+	std::uint64_t numberOfElements = 0;
+	std::uint64_t elementsAtLevel = 1;
+
+	// One root element under the device, then fanOut children for each element on every level below it
+	for (std::uint32_t level = 0; level <= depth; level++)
+	{
+		numberOfElements += elementsAtLevel;
+		elementsAtLevel *= fanOut;
+	}
+	return 1 + presentations + (numberOfElements * (1 + processDataPerElement + propertiesPerElement));
+}
+
+namespace
+{
+	class PoolGenerator
+	{
+	public:
+		PoolGenerator(const SyntheticPoolShape &shape, isobus::DeviceDescriptorObjectPool &pool) :
+		  shape(shape),
+		  pool(pool)
+		{
+		}
+
+		bool generate()
+		{
+			bool retVal = pool.add_device("Synthetic Device", "1.0.0", "123", "BENCH01", std::array<std::uint8_t, 7>(), std::vector<std::uint8_t>(), 0);
+
+			for (std::uint32_t i = 0; retVal && (i < shape.presentations); i++)
+			{
+				retVal = pool.add_device_value_presentation("Presentation " + std::to_string(i), static_cast<std::int32_t>(i), 0.001f * static_cast<float>(i + 1), static_cast<std::uint8_t>(i % 4), nextObjectID++);
+			}
+
+			if (retVal)
+			{
+				retVal = add_element(0, 0);
+			}
+			return retVal;
+		}
+
+	private:
+		bool add_element(std::uint16_t parentID, std::uint32_t level)
+		{
+			std::uint16_t elementID = nextObjectID++;
+			auto type = (0 == level) ? isobus::task_controller_object::DeviceElementObject::Type::Device : isobus::task_controller_object::DeviceElementObject::Type::Section;
+			bool retVal = pool.add_device_element("Element " + std::to_string(elementID), static_cast<std::uint16_t>(nextElementNumber++ & 0x0FFF), parentID, type, elementID);
+			auto element = std::static_pointer_cast<isobus::task_controller_object::DeviceElementObject>(pool.get_object_by_index(pool.size() - 1));
+
+			for (std::uint32_t i = 0; retVal && (i < shape.processDataPerElement); i++)
+			{
+				std::uint16_t objectID = nextObjectID++;
+				retVal = pool.add_device_process_data("", static_cast<std::uint16_t>(1 + (objectID % 600)), get_next_presentation_id(), 0x01, 0x08, objectID);
+				element->add_reference_to_child_object(objectID);
+			}
+
+			for (std::uint32_t i = 0; retVal && (i < shape.propertiesPerElement); i++)
+			{
+				std::uint16_t objectID = nextObjectID++;
+				retVal = pool.add_device_property("", static_cast<std::int32_t>(objectID), static_cast<std::uint16_t>(1 + (objectID % 600)), get_next_presentation_id(), objectID);
+				element->add_reference_to_child_object(objectID);
+			}
+
+			for (std::uint32_t i = 0; retVal && (level < shape.depth) && (i < shape.fanOut); i++)
+			{
+				retVal = add_element(elementID, level + 1);
+			}
+			return retVal;
+		}
+
+		std::uint16_t get_next_presentation_id()
+		{
+			std::uint16_t retVal = 0xFFFF;
+
+			if (0 != shape.presentations)
+			{
+				// The device is object 0, and the presentations directly follow it
+				retVal = static_cast<std::uint16_t>(1 + (nextPresentation++ % shape.presentations));
+			}
+			return retVal;
+		}
+
+		const SyntheticPoolShape &shape;
+		isobus::DeviceDescriptorObjectPool &pool;
+		std::uint32_t nextElementNumber = 0;
+		std::uint32_t nextPresentation = 0;
+		std::uint16_t nextObjectID = 1; ///< The device always has object ID 0
+	};
+}
+
+bool generate_synthetic_pool(const SyntheticPoolShape &shape, isobus::DeviceDescriptorObjectPool &pool)
+{
+	pool.clear();
+
+	bool retVal = false;
+
+	// 0xFFFF is the NULL object ID, so that is one more object than can be addressed
+	if (shape.get_number_of_objects() < 0xFFFF)
+	{
+		PoolGenerator generator(shape, pool);
+		retVal = generator.generate();
+	}
+	return retVal;
+}
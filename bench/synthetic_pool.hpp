@@ -0,0 +1,37 @@
+//================================================================================================
+/// @file synthetic_pool.hpp
+///
+/// @brief Defines a generator of synthetic DDOPs of configurable size and shape for benchmarking
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso and the Open-Agriculture developers
+//================================================================================================
+#ifndef SYNTHETIC_POOL_HPP
+#define SYNTHETIC_POOL_HPP
+
+#include "isobus/isobus/isobus_device_descriptor_object_pool.hpp"
+
+#include <cstdint>
+#include <string>
+
+/// @brief Describes the shape of a generated DDOP
+struct SyntheticPoolShape
+{
+	std::string name; ///< A name to identify the shape in reports
+	std::uint32_t depth = 3; ///< Number of device element levels below the device
+	std::uint32_t fanOut = 4; ///< Number of child elements of each element
+	std::uint32_t processDataPerElement = 4; ///< Number of DPD objects referenced by each element
+	std::uint32_t propertiesPerElement = 2; ///< Number of DPT objects referenced by each element
+	std::uint32_t presentations = 8; ///< Number of DVP objects, shared round robin by all DPDs and DPTs
+
+	/// @brief Returns the number of objects a pool of this shape will contain
+	std::uint64_t get_number_of_objects() const;
+};
+
+/// @brief Fills a pool with a device, a tree of device elements, and their process data, properties and presentations.
+/// @param[in] shape The shape of the pool to generate
+/// @param[out] pool The pool to fill. It is cleared first.
+/// @returns true if the pool was generated, false if the shape needs more object IDs than a DDOP can hold
+bool generate_synthetic_pool(const SyntheticPoolShape &shape, isobus::DeviceDescriptorObjectPool &pool);
+
+#endif // SYNTHETIC_POOL_HPP
@@ -0,0 +1,46 @@
+# Writes the AgIsoStack++ revision to a header for the validation cache.
+# Runs on every build, but only rewrites the header when the revision changed, so moving the
+# submodule recompiles the cache without re-running CMake, and an unchanged one recompiles nothing.
+#
+# Expects AGISOSTACK_SOURCE_DIR, OUTPUT_FILE and optionally GIT_EXECUTABLE.
+# The version is left empty when it can't be known, which turns the cache off.
+
+set(AGISOSTACK_VERSION "")
+
+# Only ask git when the submodule is its own checkout, or git would report the enclosing repository
+if(GIT_EXECUTABLE AND EXISTS "${AGISOSTACK_SOURCE_DIR}/.git")
+    execute_process(COMMAND ${GIT_EXECUTABLE} rev-parse HEAD
+                    WORKING_DIRECTORY ${AGISOSTACK_SOURCE_DIR}
+                    OUTPUT_VARIABLE AGISOSTACK_GIT_REVISION
+                    OUTPUT_STRIP_TRAILING_WHITESPACE
+                    ERROR_QUIET
+                    RESULT_VARIABLE AGISOSTACK_GIT_RESULT)
+
+    if(AGISOSTACK_GIT_RESULT EQUAL 0)
+        set(AGISOSTACK_VERSION ${AGISOSTACK_GIT_REVISION})
+
+        # Local edits to the library change its behaviour too, so they become part of the version
+        execute_process(COMMAND ${GIT_EXECUTABLE} diff HEAD
+                        WORKING_DIRECTORY ${AGISOSTACK_SOURCE_DIR}
+                        OUTPUT_VARIABLE AGISOSTACK_GIT_DIFF
+                        ERROR_QUIET
+                        RESULT_VARIABLE AGISOSTACK_GIT_RESULT)
+
+        if(NOT AGISOSTACK_GIT_RESULT EQUAL 0)
+            set(AGISOSTACK_VERSION "")
+        elseif(NOT AGISOSTACK_GIT_DIFF STREQUAL "")
+            string(SHA1 AGISOSTACK_DIFF_HASH "${AGISOSTACK_GIT_DIFF}")
+            set(AGISOSTACK_VERSION "${AGISOSTACK_VERSION}-dirty-${AGISOSTACK_DIFF_HASH}")
+        endif()
+    endif()
+endif()
+
+set(VERSION_HEADER "// Generated by cmake/AgIsoStackVersion.cmake, do not edit\n#define DDOP_AGISOSTACK_VERSION \"${AGISOSTACK_VERSION}\"\n")
+
+if(EXISTS ${OUTPUT_FILE})
+    file(READ ${OUTPUT_FILE} CURRENT_VERSION_HEADER)
+endif()
+
+if(NOT VERSION_HEADER STREQUAL CURRENT_VERSION_HEADER)
+    file(WRITE ${OUTPUT_FILE} "${VERSION_HEADER}")
+endif()
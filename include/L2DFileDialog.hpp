@@ -19,6 +19,9 @@
 * 
 *  Removed delete option.
 *  Added "Save" dialogue type.
+*  Directory listings are cached per directory and scanned on a background thread,
+*  with their sort orders precomputed, so large or slow directories don't stall the GUI.
+*  Each new listing pushes an SDL event, which wakes an idle GUI to draw it.
 * 
 * Todo: Refactor this code to use proper strings and a class instead of being
 * a gross static thing with hardcoded lengths all over the place.
@@ -29,14 +32,24 @@
 
 #pragma once
 
+#include <SDL.h>
 #include <imgui.h>
 #include <imgui_internal.h>
 #include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cstdint>
 #include <ctime>
 #include <filesystem>
+#include <iomanip>
+#include <memory>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
 using namespace std::chrono_literals;
 
@@ -69,6 +82,246 @@ namespace FileDialog
 		return ret;
 	}
 
+	static std::string formatFileTime(std::filesystem::file_time_type ftime)
+	{
+		auto st = std::chrono::time_point_cast<std::chrono::system_clock::duration>(ftime - decltype(ftime)::clock::now() + std::chrono::system_clock::now());
+		std::time_t tt = std::chrono::system_clock::to_time_t(st);
+
+		std::tm mt;
+#ifndef _MSC_VER
+		localtime_r(&tt, &mt);
+#else
+		localtime_s(&mt, &tt);
+#endif
+		std::stringstream ss;
+		ss << std::put_time(&mt, "%F %R");
+		return ss.str();
+	}
+
+	// Everything the dialog draws for one file or folder, so drawing a row never touches the file system
+	struct DirectoryEntryInfo
+	{
+		std::filesystem::path path;
+		std::string name;
+		std::string extension;
+		std::uintmax_t size = 0;
+		std::filesystem::file_time_type last_write_time;
+		std::string size_text;
+		std::string date_text;
+	};
+
+	// One scanned directory. The sorted views are indices into files, in ascending order.
+	// Sizes and dates are filled in by a second pass, so hasMetadata is false until then.
+	struct DirectoryListing
+	{
+		std::vector<DirectoryEntryInfo> folders;
+		std::vector<DirectoryEntryInfo> files;
+		std::vector<std::size_t> files_by_name;
+		std::vector<std::size_t> files_by_type;
+		std::vector<std::size_t> files_by_size;
+		std::vector<std::size_t> files_by_date;
+		bool has_metadata = false;
+	};
+
+	// Lists directories on detached worker threads and keeps the latest listing of each one.
+	// The GUI always draws the cached listing, and picks up newer ones as the workers publish them.
+	// Publishing pushes an SDL_USEREVENT, so a GUI waiting for input redraws with the new listing.
+	class DirectoryListingCache
+	{
+	public:
+		// Returns the newest listing of a directory, or nullptr if it hasn't been listed yet
+		std::shared_ptr<const DirectoryListing> get(const std::string &path)
+		{
+			std::shared_ptr<const DirectoryListing> retVal;
+			auto entry = entries.find(path);
+
+			if (entries.end() != entry)
+			{
+				auto &scan = entry->second.scan;
+
+				if (nullptr != scan)
+				{
+					bool isFinished = false;
+					{
+						std::lock_guard<std::mutex> lock(scan->mutex);
+						if (nullptr != scan->published)
+						{
+							entry->second.listing = scan->published;
+						}
+						isFinished = scan->finished;
+					}
+					if (isFinished)
+					{
+						scan.reset();
+					}
+				}
+				retVal = entry->second.listing;
+			}
+			return retVal;
+		}
+
+		// Starts listing a directory in the background, unless it's already being listed.
+		// Any cached listing is still returned by get() until the new one arrives.
+		void refresh(const std::string &path)
+		{
+			if ((entries.end() == entries.find(path)) && (entries.size() >= MAX_CACHED_DIRECTORIES))
+			{
+				for (auto &entry : entries)
+				{
+					if (nullptr != entry.second.scan)
+					{
+						entry.second.scan->cancelled = true;
+					}
+				}
+				entries.clear();
+			}
+
+			auto &entry = entries[path];
+
+			if (nullptr == entry.scan)
+			{
+				entry.scan = std::make_shared<DirectoryScan>();
+				entry.scan->path = path;
+				std::thread(scanDirectory, entry.scan).detach();
+			}
+		}
+
+	private:
+		static constexpr std::size_t MAX_CACHED_DIRECTORIES = 32;
+
+		// Shared between the GUI and one worker thread. Only published and finished need the mutex.
+		struct DirectoryScan
+		{
+			std::string path;
+			std::atomic<bool> cancelled{ false };
+			std::mutex mutex;
+			std::shared_ptr<const DirectoryListing> published;
+			bool finished = false;
+		};
+
+		struct CacheEntry
+		{
+			std::shared_ptr<const DirectoryListing> listing;
+			std::shared_ptr<DirectoryScan> scan;
+		};
+
+		static void publish(DirectoryScan &scan, std::shared_ptr<const DirectoryListing> listing, bool finished)
+		{
+			{
+				std::lock_guard<std::mutex> lock(scan.mutex);
+				scan.published = std::move(listing);
+				scan.finished = finished;
+			}
+
+			// SDL_PushEvent is safe to call from any thread
+			SDL_Event wakeEvent = {};
+			wakeEvent.type = SDL_USEREVENT;
+			SDL_PushEvent(&wakeEvent);
+		}
+
+		template<typename Compare>
+		static std::vector<std::size_t> sortedView(const std::vector<DirectoryEntryInfo> &files, Compare compare)
+		{
+			std::vector<std::size_t> retVal(files.size());
+
+			for (std::size_t i = 0; i < retVal.size(); i++)
+			{
+				retVal[i] = i;
+			}
+			std::stable_sort(retVal.begin(), retVal.end(), [&files, &compare](std::size_t a, std::size_t b) {
+				return compare(files[a], files[b]);
+			});
+			return retVal;
+		}
+
+		static void scanDirectory(std::shared_ptr<DirectoryScan> scan)
+		{
+			// First pass: names only, which is all the directory read itself returns
+			auto listing = std::make_shared<DirectoryListing>();
+			std::error_code error;
+			std::filesystem::directory_iterator end;
+
+			for (std::filesystem::directory_iterator it(scan->path, std::filesystem::directory_options::skip_permission_denied, error); (!error) && (it != end); it.increment(error))
+			{
+				if (scan->cancelled)
+				{
+					return;
+				}
+
+				DirectoryEntryInfo info;
+				std::error_code typeError;
+				info.path = it->path();
+
+				if (it->is_directory(typeError))
+				{
+					info.name = info.path.stem().string();
+					listing->folders.push_back(std::move(info));
+				}
+				else
+				{
+					info.name = info.path.filename().string();
+					info.extension = info.path.extension().string();
+					listing->files.push_back(std::move(info));
+				}
+			}
+
+			listing->files_by_name = sortedView(listing->files, [](const DirectoryEntryInfo &a, const DirectoryEntryInfo &b) {
+				return a.name < b.name;
+			});
+			listing->files_by_type = sortedView(listing->files, [](const DirectoryEntryInfo &a, const DirectoryEntryInfo &b) {
+				return a.extension < b.extension;
+			});
+			publish(*scan, listing, listing->files.empty());
+
+			if (listing->files.empty())
+			{
+				return;
+			}
+
+			// Second pass: sizes and dates, which cost one stat per file and are slow on network shares
+			auto detailedListing = std::make_shared<DirectoryListing>(*listing);
+
+			for (auto &file : detailedListing->files)
+			{
+				if (scan->cancelled)
+				{
+					return;
+				}
+
+				std::error_code sizeError;
+				std::error_code timeError;
+				file.size = std::filesystem::file_size(file.path, sizeError);
+				file.last_write_time = std::filesystem::last_write_time(file.path, timeError);
+
+				if (!sizeError)
+				{
+					file.size_text = std::to_string(file.size);
+				}
+				else
+				{
+					file.size = 0;
+				}
+				if (!timeError)
+				{
+					file.date_text = formatFileTime(file.last_write_time);
+				}
+			}
+
+			detailedListing->files_by_size = sortedView(detailedListing->files, [](const DirectoryEntryInfo &a, const DirectoryEntryInfo &b) {
+				return a.size < b.size;
+			});
+			detailedListing->files_by_date = sortedView(detailedListing->files, [](const DirectoryEntryInfo &a, const DirectoryEntryInfo &b) {
+				return a.last_write_time < b.last_write_time;
+			});
+			detailedListing->has_metadata = true;
+			publish(*scan, detailedListing, true);
+		}
+
+		std::unordered_map<std::string, CacheEntry> entries;
+	};
+
+	static DirectoryListingCache directory_listing_cache;
+
 	void ShowFileDialog(bool *open, char *buffer, [[maybe_unused]] unsigned int buffer_size, FileDialogType type = FileDialogType::OpenFile)
 	{
 		static int file_dialog_file_select_index = 0;
@@ -83,6 +336,7 @@ namespace FileDialog
 		static FileDialogSortOrder type_sort_order = FileDialogSortOrder::None;
 
 		static bool initial_path_set = false;
+		static std::string file_dialog_listed_path = "";
 
 		if (open)
 		{
@@ -117,26 +371,18 @@ namespace FileDialog
 			const char *window_title = (type == FileDialogType::OpenFile ? "Select a file" : "Select a folder");
 			ImGui::Begin(window_title, nullptr, ImGuiWindowFlags_NoResize);
 
-			std::vector<std::filesystem::directory_entry> files;
-			std::vector<std::filesystem::directory_entry> folders;
-			try
-			{
-				for (auto &p : std::filesystem::directory_iterator(file_dialog_current_path))
-				{
-					if (p.is_directory())
-					{
-						folders.push_back(p);
-					}
-					else
-					{
-						files.push_back(p);
-					}
-				}
-			}
-			catch (...)
+			// Re-list a directory whenever it's entered, while still showing what was cached for it last time
+			if (file_dialog_listed_path != file_dialog_current_path)
 			{
+				directory_listing_cache.refresh(file_dialog_current_path);
+				file_dialog_listed_path = file_dialog_current_path;
 			}
 
+			static const DirectoryListing empty_listing;
+			std::shared_ptr<const DirectoryListing> listing = directory_listing_cache.get(file_dialog_current_path);
+			const auto &folders = (nullptr != listing) ? listing->folders : empty_listing.folders;
+			const auto &files = (nullptr != listing) ? listing->files : empty_listing.files;
+
 			ImGui::Text("%s", file_dialog_current_path.c_str());
 
 			ImGui::BeginChild("Directories##1", ImVec2(200, 300), true, ImGuiWindowFlags_HorizontalScrollbar);
@@ -148,23 +394,28 @@ namespace FileDialog
 					file_dialog_current_path = std::filesystem::path(file_dialog_current_path).parent_path().string();
 				}
 			}
-			for (int i = 0; i < folders.size(); ++i)
+			ImGuiListClipper folder_clipper;
+			folder_clipper.Begin(static_cast<int>(folders.size()));
+			while (folder_clipper.Step())
 			{
-				if (ImGui::Selectable(folders[i].path().stem().string().c_str(), i == file_dialog_folder_select_index, ImGuiSelectableFlags_AllowDoubleClick, ImVec2(ImGui::GetWindowContentRegionWidth(), 0)))
+				for (int i = folder_clipper.DisplayStart; i < folder_clipper.DisplayEnd; ++i)
 				{
-					file_dialog_current_file = "";
-					if (ImGui::IsMouseDoubleClicked(0))
+					if (ImGui::Selectable(folders[i].name.c_str(), i == file_dialog_folder_select_index, ImGuiSelectableFlags_AllowDoubleClick, ImVec2(ImGui::GetWindowContentRegionWidth(), 0)))
 					{
-						file_dialog_current_path = folders[i].path().string();
-						file_dialog_folder_select_index = 0;
-						file_dialog_file_select_index = 0;
-						ImGui::SetScrollHereY(0.0f);
-						file_dialog_current_folder = "";
-					}
-					else
-					{
-						file_dialog_folder_select_index = i;
-						file_dialog_current_folder = folders[i].path().stem().string();
+						file_dialog_current_file = "";
+						if (ImGui::IsMouseDoubleClicked(0))
+						{
+							file_dialog_current_path = folders[i].path.string();
+							file_dialog_folder_select_index = 0;
+							file_dialog_file_select_index = 0;
+							ImGui::SetScrollHereY(0.0f);
+							file_dialog_current_folder = "";
+						}
+						else
+						{
+							file_dialog_folder_select_index = i;
+							file_dialog_current_folder = folders[i].name;
+						}
 					}
 				}
 			}
@@ -226,88 +477,59 @@ namespace FileDialog
 			ImGui::NextColumn();
 			ImGui::Separator();
 
-			// Sort files
-			if (file_name_sort_order != FileDialogSortOrder::None)
+			// Pick one of the precomputed sort orders. Size and date orders only exist once the metadata has been read.
+			const std::vector<std::size_t> *file_order = nullptr;
+			bool is_descending = false;
+			if ((nullptr != listing) && (file_name_sort_order != FileDialogSortOrder::None))
 			{
-				std::sort(files.begin(), files.end(), [](const std::filesystem::directory_entry &a, const std::filesystem::directory_entry &b) {
-					if (file_name_sort_order == FileDialogSortOrder::Down)
-					{
-						return a.path().filename().string() > b.path().filename().string();
-					}
-					else
-					{
-						return a.path().filename().string() < b.path().filename().string();
-					}
-				});
+				file_order = &listing->files_by_name;
+				is_descending = (file_name_sort_order == FileDialogSortOrder::Down);
 			}
-			else if (size_sort_order != FileDialogSortOrder::None)
+			else if ((nullptr != listing) && listing->has_metadata && (size_sort_order != FileDialogSortOrder::None))
 			{
-				std::sort(files.begin(), files.end(), [](const std::filesystem::directory_entry &a, const std::filesystem::directory_entry &b) {
-					if (size_sort_order == FileDialogSortOrder::Down)
-					{
-						return a.file_size() > b.file_size();
-					}
-					else
-					{
-						return a.file_size() < b.file_size();
-					}
-				});
+				file_order = &listing->files_by_size;
+				is_descending = (size_sort_order == FileDialogSortOrder::Down);
 			}
-			else if (type_sort_order != FileDialogSortOrder::None)
+			else if ((nullptr != listing) && (type_sort_order != FileDialogSortOrder::None))
 			{
-				std::sort(files.begin(), files.end(), [](const std::filesystem::directory_entry &a, const std::filesystem::directory_entry &b) {
-					if (type_sort_order == FileDialogSortOrder::Down)
-					{
-						return a.path().extension().string() > b.path().extension().string();
-					}
-					else
-					{
-						return a.path().extension().string() < b.path().extension().string();
-					}
-				});
+				file_order = &listing->files_by_type;
+				is_descending = (type_sort_order == FileDialogSortOrder::Down);
 			}
-			else if (date_sort_order != FileDialogSortOrder::None)
+			else if ((nullptr != listing) && listing->has_metadata && (date_sort_order != FileDialogSortOrder::None))
 			{
-				std::sort(files.begin(), files.end(), [](const std::filesystem::directory_entry &a, const std::filesystem::directory_entry &b) {
-					if (date_sort_order == FileDialogSortOrder::Down)
-					{
-						return a.last_write_time() > b.last_write_time();
-					}
-					else
-					{
-						return a.last_write_time() < b.last_write_time();
-					}
-				});
+				file_order = &listing->files_by_date;
+				is_descending = (date_sort_order == FileDialogSortOrder::Down);
+			}
+
+			if (nullptr == listing)
+			{
+				ImGui::TextDisabled("Loading...");
 			}
 
-			for (int i = 0; i < files.size(); ++i)
+			const int number_of_files = static_cast<int>(files.size());
+			ImGuiListClipper file_clipper;
+			file_clipper.Begin(number_of_files);
+			while (file_clipper.Step())
 			{
-				if (ImGui::Selectable(files[i].path().filename().string().c_str(), i == file_dialog_file_select_index, ImGuiSelectableFlags_AllowDoubleClick, ImVec2(ImGui::GetWindowContentRegionWidth(), 0)))
+				for (int row = file_clipper.DisplayStart; row < file_clipper.DisplayEnd; ++row)
 				{
-					file_dialog_file_select_index = i;
-					file_dialog_current_file = files[i].path().filename().string();
-					file_dialog_current_folder = "";
-				}
-				ImGui::NextColumn();
-				ImGui::TextUnformatted(std::to_string(files[i].file_size()).c_str());
-				ImGui::NextColumn();
-				ImGui::TextUnformatted(files[i].path().extension().string().c_str());
-				ImGui::NextColumn();
-				auto ftime = files[i].last_write_time();
-				auto st = std::chrono::time_point_cast<std::chrono::system_clock::duration>(ftime - decltype(ftime)::clock::now() + std::chrono::system_clock::now());
-				std::time_t tt = std::chrono::system_clock::to_time_t(st);
-
-				std::tm mt;
-#ifndef _MSC_VER
-				localtime_r(&tt, &mt);
-#else
-				localtime_s(&mt, &tt);
-#endif
-				std::stringstream ss;
-				ss << std::put_time(&mt, "%F %R");
+					const int position = is_descending ? (number_of_files - 1 - row) : row;
+					const auto &file = files[(nullptr != file_order) ? (*file_order)[position] : position];
 
-				ImGui::TextUnformatted(ss.str().c_str());
-				ImGui::NextColumn();
+					if (ImGui::Selectable(file.name.c_str(), row == file_dialog_file_select_index, ImGuiSelectableFlags_AllowDoubleClick, ImVec2(ImGui::GetWindowContentRegionWidth(), 0)))
+					{
+						file_dialog_file_select_index = row;
+						file_dialog_current_file = file.name;
+						file_dialog_current_folder = "";
+					}
+					ImGui::NextColumn();
+					ImGui::TextUnformatted(listing->has_metadata ? file.size_text.c_str() : "...");
+					ImGui::NextColumn();
+					ImGui::TextUnformatted(file.extension.c_str());
+					ImGui::NextColumn();
+					ImGui::TextUnformatted(listing->has_metadata ? file.date_text.c_str() : "...");
+					ImGui::NextColumn();
+				}
 			}
 			ImGui::EndChild();
 
@@ -347,6 +569,7 @@ namespace FileDialog
 					{
 						std::string new_file_path = getPathWithTrailingSeparator(file_dialog_current_path) + new_folder_name;
 						std::filesystem::create_directory(new_file_path);
+						file_dialog_listed_path = "";
 						ImGui::CloseCurrentPopup();
 					}
 				}
@@ -371,6 +594,7 @@ namespace FileDialog
 				if (ImGui::Button("Yes"))
 				{
 					std::filesystem::remove(getPathWithTrailingSeparator(file_dialog_current_path) + file_dialog_current_folder);
+					file_dialog_listed_path = "";
 					ImGui::CloseCurrentPopup();
 				}
 				ImGui::SameLine();
@@ -389,6 +613,7 @@ namespace FileDialog
 				file_dialog_current_file = "";
 				strncpy(file_dialog_error, "", sizeof(file_dialog_error));
 				initial_path_set = false;
+				file_dialog_listed_path = "";
 				file_dialog_open = false;
 			};
 
@@ -0,0 +1,131 @@
+//================================================================================================
+/// @file background_validator.hpp
+///
+/// @brief Defines a validator that checks a copy of the DDOP on a worker thread while it is edited
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso and the Open-Agriculture developers
+//================================================================================================
+#ifndef BACKGROUND_VALIDATOR_HPP
+#define BACKGROUND_VALIDATOR_HPP
+
+#include "isobus/isobus/isobus_device_descriptor_object_pool.hpp"
+#include "logsink.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/// @brief Validates the DDOP on a worker thread, so that problems show up while the user edits.
+/// @details Edits are debounced: once no edit has been reported for the debounce delay, update()
+/// snapshots the pool on the UI thread as the binary form of each object, which takes one pass
+/// over the objects. The worker deserializes the snapshot into its own pool and serializes it
+/// again, so every check is the library's own. Messages it logs are attached to the first object
+/// ID they mention. Reporting another edit cancels the check that is in progress, and any result
+/// that is out of date by the time it finishes is thrown away.
+/// All public functions must be called from the UI thread.
+class BackgroundValidator
+{
+public:
+	/// @brief One problem found in the DDOP
+	struct Issue
+	{
+		std::uint16_t objectID; ///< The object with the problem, or NULL_OBJECT_ID if it applies to the whole pool
+		isobus::CANStackLogger::LoggingLevel level; ///< How severe the problem is
+		std::string message; ///< A description of the problem
+	};
+
+	/// @brief Starts the worker thread
+	/// @param[in] debounceDelay How long to wait after the last edit before validating
+	explicit BackgroundValidator(std::chrono::milliseconds debounceDelay = std::chrono::milliseconds(300));
+
+	/// @brief Cancels any validation in progress and stops the worker thread
+	~BackgroundValidator();
+
+	BackgroundValidator(const BackgroundValidator &) = delete;
+	BackgroundValidator &operator=(const BackgroundValidator &) = delete;
+
+	/// @brief Records that the pool was edited, cancelling the validation in progress
+	void on_pool_edited();
+
+	/// @brief Cancels any validation and forgets the last result, for example when the pool is closed
+	void clear();
+
+	/// @brief Starts a validation once the debounce delay has passed, and picks up finished results.
+	/// Call once per frame while a pool is open.
+	/// @param[in] pool The pool being edited
+	/// @returns true if a new result was picked up
+	bool update(isobus::DeviceDescriptorObjectPool &pool);
+
+	/// @brief Returns true while there are edits that have not been validated yet
+	bool is_busy() const;
+
+	/// @brief Returns true if a result is available, even if it is out of date
+	bool has_result() const;
+
+	/// @brief Returns true if the last validated snapshot of the pool could be serialized
+	bool is_pool_valid() const;
+
+	/// @brief Returns every problem found by the last validation
+	const std::vector<Issue> &get_issues() const;
+
+	/// @brief Returns the problems found by the last validation for one object
+	/// @param[in] objectID The object to look up
+	/// @returns The problems with that object (may be empty)
+	const std::vector<Issue> &get_object_issues(std::uint16_t objectID) const;
+
+private:
+	using Clock = std::chrono::steady_clock;
+
+	/// @brief The outcome of validating one snapshot of the pool
+	struct Result
+	{
+		std::vector<Issue> issues;
+		bool serialized = false;
+	};
+
+	/// @brief A snapshot of the pool waiting to be validated
+	struct Job
+	{
+		std::vector<std::uint8_t> binaryPool; ///< The binary form of every object, in pool order
+		std::uint64_t generation;
+		std::uint8_t taskControllerVersion;
+	};
+
+	static std::uint16_t find_object_id(const std::string &message, const std::vector<bool> &objectIDs);
+
+	void worker_thread();
+	bool is_cancelled(std::uint64_t jobGeneration) const;
+	bool validate(const Job &job, isobus::DeviceDescriptorObjectPool &pool);
+
+	static const std::vector<Issue> EMPTY_ISSUE_LIST; ///< Returned when an object has no issues
+
+	// Only used by the UI thread
+	std::vector<Issue> issues;
+	std::unordered_map<std::uint16_t, std::vector<Issue>> issuesByObjectID;
+	Clock::time_point lastEditTime;
+	Clock::duration debounceDelay;
+	std::uint64_t submittedGeneration = 0;
+	bool editPending = false;
+	bool resultAvailable = false;
+	bool lastResultSerialized = false;
+
+	// Shared with the worker thread
+	std::thread worker;
+	mutable std::mutex jobMutex;
+	std::condition_variable jobCondition;
+	std::unique_ptr<Job> queuedJob;
+	std::unique_ptr<Result> finishedResult;
+	std::uint64_t finishedGeneration = 0;
+	std::atomic<std::uint64_t> currentGeneration = { 0 };
+	bool stopWorker = false;
+};
+
+#endif // BACKGROUND_VALIDATOR_HPP
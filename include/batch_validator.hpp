@@ -0,0 +1,64 @@
+//================================================================================================
+/// @file batch_validator.hpp
+///
+/// @brief Defines a validator that checks many DDOP files in parallel
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso and the Open-Agriculture developers
+//================================================================================================
+#ifndef BATCH_VALIDATOR_HPP
+#define BATCH_VALIDATOR_HPP
+
+#include "logsink.hpp"
+#include "validation_cache.hpp"
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/// @brief Reads, deserializes and re-serializes a list of .iop files across a work stealing
+/// thread pool. Each worker owns its own object pool, and each file gets its own log context,
+/// so the diagnostics of one file never end up in the report of another.
+class BatchValidator
+{
+public:
+	/// @brief The outcome of validating one file
+	struct Result
+	{
+		std::string filePath;
+		std::vector<LogContext::LogInfo> diagnostics;
+		std::size_t fileSize = 0;
+		std::size_t numberOfObjects = 0;
+		double durationMilliseconds = 0.0;
+		bool fileRead = false;
+		bool deserialized = false;
+		bool serialized = false;
+		bool cached = false; ///< The outcome came from the validation cache
+
+		bool passed() const;
+	};
+
+	/// @brief Constructor for the validator
+	/// @param[in] taskControllerVersion The TC version used to parse the DDOPs
+	/// @param[in] numberOfThreads The number of workers, or 0 to use one per hardware thread
+	/// @param[in] cache A cache of earlier results to skip unchanged pools with, or nullptr
+	BatchValidator(std::uint8_t taskControllerVersion, std::size_t numberOfThreads, ValidationCache *cache = nullptr);
+
+	/// @brief Validates every file, and returns the results in the same order as the files
+	/// @param[in] filePaths The files to validate
+	/// @returns One result per file
+	std::vector<Result> validate(const std::vector<std::string> &filePaths) const;
+
+	/// @brief Writes an aggregated JSON report of a validation run
+	/// @param[in] results The results returned by validate()
+	/// @param[in] output The stream to write the report to
+	void write_json_report(const std::vector<Result> &results, std::ostream &output) const;
+
+private:
+	ValidationCache *cache;
+	std::size_t numberOfThreads;
+	std::uint8_t taskControllerVersion;
+};
+
+#endif // BATCH_VALIDATOR_HPP
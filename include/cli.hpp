@@ -0,0 +1,74 @@
+//================================================================================================
+/// @file cli.hpp
+///
+/// @brief Defines a headless command line front end for validating and converting DDOPs
+/// without creating any windows or graphics contexts.
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso and the Open-Agriculture developers
+//================================================================================================
+#ifndef CLI_HPP
+#define CLI_HPP
+
+#include "isobus/isobus/isobus_device_descriptor_object_pool.hpp"
+#include "logsink.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class DDOPCommandLine
+{
+public:
+	DDOPCommandLine() = default;
+
+	/// @brief Parses the arguments and runs the requested command
+	/// @param[in] argumentCount The number of arguments, as passed to main
+	/// @param[in] argumentValues The arguments, as passed to main
+	/// @returns The process exit code
+	int run(int argumentCount, char *argumentValues[]);
+
+private:
+	enum class Command
+	{
+		Validate,
+		Convert,
+		Export,
+		Aggregate,
+		Diff,
+		Merge
+	};
+
+	static constexpr int EXIT_CODE_SUCCESS = 0;
+	static constexpr int EXIT_CODE_FAILURE = 1;
+	static constexpr int EXIT_CODE_USAGE = 2;
+	static constexpr std::size_t MAX_NUMBER_OF_JOBS = 1024; ///< More threads than this only add overhead
+
+	bool parse_arguments(int argumentCount, char *argumentValues[]);
+	void collect_input_files(const std::string &path);
+	int run_validation();
+	int run_aggregation();
+	int run_diff();
+	int run_merge();
+	bool load_object_pool(const std::string &path, isobus::DeviceDescriptorObjectPool &pool) const;
+	bool process_file(const std::string &path, const std::string &outputPath);
+	bool write_file(const std::string &path, const char *data, std::size_t size) const;
+	bool write_iso_xml_file(const std::string &path, isobus::DeviceDescriptorObjectPool &pool) const;
+	std::size_t get_number_of_jobs(std::size_t numberOfTasks) const;
+	std::string get_output_path(const std::string &outputName, const std::string &extension) const;
+	static std::vector<std::string> find_iop_files(const std::string &directory);
+	static void print_usage(const char *programName);
+	static void print_log_history(const LogContext &log);
+
+	std::vector<std::string> inputFiles;
+	std::vector<std::string> outputNames; ///< Each input file's path relative to the directory it was found in
+	std::string outputDirectory;
+	std::string reportPath;
+	std::string cacheDirectory;
+	std::size_t numberOfJobs = 0;
+	Command command = Command::Validate;
+	std::uint8_t taskControllerVersion = 4;
+	bool quiet = false;
+};
+
+#endif // CLI_HPP
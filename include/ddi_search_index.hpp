@@ -0,0 +1,94 @@
+//================================================================================================
+/// @file ddi_search_index.hpp
+///
+/// @brief Defines a search index over the ISO 11783-11 data dictionary, used by the DDI picker
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso and the Open-Agriculture developers
+//================================================================================================
+#ifndef DDI_SEARCH_INDEX_HPP
+#define DDI_SEARCH_INDEX_HPP
+
+#include "isobus/isobus/isobus_data_dictionary.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// @brief Finds DDIs by the words in their name or unit, or by their number.
+/// @details The dictionary is scanned once by build(), which collects every word of every entry
+/// into a sorted table. A query is split into terms, and an entry matches if every term matches:
+/// - A number matches DDIs whose decimal number starts with it, and "0x1F" matches by hex prefix
+/// - A range like "100-200" or "0x80-0xFF" matches every DDI inside it
+/// - A word matches entries with a word it is a prefix of, or, if nothing starts with it,
+///   entries with a word that starts within one or two typos of it
+///
+/// Results are ordered by how well they match, then by DDI.
+class DdiSearchIndex
+{
+public:
+	/// @brief One search result
+	struct Match
+	{
+		const isobus::DataDictionary::Entry *entry; ///< The dictionary entry that matched
+		std::uint32_t score; ///< Higher is a better match
+	};
+
+	static constexpr std::size_t DEFAULT_MAX_RESULTS = 100; ///< How many results search() returns by default
+
+	/// @brief Scans the data dictionary and builds the index. Does nothing if it's already built.
+	void build();
+
+	/// @brief Returns true once build() has been called
+	bool is_built() const;
+
+	/// @brief Returns the number of DDIs in the index
+	std::size_t size() const;
+
+	/// @brief Searches the index
+	/// @param[in] query The text typed by the user. An empty query matches every DDI.
+	/// @param[in] maxResults The maximum number of results to return
+	/// @returns The matching entries, best first. Valid until the next search.
+	const std::vector<Match> &search(const std::string &query, std::size_t maxResults = DEFAULT_MAX_RESULTS);
+
+	/// @brief Searches the index without touching the results returned by get_results()
+	/// @param[in] query The text typed by the user. An empty query matches every DDI.
+	/// @param[in] maxResults The maximum number of results to return
+	/// @param[out] matches The matching entries, best first
+	void search(const std::string &query, std::size_t maxResults, std::vector<Match> &matches);
+
+	/// @brief Returns the results of the last search
+	const std::vector<Match> &get_results() const;
+
+private:
+	/// @brief A word that appears in the name or unit of at least one entry
+	struct Word
+	{
+		std::string text; ///< The lower case word
+		std::vector<std::uint32_t> entryIndices; ///< The entries containing the word, ascending
+	};
+
+	static void split_words(const std::string &text, std::vector<std::string> &words);
+	static bool is_within_prefix_edit_distance(const std::string &term, const std::string &word, std::size_t maximumDistance);
+	static bool parse_number(const std::string &text, std::uint32_t &value, bool &isHex);
+
+	bool match_number_term(const std::string &term);
+	void match_word_term(const std::string &term);
+	void add_term_score(std::uint32_t entryIndex, std::uint32_t score);
+
+	std::vector<const isobus::DataDictionary::Entry *> entries; ///< Every known DDI, ascending
+	std::vector<std::string> decimalDDIs; ///< The DDI of each entry as decimal text
+	std::vector<std::string> hexDDIs; ///< The DDI of each entry as upper case hex text
+	std::vector<Word> words; ///< Every word of every entry, sorted by text
+
+	// Scratch space reused by every search, so typing doesn't allocate
+	std::vector<std::uint32_t> scores;
+	std::vector<std::uint32_t> termScores;
+	std::vector<std::uint32_t> termsMatched;
+	std::vector<std::string> queryTerms;
+	std::vector<std::string> termWords;
+	std::vector<Match> results;
+	bool built = false;
+};
+
+#endif // DDI_SEARCH_INDEX_HPP
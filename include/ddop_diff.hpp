@@ -0,0 +1,127 @@
+//================================================================================================
+/// @file ddop_diff.hpp
+///
+/// @brief Defines a structural comparison and three-way merge of device descriptor object pools
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso and the Open-Agriculture developers
+//================================================================================================
+#ifndef DDOP_DIFF_HPP
+#define DDOP_DIFF_HPP
+
+#include "isobus/isobus/isobus_device_descriptor_object_pool.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// @brief Compares two object pools object by object, and merges the changes of two pools that
+/// were edited from the same base.
+/// @details Objects are first paired by object ID. Objects whose ID was renumbered are then
+/// paired by what they are: elements by element number, process data and properties by the
+/// element number of their parent element and their DDI, presentations by their content, and
+/// the device with the device. Whatever is left is paired by ID again if the type matches, so a
+/// process data object whose DDI changed is still reported as modified. References are compared
+/// through these pairs, so renumbering an object doesn't make everything that refers to it look
+/// modified. Pairing sorts the objects once, so it takes O(n log n).
+class DdopDiff
+{
+public:
+	/// @brief The fields that are compared
+	enum class Field : std::uint8_t
+	{
+		ObjectID,
+		Designator,
+		SoftwareVersion,
+		SerialNumber,
+		StructureLabel,
+		LocalizationLabel,
+		ExtendedStructureLabel,
+		IsoName,
+		ElementType,
+		ElementNumber,
+		ParentObject,
+		ChildObjects,
+		DDI,
+		PropertiesBitfield,
+		TriggerMethodsBitfield,
+		Value,
+		PresentationObject,
+		Offset,
+		Scale,
+		NumberOfDecimals,
+		Object ///< The object itself, for conflicts between deleting and editing it
+	};
+
+	/// @brief How an object differs between the two pools
+	enum class ChangeType : std::uint8_t
+	{
+		Added,
+		Removed,
+		Modified
+	};
+
+	/// @brief One field that has a different value in the two pools
+	struct FieldChange
+	{
+		Field field;
+		std::string oldValue;
+		std::string newValue;
+	};
+
+	/// @brief One object that was added, removed or modified
+	struct ObjectChange
+	{
+		ChangeType type;
+		std::string tableID; ///< DVC, DET, DPD, DPT or DVP
+		std::string designator; ///< The designator in the new pool, or in the old one for removed objects
+		std::uint16_t oldObjectID; ///< NULL_OBJECT_ID for added objects
+		std::uint16_t newObjectID; ///< NULL_OBJECT_ID for removed objects
+		std::vector<FieldChange> fieldChanges; ///< The changed fields of a modified object
+	};
+
+	/// @brief A field that both sides of a merge changed to different values. The merge keeps ours.
+	struct Conflict
+	{
+		std::string tableID;
+		std::string designator;
+		std::uint16_t objectID; ///< The ID in our pool, or in the base pool if we deleted the object
+		Field field;
+		std::string baseValue;
+		std::string ourValue;
+		std::string theirValue;
+	};
+
+	/// @brief Finds every difference between two pools
+	/// @param[in] oldPool The pool before the changes
+	/// @param[in] newPool The pool after the changes
+	/// @returns The modified and added objects in the order of the new pool, then the removed objects
+	static std::vector<ObjectChange> compare(isobus::DeviceDescriptorObjectPool &oldPool, isobus::DeviceDescriptorObjectPool &newPool);
+
+	/// @brief Merges the changes that two pools made to the same base pool.
+	/// @details The merged pool keeps our object IDs. A field changed on only one side takes that
+	/// side's value, and child references added or removed on either side are added or removed.
+	/// Objects that only they added are copied in, keeping their ID unless we already use it.
+	/// Their references to an object we deleted are never copied: they are cleared and reported
+	/// as conflicts, because the raw ID could name an unrelated object in our pool. Each child
+	/// reference dropped this way is reported as its own Field::ChildObjects conflict.
+	/// @param[in] basePool The pool both sides started from
+	/// @param[in] ourPool Our edited pool
+	/// @param[in] theirPool Their edited pool
+	/// @param[out] mergedPool The pool to add the merged objects to. It should be empty.
+	/// @param[out] conflicts The fields that were changed differently on both sides, or that couldn't be merged
+	/// @returns true if every merged object could be added to the merged pool
+	static bool merge(isobus::DeviceDescriptorObjectPool &basePool,
+	                  isobus::DeviceDescriptorObjectPool &ourPool,
+	                  isobus::DeviceDescriptorObjectPool &theirPool,
+	                  isobus::DeviceDescriptorObjectPool &mergedPool,
+	                  std::vector<Conflict> &conflicts);
+
+	/// @brief Returns a readable name for a field
+	static const char *get_field_name(Field field);
+
+	/// @brief Returns a readable name for a change type
+	static const char *get_change_type_name(ChangeType type);
+};
+
+#endif // DDOP_DIFF_HPP
@@ -0,0 +1,168 @@
+//================================================================================================
+/// @file edit_journal.hpp
+///
+/// @brief Defines an undo/redo history made of field level edits to DDOP objects
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso and the Open-Agriculture developers
+//================================================================================================
+#ifndef EDIT_JOURNAL_HPP
+#define EDIT_JOURNAL_HPP
+
+#include "isobus/isobus/isobus_device_descriptor_object_pool.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <variant>
+#include <vector>
+
+/// @brief Records edits to a DDOP as small deltas, so they can be undone and redone.
+/// @details Each delta names one field of one object with its value before and after the edit,
+/// instead of keeping a copy of the pool. Deltas are grouped into entries, and an entry is what one
+/// undo or redo reverts or re-applies. Repeated edits of the same field in quick succession, like
+/// typing into a text box, are merged into one entry. The oldest entries are dropped once the
+/// history grows past its byte budget.
+/// The journal only stores the deltas, applying them to the pool is up to the caller.
+class EditJournal
+{
+public:
+	/// @brief The fields that can be edited
+	enum class Field : std::uint8_t
+	{
+		Designator,
+		SoftwareVersion,
+		SerialNumber,
+		StructureLabel,
+		ExtendedStructureLabel,
+		IsoName,
+		LocalizationLabel,
+		ObjectID,
+		ElementNumber,
+		ParentObject,
+		ChildReference, ///< A child reference of a device element, at the delta's position
+		DDI,
+		PropertiesBitfield,
+		TriggerMethodsBitfield,
+		Value,
+		PresentationObject,
+		Offset,
+		Scale,
+		NumberOfDecimals,
+		Object ///< The object itself was created or deleted
+	};
+
+	/// @brief The value of a field. Byte arrays are stored as strings, and an empty value means
+	/// that a child reference or object does not exist on that side of the edit.
+	using FieldValue = std::variant<std::monostate, std::int64_t, float, std::string, std::shared_ptr<isobus::task_controller_object::Object>>;
+
+	/// @brief One change to one field of one object
+	struct Delta
+	{
+		std::uint16_t objectID; ///< The object that was edited, with the ID it had before the edit
+		Field field; ///< The field that was edited
+		std::uint16_t position; ///< The index in the child reference list, for child references
+		FieldValue oldValue; ///< The value before the edit
+		FieldValue newValue; ///< The value after the edit
+
+		/// @brief Creates a delta for an integer field
+		static Delta number(std::uint16_t objectID, Field field, std::int64_t oldValue, std::int64_t newValue);
+
+		/// @brief Creates a delta for a text or byte array field
+		static Delta text(std::uint16_t objectID, Field field, const std::string &oldValue, const std::string &newValue);
+
+		/// @brief Creates a delta for the scale of a value presentation
+		static Delta scale(std::uint16_t objectID, float oldValue, float newValue);
+
+		/// @brief Creates a delta for a child reference inserted into a device element
+		static Delta child_reference_added(std::uint16_t elementID, std::uint16_t position, std::uint16_t childID);
+
+		/// @brief Creates a delta for a child reference removed from a device element
+		static Delta child_reference_removed(std::uint16_t elementID, std::uint16_t position, std::uint16_t childID);
+
+		/// @brief Creates a delta for an object that was added to the pool
+		static Delta object_added(const std::shared_ptr<isobus::task_controller_object::Object> &object);
+
+		/// @brief Creates a delta for an object that was removed from the pool
+		static Delta object_removed(const std::shared_ptr<isobus::task_controller_object::Object> &object);
+	};
+
+	/// @brief A group of deltas that is undone and redone as a whole
+	struct Entry
+	{
+		std::vector<Delta> deltas; ///< The deltas, in the order they were applied
+		std::size_t sizeInBytes = 0; ///< Estimate of the memory the entry uses
+	};
+
+	static constexpr std::size_t DEFAULT_BYTE_BUDGET = 4 * 1024 * 1024; ///< The default limit on the size of the history
+
+	/// @brief Constructor for the journal
+	/// @param[in] byteBudget The approximate memory the history may use before the oldest entries are dropped
+	/// @param[in] coalesceWindow Edits to the same field closer together than this are merged
+	explicit EditJournal(std::size_t byteBudget = DEFAULT_BYTE_BUDGET, std::chrono::milliseconds coalesceWindow = std::chrono::milliseconds(1000));
+
+	/// @brief Records an edit that has already been applied, discarding anything that could be redone
+	/// @param[in] delta The edit
+	void record(Delta delta);
+
+	/// @brief Starts collecting deltas into a single entry, for edits made of several changes.
+	/// Groups may be nested, the entry is finished by the outermost end_group().
+	void begin_group();
+
+	/// @brief Finishes the entry started by begin_group()
+	void end_group();
+
+	/// @brief Stops the next edit from being merged into the last entry
+	void seal();
+
+	/// @brief Returns true if there is an entry to undo
+	bool can_undo() const;
+
+	/// @brief Returns true if there is an entry to redo
+	bool can_redo() const;
+
+	/// @brief Steps back one entry. The caller must revert its deltas, last delta first.
+	/// @returns The entry to revert, or nullptr if there is nothing to undo
+	const Entry *undo();
+
+	/// @brief Steps forward one entry. The caller must re-apply its deltas, first delta first.
+	/// @returns The entry to re-apply, or nullptr if there is nothing to redo
+	const Entry *redo();
+
+	/// @brief Forgets the whole history
+	void clear();
+
+	/// @brief Changes the approximate memory the history may use, dropping old entries if needed
+	/// @param[in] byteBudget The new budget in bytes
+	void set_byte_budget(std::size_t byteBudget);
+
+	/// @brief Returns the approximate memory the history may use
+	std::size_t get_byte_budget() const;
+
+	/// @brief Returns the estimated memory the history currently uses
+	std::size_t get_size_in_bytes() const;
+
+private:
+	using Clock = std::chrono::steady_clock;
+
+	static std::size_t get_size_in_bytes(const Delta &delta);
+	static std::size_t get_size_in_bytes(const FieldValue &value);
+	bool try_coalesce(const Delta &delta);
+	void push_entry(Entry entry);
+	void trim_to_budget();
+
+	std::deque<Entry> entries; ///< Undoable entries come first, followed by the redoable ones
+	Entry openGroup; ///< The entry being collected between begin_group() and end_group()
+	Clock::time_point lastRecordTime;
+	Clock::duration coalesceWindow;
+	std::size_t byteBudget;
+	std::size_t totalSizeInBytes = 0;
+	std::size_t numberOfUndoableEntries = 0;
+	std::uint32_t groupDepth = 0;
+	bool sealed = true;
+};
+
+#endif // EDIT_JOURNAL_HPP
@@ -0,0 +1,137 @@
+//================================================================================================
+/// @file frame_profiler.hpp
+///
+/// @brief Defines a profiler that times the expensive parts of each GUI frame
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso and the Open-Agriculture developers
+//================================================================================================
+#ifndef FRAME_PROFILER_HPP
+#define FRAME_PROFILER_HPP
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+/// @brief Measures how long each part of a frame takes and how many heap allocations it makes.
+/// @details Parts of the frame are timed by putting a ScopedZone around them. The last few
+/// seconds of frames are kept, drawn as histograms in an overlay, and can be exported as CSV or
+/// as a Chrome trace (chrome://tracing or https://ui.perfetto.dev) for offline analysis.
+///
+/// Allocations are counted by replacing the global operator new, which is only compiled in when
+/// DDOP_PROFILER_COUNT_ALLOCATIONS is defined. Only allocations made by the GUI thread are
+/// counted, and ImGui's own allocations, which go through malloc, are not included.
+class FrameProfiler
+{
+public:
+	/// @brief The parts of a frame that are timed
+	enum class Zone : std::uint8_t
+	{
+		ObjectTree = 0,
+		AllObjects,
+		SelectedObjectSettings,
+		Save,
+		GLRender,
+
+		NumberOfZones
+	};
+
+	/// @brief Times the enclosing scope as one call of a zone
+	class ScopedZone
+	{
+	public:
+		/// @brief Starts timing the zone
+		/// @param[in] profiler The profiler to report to
+		/// @param[in] zone The zone being timed
+		ScopedZone(FrameProfiler &profiler, Zone zone);
+
+		/// @brief Stops timing the zone
+		~ScopedZone();
+
+		ScopedZone(const ScopedZone &) = delete;
+		ScopedZone &operator=(const ScopedZone &) = delete;
+
+	private:
+		FrameProfiler &profiler;
+		std::chrono::steady_clock::time_point startTime;
+		std::uint64_t startAllocations;
+		Zone zone;
+	};
+
+	FrameProfiler() = default;
+
+	/// @brief Call before building the ImGui frame
+	void begin_frame();
+
+	/// @brief Call after the frame has been presented
+	void end_frame();
+
+	/// @brief Draws a window with per zone histograms, allocation counts and export buttons
+	/// @param[in,out] isOpen Set to false when the user closes the window
+	void render_overlay(bool *isOpen);
+
+	/// @brief Writes the recorded frames as CSV, one row per frame, oldest first
+	/// @param[in] output The stream to write to
+	/// @returns true if the stream is still good afterwards
+	bool export_csv(std::ostream &output) const;
+
+	/// @brief Writes the recorded frames in the Chrome trace event format, oldest first
+	/// @param[in] output The stream to write to
+	/// @returns true if the stream is still good afterwards
+	bool export_chrome_trace(std::ostream &output) const;
+
+	/// @brief Returns the name of a zone, as shown in the overlay and exports
+	static const char *get_zone_name(Zone zone);
+
+	/// @brief Returns the number of heap allocations made by the calling thread so far
+	static std::uint64_t get_allocation_count();
+
+	/// @brief Returns true if allocations are being counted in this build
+	static bool is_counting_allocations();
+
+private:
+	using Clock = std::chrono::steady_clock;
+
+	static constexpr std::size_t HISTORY_LENGTH = 240; ///< Number of frames kept for the histograms and exports
+	static constexpr std::size_t NUMBER_OF_ZONES = static_cast<std::size_t>(Zone::NumberOfZones);
+
+	/// @brief Everything measured for one zone in one frame
+	struct ZoneSample
+	{
+		float start_ms = 0.0f; ///< When the zone was first entered, relative to the start of the frame
+		float duration_ms = 0.0f; ///< Total time of all calls in the frame
+		float allocations = 0.0f; ///< Stored as float so the histograms can plot it directly
+		std::uint32_t calls = 0;
+	};
+
+	/// @brief Everything measured for one frame
+	struct FrameRecord
+	{
+		std::uint64_t frameNumber = 0;
+		std::uint64_t startTime_us = 0; ///< Relative to when the profiler was created
+		float duration_ms = 0.0f;
+		float allocations = 0.0f;
+		std::array<ZoneSample, NUMBER_OF_ZONES> zones;
+	};
+
+	void end_zone(Zone zone, Clock::time_point startTime, std::uint64_t startAllocations);
+	const FrameRecord &get_recorded_frame(std::size_t index) const;
+	void render_zone_row(std::size_t zoneIndex);
+	void export_to_file(const std::string &fileName, bool chromeTrace);
+
+	std::array<FrameRecord, HISTORY_LENGTH> history;
+	FrameRecord currentFrame;
+	Clock::time_point creationTime = Clock::now();
+	Clock::time_point frameStartTime;
+	std::uint64_t frameStartAllocations = 0;
+	std::uint64_t totalFrames = 0;
+	std::size_t historyIndex = 0; ///< The slot the next frame is recorded into
+	std::size_t numberOfRecordedFrames = 0;
+	std::string exportStatus;
+	bool paused = false;
+	bool inFrame = false;
+};
+
+#endif // FRAME_PROFILER_HPP
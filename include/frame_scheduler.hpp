@@ -0,0 +1,86 @@
+//================================================================================================
+/// @file frame_scheduler.hpp
+///
+/// @brief Defines a scheduler that only renders frames when the GUI might have changed
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso and the Open-Agriculture developers
+//================================================================================================
+#ifndef FRAME_SCHEDULER_HPP
+#define FRAME_SCHEDULER_HPP
+
+#include "SDL.h"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+/// @brief Decides when the main loop needs to render a frame.
+/// @details Rather than redrawing every vsync, the main loop blocks in SDL until an event arrives.
+/// After an event, a few extra frames are rendered so that ImGui can settle things such as
+/// window sizing and hover states, then the loop goes back to sleep.
+/// It also records frame statistics, which can be shown in an overlay.
+class FrameScheduler
+{
+public:
+	/// @brief Options that control how aggressively the scheduler idles
+	struct Settings
+	{
+		bool idleWhenInactive = true; ///< If false, a frame is rendered every vsync like a normal game loop
+		std::uint32_t settleFrames = 3; ///< Number of frames to render after the last event
+		std::uint32_t keepAliveInterval_ms = 1000; ///< While idle, render a frame at least this often, or never if 0
+	};
+
+	FrameScheduler() = default;
+
+	/// @brief Gets the next event, blocking while there is nothing to render.
+	/// @param[out] event The event that was received
+	/// @returns true if an event was received, false if there were no events or the wait timed out
+	bool wait_for_event(SDL_Event &event);
+
+	/// @brief Call for every event handled, so that the following frames get rendered
+	void on_event();
+
+	/// @brief Asks for a number of frames to be rendered, for example while some background work is updating the GUI
+	/// @param[in] numberOfFrames The minimum number of frames to render
+	void request_frames(std::uint32_t numberOfFrames);
+
+	/// @brief Returns true if the main loop should render a frame after handling the current events
+	bool should_render_frame();
+
+	/// @brief Call before building the ImGui frame, to measure how long the frame took
+	void begin_frame();
+
+	/// @brief Call after the frame has been presented
+	void end_frame();
+
+	/// @brief Draws a small window with frame time statistics and the scheduler settings
+	/// @param[in,out] isOpen Set to false when the user closes the window
+	void render_statistics_window(bool *isOpen);
+
+	/// @brief Returns the current settings
+	Settings &get_settings();
+
+private:
+	using Clock = std::chrono::steady_clock;
+
+	static constexpr std::size_t FRAME_HISTORY_LENGTH = 120; ///< Number of frame times kept for the graph
+
+	void update_rates(Clock::time_point now);
+
+	Settings settings;
+	std::array<float, FRAME_HISTORY_LENGTH> frameTimeHistory_ms = { 0.0f };
+	Clock::time_point frameStartTime;
+	Clock::time_point rateWindowStartTime = Clock::now();
+	Clock::duration idleTimeInRateWindow = Clock::duration::zero();
+	std::uint64_t totalFramesRendered = 0;
+	std::uint64_t totalWakeups = 0;
+	std::size_t frameHistoryIndex = 0;
+	std::uint32_t pendingFrames = 1;
+	std::uint32_t framesInRateWindow = 0;
+	float framesPerSecond = 0.0f;
+	float idlePercentage = 0.0f;
+	bool waitTimedOut = false;
+};
+
+#endif // FRAME_SCHEDULER_HPP
@@ -9,13 +9,29 @@
 #ifndef GUI_HPP
 #define GUI_HPP
 
+#include "background_validator.hpp"
+#include "ddi_search_index.hpp"
+#include "edit_journal.hpp"
+#include "frame_profiler.hpp"
+#include "frame_scheduler.hpp"
+#include "incremental_serializer.hpp"
 #include "isobus/isobus/isobus_device_descriptor_object_pool.hpp"
 #include "isobus/isobus/isobus_language_command_interface.hpp"
+#include "logsink.hpp"
+#include "object_filter.hpp"
+#include "object_id_allocator.hpp"
+#include "object_label_cache.hpp"
+#include "object_pool_snapshot.hpp"
+#include "object_reference_index.hpp"
+#include "object_tree_index.hpp"
+#include "object_view.hpp"
 
 #include <memory>
 #include <string>
 #include <vector>
 
+struct ImGuiTableSortSpecs;
+
 class DDOPGeneratorGUI
 {
 public:
@@ -25,31 +41,67 @@ public:
 
 private:
 	static constexpr std::size_t FILE_PATH_BUFFER_MAX_LENGTH = 1024;
+	static constexpr std::uint8_t OBJECT_TREE_MATCH = 0x01; ///< The object matches the object tree filter
+	static constexpr std::uint8_t OBJECT_TREE_ANCESTOR = 0x02; ///< The object is above a match in the object tree
+
+	/// @brief The sortable columns of the All Objects table
+	enum class ObjectListColumn : std::uint8_t
+	{
+		Type = 0,
+		ID,
+		Designator,
+		DDI
+	};
 
 	bool render_menu_bar();
 	void render_open_file_menu();
 	void parseElementChildrenOfElement(std::uint16_t objectID);
-	void parseChildren(std::shared_ptr<isobus::task_controller_object::DeviceElementObject> element);
+	void parseChildren(isobus::task_controller_object::DeviceElementObject &element);
 	void render_object_tree();
-	void render_device_settings(std::shared_ptr<isobus::task_controller_object::DeviceObject> object);
-	void render_device_element_settings(std::shared_ptr<isobus::task_controller_object::DeviceElementObject> object);
-	void render_device_process_data_settings(std::shared_ptr<isobus::task_controller_object::DeviceProcessDataObject> object);
-	void render_device_property_settings(std::shared_ptr<isobus::task_controller_object::DevicePropertyObject> object);
-	void render_device_presentation_settings(std::shared_ptr<isobus::task_controller_object::DeviceValuePresentationObject> object);
-	void render_object_components(std::shared_ptr<isobus::task_controller_object::Object> object);
-	void render_current_selected_object_settings(std::shared_ptr<isobus::task_controller_object::Object> object);
-	void render_device_element_components(std::shared_ptr<isobus::task_controller_object::DeviceElementObject> object);
-	void render_device_process_data_components(std::shared_ptr<isobus::task_controller_object::DeviceProcessDataObject> object);
-	void render_device_property_components(std::shared_ptr<isobus::task_controller_object::DevicePropertyObject> object);
-	void render_device_presentation_components(std::shared_ptr<isobus::task_controller_object::DeviceValuePresentationObject> object);
+	void render_object_tree_filter();
+	void rebuild_object_tree_filter();
+	bool is_visible_in_object_tree(std::uint16_t objectID) const;
+	void open_if_object_tree_ancestor(std::uint16_t objectID);
+	void render_device_settings(isobus::task_controller_object::DeviceObject &object);
+	void render_device_element_settings(isobus::task_controller_object::DeviceElementObject &object);
+	void render_device_process_data_settings(isobus::task_controller_object::DeviceProcessDataObject &object);
+	void render_device_property_settings(isobus::task_controller_object::DevicePropertyObject &object);
+	void render_device_presentation_settings(isobus::task_controller_object::DeviceValuePresentationObject &object);
+	bool render_ddi_search(int &ddi);
+	void render_object_components(ObjectView object);
+	void render_current_selected_object_settings(ObjectView object);
+	void render_device_element_components(isobus::task_controller_object::DeviceElementObject &object);
+	void render_device_process_data_components(isobus::task_controller_object::DeviceProcessDataObject &object);
+	void render_device_property_components(isobus::task_controller_object::DevicePropertyObject &object);
+	void render_device_presentation_components(isobus::task_controller_object::DeviceValuePresentationObject &object);
 	void render_save();
+	void render_operation_log() const;
 	void render_all_objects();
-	void on_selected_object_changed(std::shared_ptr<isobus::task_controller_object::Object> newObject);
+	void render_validation_status();
+	bool push_object_issue_style(std::uint16_t objectID);
+	void pop_object_issue_style(bool hasIssues, std::uint16_t objectID);
+	void rebuild_all_objects_rows(const ImGuiTableSortSpecs *sortSpecs);
+	void on_selected_object_changed(ObjectView newObject);
 	static std::string get_element_type_string(isobus::task_controller_object::DeviceElementObject::Type type);
 	static std::string get_object_type_string(isobus::task_controller_object::ObjectTypes type);
-	static std::string get_object_display_name(std::shared_ptr<isobus::task_controller_object::Object> object);
+	static std::string get_object_display_name(ObjectView object);
+	const std::string &get_object_label(ObjectView object);
+	const std::string &get_presentation_label(const isobus::task_controller_object::DeviceValuePresentationObject &object);
 	const std::array<std::uint8_t, 7> generate_localization_label();
 	std::uint16_t get_first_unused_id() const;
+	void rebuild_object_indexes();
+	void on_object_added(std::shared_ptr<isobus::task_controller_object::Object> object);
+	void on_object_removed(std::uint16_t objectID);
+	void on_object_id_changed(std::uint16_t oldID, std::uint16_t newID);
+	void on_object_changed(std::uint16_t objectID);
+	void on_object_references_changed();
+	void commit_edit(EditJournal::Delta delta);
+	void apply_edit(const EditJournal::Delta &delta, bool revert);
+	void undo_edit();
+	void redo_edit();
+	void reload_selected_object();
+	void delete_objects(const std::vector<std::uint16_t> &objectIDs);
+	std::vector<std::uint16_t> get_element_subtree(std::uint16_t elementID) const;
 
 	std::string languageCode;
 	isobus::LanguageCommandInterface::DecimalSymbols decimalSymbol = isobus::LanguageCommandInterface::DecimalSymbols::Point;
@@ -65,7 +117,23 @@ private:
 	isobus::LanguageCommandInterface::UnitSystem genericUnitSystem = isobus::LanguageCommandInterface::UnitSystem::Metric;
 
 	std::unique_ptr<isobus::DeviceDescriptorObjectPool> currentObjectPool;
-	std::vector<std::uint8_t> loadedIopData;
+	ObjectTreeIndex objectTreeIndex;
+	ObjectReferenceIndex objectReferenceIndex;
+	ObjectIDAllocator objectIDAllocator;
+	ObjectLabelCache objectLabelCache;
+	ObjectPoolSnapshot objectPoolSnapshot;
+	IncrementalSerializer ddopSerializer;
+	BackgroundValidator backgroundValidator;
+	EditJournal editJournal;
+	std::vector<std::uint32_t> allObjectsRows; ///< The snapshot rows shown in the All Objects table, in display order
+	ObjectFilter objectTreeFilter;
+	std::vector<std::uint32_t> objectTreeFilterRows; ///< The snapshot rows that match the object tree filter
+	std::vector<std::uint8_t> objectTreeVisibility; ///< OBJECT_TREE_MATCH and OBJECT_TREE_ANCESTOR bits for every object ID
+	LogContext operationLog;
+	FrameScheduler frameScheduler;
+	FrameProfiler frameProfiler;
+	DdiSearchIndex ddiSearchIndex;
+	char ddiSearchBuffer[65] = { 0 };
 	char filePathBuffer[FILE_PATH_BUFFER_MAX_LENGTH] = { 0 };
 	char designatorBuffer[129] = { 0 };
 	char softwareVersionBuffer[129] = { 0 };
@@ -74,6 +142,8 @@ private:
 	char extendedStructureLabelBuffer[129] = { 0 };
 	char hexIsoNameBuffer[17] = { 0 };
 	char languageCodeBuffer[3] = { 0 };
+	char allObjectsFilterBuffer[65] = { 0 };
+	char objectTreeFilterBuffer[129] = { 0 };
 	std::string lastFileName;
 	int elementNumberBuffer = 0;
 	int parentObjectBuffer = 0;
@@ -94,6 +164,12 @@ private:
 	bool saveAsModal = false;
 	bool exportModal = false;
 	bool currentPoolValid = false;
+	bool showFrameStatistics = false;
+	bool showFrameProfiler = false;
+	bool allObjectsListDirty = true;
+	bool ddiSearchDirty = true;
+	bool objectTreeFilterDirty = false;
+	bool objectTreeFilterChanged = false; ///< Ancestors of the matches are opened on the frame after the filter text changes
 };
 
 #endif // GUI_HPP
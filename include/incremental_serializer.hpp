@@ -0,0 +1,64 @@
+//================================================================================================
+/// @file incremental_serializer.hpp
+///
+/// @brief Defines a serializer that keeps the encoded bytes of every object in a DDOP, so that
+/// saving after a small edit only re-encodes the objects that changed.
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso and the Open-Agriculture developers
+//================================================================================================
+#ifndef INCREMENTAL_SERIALIZER_HPP
+#define INCREMENTAL_SERIALIZER_HPP
+
+#include "isobus/isobus/isobus_device_descriptor_object_pool.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/// @brief Serializes a DDOP, reusing the cached bytes of every object that has not been edited.
+/// @details The first serialization, and any serialization after invalidate(), goes through the
+/// object pool so that the pool is fully validated and any errors are logged. After that, objects
+/// reported through mark_dirty() are re-encoded and spliced into the cached binary. Edits that change
+/// references between objects, or add, remove or renumber objects, must call invalidate() instead,
+/// because only the full path checks that references are still valid.
+class IncrementalSerializer
+{
+public:
+	/// @brief Records that one object's fields changed, without changing any references
+	/// @param[in] objectID The ID of the edited object
+	void mark_dirty(std::uint16_t objectID);
+
+	/// @brief Discards the cache, so the next serialization validates and encodes the whole pool
+	void invalidate();
+
+	/// @brief Serializes the pool into its binary form
+	/// @param[in] pool The object pool to serialize
+	/// @param[out] binaryPool The serialized pool
+	/// @returns true if the pool was serialized, false if the pool is not valid
+	bool serialize(isobus::DeviceDescriptorObjectPool &pool, std::vector<std::uint8_t> &binaryPool);
+
+private:
+	/// @brief Where one object's bytes live in the cached binary
+	struct CachedObject
+	{
+		std::shared_ptr<isobus::task_controller_object::Object> object; ///< The object the bytes belong to
+		std::size_t offset; ///< Offset of the object's bytes in the cached binary
+		std::size_t length; ///< Number of bytes the object encodes to
+	};
+
+	bool serialize_full(isobus::DeviceDescriptorObjectPool &pool);
+	bool serialize_dirty_objects(isobus::DeviceDescriptorObjectPool &pool);
+
+	std::vector<std::uint8_t> cachedBinary; ///< The most recent serialized pool
+	std::vector<CachedObject> cachedObjects; ///< The layout of cachedBinary, in pool order
+	std::unordered_map<std::uint16_t, std::size_t> cachedObjectIndexByID; ///< Index into cachedObjects for each object ID
+	std::unordered_set<std::uint16_t> dirtyObjectIDs; ///< Objects edited since the last serialization
+	std::uint8_t cachedCompatibilityLevel = 0; ///< The TC compatibility level the cache was encoded for
+	bool cacheValid = false; ///< Whether cachedBinary can be patched instead of rebuilt
+};
+
+#endif // INCREMENTAL_SERIALIZER_HPP
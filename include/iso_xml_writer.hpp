@@ -0,0 +1,71 @@
+//================================================================================================
+/// @file iso_xml_writer.hpp
+///
+/// @brief Defines a streaming ISOXML (TASKDATA.XML) writer for device descriptor object pools
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso and the Open-Agriculture developers
+//================================================================================================
+#ifndef ISO_XML_WRITER_HPP
+#define ISO_XML_WRITER_HPP
+
+#include "isobus/isobus/isobus_device_descriptor_object_pool.hpp"
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+/// @brief Writes ISO 11783-10 TASKDATA XML straight to a stream while walking the object pool.
+/// @details Nothing but the element being written is held in memory, so the memory used does not
+/// grow with the size of the pool. Several devices can be written into one TASKDATA by calling
+/// write_device() once per pool between begin_task_data() and end_task_data(). Device and device
+/// element IDs ("DVC-n", "DET-n") are numbered across all devices written, so they stay unique.
+class IsoXmlWriter
+{
+public:
+	/// @brief Constructor
+	/// @param[in] outputStream The stream to write to. It should be buffered, such as a std::ofstream.
+	explicit IsoXmlWriter(std::ostream &outputStream);
+
+	/// @brief Writes the XML declaration and opens the ISO11783_TaskData root element
+	/// @param[in] versionMajor The task controller version the data is for
+	void begin_task_data(std::uint8_t versionMajor);
+
+	/// @brief Writes one DVC element, with the content of a pool in the order the standard requires
+	/// @param[in] pool The object pool describing the device
+	/// @returns true if the pool has a device object and was written, otherwise false
+	bool write_device(isobus::DeviceDescriptorObjectPool &pool);
+
+	/// @brief Closes the root element and flushes the stream
+	/// @returns true if everything was written without a stream error
+	bool end_task_data();
+
+	/// @brief Writes a complete TASKDATA with a single device
+	/// @param[in] pool The object pool describing the device
+	/// @param[in] outputStream The stream to write to
+	/// @returns true if the pool was written without errors
+	static bool write_task_data(isobus::DeviceDescriptorObjectPool &pool, std::ostream &outputStream);
+
+	/// @brief Escapes the characters that may not appear literally in an XML attribute value
+	/// @param[in] text The text to escape
+	/// @returns The escaped text
+	static std::string escape(const std::string &text);
+
+private:
+	void write_device_element(isobus::task_controller_object::DeviceElementObject &element);
+	void write_process_data(const isobus::task_controller_object::DeviceProcessDataObject &processData);
+	void write_property(const isobus::task_controller_object::DevicePropertyObject &property);
+	void write_presentation(const isobus::task_controller_object::DeviceValuePresentationObject &presentation);
+
+	void write_attribute(char name, const std::string &value);
+	void write_attribute(char name, std::int64_t value);
+	void write_hex_attribute(char name, std::uint64_t value, int numberOfDigits);
+	void write_hex_attribute(char name, const std::uint8_t *data, std::size_t length);
+	void write_decimal_attribute(char name, float value);
+
+	std::ostream &output;
+	std::uint32_t numberOfDevices = 0; ///< The number of DVC elements written so far
+	std::uint32_t numberOfDeviceElements = 0; ///< The number of DET elements written so far, over all devices
+};
+
+#endif // ISO_XML_WRITER_HPP
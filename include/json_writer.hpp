@@ -0,0 +1,198 @@
+//================================================================================================
+/// @file json_writer.hpp
+///
+/// @brief Defines a minimal streaming JSON writer used for machine readable reports
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso and the Open-Agriculture developers
+//================================================================================================
+#ifndef JSON_WRITER_HPP
+#define JSON_WRITER_HPP
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/// @brief Writes JSON straight to a stream, taking care of commas and string escaping.
+/// Objects and arrays must be closed in the order they were opened.
+class JsonWriter
+{
+public:
+	explicit JsonWriter(std::ostream &outputStream) :
+	  output(outputStream)
+	{
+	}
+
+	void begin_object()
+	{
+		begin_value();
+		open_scope('{');
+	}
+
+	void begin_object(const std::string &key)
+	{
+		write_key(key);
+		open_scope('{');
+	}
+
+	void end_object()
+	{
+		close_scope('}');
+	}
+
+	void begin_array()
+	{
+		begin_value();
+		open_scope('[');
+	}
+
+	void begin_array(const std::string &key)
+	{
+		write_key(key);
+		open_scope('[');
+	}
+
+	void end_array()
+	{
+		close_scope(']');
+	}
+
+	/// @brief Writes a key and value as a member of the current object
+	template<typename T>
+	void write(const std::string &key, T value)
+	{
+		write_key(key);
+		write_value(value);
+	}
+
+	/// @brief Writes a value as an element of the current array
+	template<typename T>
+	void write_element(T value)
+	{
+		begin_value();
+		write_value(value);
+	}
+
+	static std::string escape(const std::string &text)
+	{
+		std::string retVal;
+		retVal.reserve(text.size() + 2);
+
+		for (char character : text)
+		{
+			switch (character)
+			{
+				case '"':
+					retVal += "\\\"";
+					break;
+				case '\\':
+					retVal += "\\\\";
+					break;
+				case '\n':
+					retVal += "\\n";
+					break;
+				case '\r':
+					retVal += "\\r";
+					break;
+				case '\t':
+					retVal += "\\t";
+					break;
+				default:
+				{
+					if (static_cast<unsigned char>(character) < 0x20)
+					{
+						char escaped[7];
+						std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned int>(character));
+						retVal += escaped;
+					}
+					else
+					{
+						retVal += character;
+					}
+				}
+				break;
+			}
+		}
+		return retVal;
+	}
+
+private:
+	void begin_value()
+	{
+		if (!firstInScope.empty())
+		{
+			if (!firstInScope.back())
+			{
+				output << ',';
+			}
+			firstInScope.back() = false;
+		}
+	}
+
+	void write_key(const std::string &key)
+	{
+		begin_value();
+		output << '"' << escape(key) << "\":";
+	}
+
+	void open_scope(char bracket)
+	{
+		output << bracket;
+		firstInScope.push_back(true);
+	}
+
+	void close_scope(char bracket)
+	{
+		output << bracket;
+		firstInScope.pop_back();
+	}
+
+	void write_value(const std::string &value)
+	{
+		output << '"' << escape(value) << '"';
+	}
+
+	void write_value(const char *value)
+	{
+		write_value(std::string(value));
+	}
+
+	void write_value(bool value)
+	{
+		output << (value ? "true" : "false");
+	}
+
+	void write_value(double value)
+	{
+		if (std::isfinite(value))
+		{
+			output << value;
+		}
+		else
+		{
+			output << "null";
+		}
+	}
+
+	template<typename T>
+	typename std::enable_if<std::is_integral<T>::value>::type write_value(T value)
+	{
+		if (std::is_signed<T>::value)
+		{
+			output << static_cast<long long>(value);
+		}
+		else
+		{
+			output << static_cast<unsigned long long>(value);
+		}
+	}
+
+	std::ostream &output;
+	std::vector<bool> firstInScope;
+};
+
+#endif // JSON_WRITER_HPP
@@ -1,7 +1,13 @@
 #include "isobus/isobus/can_stack_logger.hpp"
 
-#include <deque>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
 #include <string>
+#include <thread>
+#include <vector>
 
 // A log sink for the CAN stack
 //================================================================================================
@@ -15,28 +21,181 @@
 #ifndef LOG_SINK_HPP
 #define LOG_SINK_HPP
 
-class CustomLogger : public isobus::CANStackLogger
+/// @brief Stores the messages logged during one operation, such as loading or saving a DDOP.
+/// Messages are copied into a ring of fixed size slots that is allocated up front, so logging
+/// never allocates, and several threads may log into the same context without locking.
+/// Once the ring is full, the oldest messages are overwritten and counted instead.
+/// Messages should only be read once the operation that logged them has finished.
+class LogContext
 {
 public:
+	/// @brief A copy of one message, for keeping it beyond the lifetime of the context
 	struct LogInfo
 	{
-		CANStackLogger::LoggingLevel logLevel;
-		const std::string logText;
+		isobus::CANStackLogger::LoggingLevel logLevel;
+		std::string logText;
 	};
 
-	void sink_CAN_stack_log(CANStackLogger::LoggingLevel level, const std::string &text) override
+	static constexpr std::size_t DEFAULT_CAPACITY = 1024; ///< The default number of messages kept
+	static constexpr std::size_t MAX_MESSAGE_LENGTH = 239; ///< Longer messages are truncated to this many characters
+
+	/// @brief Constructor for a log context
+	/// @param[in] capacity The number of messages that can be stored before the oldest is overwritten
+	explicit LogContext(std::size_t capacity = DEFAULT_CAPACITY) :
+	  slots(new Slot[capacity > 0 ? capacity : 1]),
+	  numberOfSlots(capacity > 0 ? capacity : 1)
+	{
+	}
+
+	LogContext(const LogContext &) = delete;
+	LogContext &operator=(const LogContext &) = delete;
+
+	/// @brief Copies a message into the next slot. Safe to call from several threads at once.
+	/// @param[in] level The severity of the message
+	/// @param[in] text The message text
+	void add_message(isobus::CANStackLogger::LoggingLevel level, const std::string &text)
+	{
+		std::uint64_t ticket = nextTicket.fetch_add(1, std::memory_order_relaxed);
+		Slot &slot = slots[ticket % numberOfSlots];
+
+		// A writer one lap behind may still be copying into this slot, so wait for it to publish first
+		std::uint64_t previousSequence = (ticket >= numberOfSlots) ? (ticket - numberOfSlots + 1) : 0;
+		while (slot.sequence.load(std::memory_order_acquire) != previousSequence)
+		{
+			std::this_thread::yield();
+		}
+
+		slot.level = level;
+		slot.length = static_cast<std::uint16_t>(std::min(text.size(), MAX_MESSAGE_LENGTH));
+		std::memcpy(slot.text, text.data(), slot.length);
+		slot.text[slot.length] = '\0';
+		slot.sequence.store(ticket + 1, std::memory_order_release);
+	}
+
+	/// @brief Calls a function for each stored message, oldest first
+	/// @param[in] callback Called with the level and the null terminated text of each message
+	template<typename Callback>
+	void for_each_message(Callback &&callback) const
+	{
+		std::uint64_t endTicket = nextTicket.load(std::memory_order_acquire);
+
+		for (std::uint64_t ticket = get_first_ticket(endTicket); ticket < endTicket; ticket++)
+		{
+			const Slot &slot = slots[ticket % numberOfSlots];
+
+			if ((ticket + 1) == slot.sequence.load(std::memory_order_acquire))
+			{
+				callback(slot.level, static_cast<const char *>(slot.text));
+			}
+		}
+	}
+
+	/// @brief Copies the stored messages out of the ring, oldest first
+	/// @returns The stored messages
+	std::vector<LogInfo> get_messages() const
+	{
+		std::vector<LogInfo> retVal;
+		retVal.reserve(size());
+		for_each_message([&retVal](isobus::CANStackLogger::LoggingLevel level, const char *text) {
+			retVal.push_back({ level, text });
+		});
+		return retVal;
+	}
+
+	/// @brief Returns the number of messages currently stored
+	std::size_t size() const
+	{
+		std::uint64_t endTicket = nextTicket.load(std::memory_order_acquire);
+		return static_cast<std::size_t>(endTicket - get_first_ticket(endTicket));
+	}
+
+	/// @brief Returns true if nothing has been logged since the last clear
+	bool empty() const
+	{
+		return 0 == nextTicket.load(std::memory_order_acquire);
+	}
+
+	/// @brief Returns how many of the oldest messages were overwritten because the ring was full
+	std::size_t get_number_of_overwritten_messages() const
+	{
+		return static_cast<std::size_t>(get_first_ticket(nextTicket.load(std::memory_order_acquire)));
+	}
+
+	/// @brief Discards all messages. Must not be called while another thread is logging.
+	void clear()
 	{
-		logHistory.push_back({ level, text });
+		std::uint64_t endTicket = nextTicket.load(std::memory_order_relaxed);
+		std::size_t slotsUsed = static_cast<std::size_t>(std::min<std::uint64_t>(endTicket, numberOfSlots));
 
-		while (logHistory.size() > 50)
+		for (std::size_t i = 0; i < slotsUsed; i++)
 		{
-			logHistory.pop_front();
+			slots[i].sequence.store(0, std::memory_order_relaxed);
 		}
+		nextTicket.store(0, std::memory_order_release);
+	}
+
+private:
+	/// @brief One preallocated message. The sequence is the ticket of the last message written to it plus one.
+	struct Slot
+	{
+		std::atomic<std::uint64_t> sequence{ 0 };
+		isobus::CANStackLogger::LoggingLevel level = isobus::CANStackLogger::LoggingLevel::Info;
+		std::uint16_t length = 0;
+		char text[MAX_MESSAGE_LENGTH + 1] = { 0 };
+	};
+
+	std::uint64_t get_first_ticket(std::uint64_t endTicket) const
+	{
+		return (endTicket > numberOfSlots) ? (endTicket - numberOfSlots) : 0;
 	}
 
-	std::deque<LogInfo> logHistory;
+	std::unique_ptr<Slot[]> slots;
+	const std::size_t numberOfSlots;
+	std::atomic<std::uint64_t> nextTicket{ 0 };
+};
+
+/// @brief The sink installed into the CAN stack. It keeps no messages itself, and instead
+/// forwards them to whichever LogContext is active on the calling thread, so operations
+/// running on different threads never see each other's messages.
+class CustomLogger : public isobus::CANStackLogger
+{
+public:
+	void sink_CAN_stack_log(CANStackLogger::LoggingLevel level, const std::string &text) override
+	{
+		if (nullptr != activeContext)
+		{
+			activeContext->add_message(level, text);
+		}
+	}
+
+private:
+	friend class ScopedLogContext;
+
+	static inline thread_local LogContext *activeContext = nullptr;
+};
+
+/// @brief Routes everything logged on the current thread to a LogContext for as long as it exists
+class ScopedLogContext
+{
+public:
+	explicit ScopedLogContext(LogContext &context) :
+	  previousContext(CustomLogger::activeContext)
+	{
+		CustomLogger::activeContext = &context;
+	}
+
+	~ScopedLogContext()
+	{
+		CustomLogger::activeContext = previousContext;
+	}
+
+	ScopedLogContext(const ScopedLogContext &) = delete;
+	ScopedLogContext &operator=(const ScopedLogContext &) = delete;
+
+private:
+	LogContext *previousContext;
 };
 
-static CustomLogger logger;
+inline CustomLogger logger;
 
 #endif // LOG_SINK_HPP
@@ -0,0 +1,63 @@
+//================================================================================================
+/// @file mapped_file.hpp
+///
+/// @brief Defines a read-only memory mapping of a file, used to parse .iop files without copying them
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso and the Open-Agriculture developers
+//================================================================================================
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/// @brief Maps a whole file into memory read-only, so its bytes can be handed straight to a parser.
+/// @details The mapping is released when the object is destroyed or close() is called, after which
+/// any pointer returned by get_data() must no longer be used.
+class MappedFile
+{
+public:
+	MappedFile() = default;
+
+	/// @brief Maps a file, closing any file that was already mapped
+	/// @param[in] path The file to map
+	explicit MappedFile(const std::string &path);
+
+	~MappedFile();
+
+	MappedFile(const MappedFile &) = delete;
+	MappedFile &operator=(const MappedFile &) = delete;
+	MappedFile(MappedFile &&other) noexcept;
+	MappedFile &operator=(MappedFile &&other) noexcept;
+
+	/// @brief Maps a file, closing any file that was already mapped
+	/// @param[in] path The file to map
+	/// @returns true if the file was mapped, false if it could not be opened, is empty, or could not be mapped
+	bool open(const std::string &path);
+
+	/// @brief Releases the mapping
+	void close();
+
+	/// @brief Returns true if a file is currently mapped
+	bool is_open() const;
+
+	/// @brief Returns the mapped bytes, or nullptr if nothing is mapped
+	const std::uint8_t *get_data() const;
+
+	/// @brief Returns the size of the mapped file in bytes
+	std::size_t get_size() const;
+
+private:
+	void move_from(MappedFile &other);
+
+	const std::uint8_t *data = nullptr;
+	std::size_t size = 0;
+#ifdef _WIN32
+	void *fileHandle = nullptr;
+	void *mappingHandle = nullptr;
+#endif
+};
+
+#endif // MAPPED_FILE_HPP
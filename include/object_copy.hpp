@@ -0,0 +1,23 @@
+//================================================================================================
+/// @file object_copy.hpp
+///
+/// @brief Defines functions that copy DDOP objects from one object pool into another
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso and the Open-Agriculture developers
+//================================================================================================
+#ifndef OBJECT_COPY_HPP
+#define OBJECT_COPY_HPP
+
+#include "isobus/isobus/isobus_device_descriptor_object_pool.hpp"
+
+#include <memory>
+
+/// @brief Adds a copy of an object to a pool, through the pool's own add functions.
+/// The copy is appended to the end of the pool, and a device element keeps its child references.
+/// @param[in] pool The pool to add the copy to
+/// @param[in] object The object to copy
+/// @returns true if the copy was added, false if the pool rejected it (for example a duplicate ID)
+bool add_object_copy(isobus::DeviceDescriptorObjectPool &pool, const std::shared_ptr<isobus::task_controller_object::Object> &object);
+
+#endif // OBJECT_COPY_HPP
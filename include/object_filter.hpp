@@ -0,0 +1,97 @@
+//================================================================================================
+/// @file object_filter.hpp
+///
+/// @brief Defines the search filter of the object tree
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso and the Open-Agriculture developers
+//================================================================================================
+#ifndef OBJECT_FILTER_HPP
+#define OBJECT_FILTER_HPP
+
+#include "ddi_search_index.hpp"
+#include "object_pool_snapshot.hpp"
+#include "object_tree_index.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// @brief Parses a filter typed by the user and finds the objects that match it.
+/// @details A filter is a list of terms separated by spaces, and an object must match all of them.
+/// Double quotes keep spaces inside one term.
+/// - `type:dpd` matches objects by table ID, and `type:dpd,dpt` matches either
+/// - `ddi:119`, `ddi:0x77` or `ddi:100-200` match process data and properties by DDI number, and
+///   `ddi:"work state"` matches them by the name of their DDI in the data dictionary
+/// - `id:12` or `id:100-200` match object IDs
+/// - `under:12` matches the objects below object 12 in the tree
+/// - Any other text matches part of the designator, ignoring case
+///
+/// Matching scans the columns of an ObjectPoolSnapshot, so it is fast enough to run on every keystroke.
+/// The objects below the element of an `under:` term are the slowest part to find, since they come
+/// from the tree index, so they are kept until the element or the pool changes.
+class ObjectFilter
+{
+public:
+	/// @brief Parses a filter, replacing the previous one
+	/// @param[in] text The filter typed by the user
+	/// @returns true if every term could be understood. If not, the filter matches nothing.
+	bool parse(const std::string &text);
+
+	/// @brief Returns true if the filter has no terms, which means it matches everything
+	bool is_empty() const;
+
+	/// @brief Returns why the last parse failed, or an empty string if it succeeded
+	const std::string &get_error() const;
+
+	/// @brief Tells the filter that the pool was edited, so the objects below an element must be found again
+	void on_pool_edited();
+
+	/// @brief Finds every object that matches the filter
+	/// @param[in] snapshot The snapshot of the pool to search
+	/// @param[in] treeIndex The tree index of the same pool, used for `under:` terms
+	/// @param[in] ddiIndex The DDI index, used for DDI names. Built the first time a name is searched for.
+	/// @param[out] rows The snapshot rows of the matching objects, in ascending order
+	void apply(const ObjectPoolSnapshot &snapshot, const ObjectTreeIndex &treeIndex, DdiSearchIndex &ddiIndex, std::vector<std::uint32_t> &rows);
+
+private:
+	/// @brief What a term matches against
+	enum class TermType : std::uint8_t
+	{
+		Type,
+		DDI,
+		DDIName,
+		ObjectID,
+		Under,
+		Designator
+	};
+
+	/// @brief One parsed term of the filter
+	struct Term
+	{
+		TermType type = TermType::Designator;
+		std::uint16_t low = 0; ///< The first DDI or ID in the range, or the ID for Under
+		std::uint16_t high = 0; ///< The last DDI or ID in the range
+		std::uint8_t typeMask = 0; ///< One bit per ObjectTypes value, for Type
+		std::string text; ///< The lower case designator text, or the DDI name
+	};
+
+	static void split_terms(const std::string &text, std::vector<std::string> &terms);
+	static bool parse_number(const std::string &text, std::uint16_t &value);
+	static bool parse_range(const std::string &text, std::uint16_t &low, std::uint16_t &high);
+	static bool parse_types(const std::string &text, std::uint8_t &typeMask);
+
+	void mark_subtree(std::uint16_t objectID, const ObjectPoolSnapshot &snapshot, const ObjectTreeIndex &treeIndex);
+	void filter_rows(const Term &term, const ObjectPoolSnapshot &snapshot, std::vector<std::uint32_t> &rows) const;
+
+	std::vector<Term> terms;
+	std::string error;
+	std::vector<DdiSearchIndex::Match> ddiMatches; ///< The entries matching the name in the current DDIName term
+	std::vector<bool> markedDDIs; ///< The DDIs matching the name in the current DDIName term
+	std::vector<bool> subtreeIDs; ///< The objects below subtreeRootID, kept while the pool is unchanged
+	std::uint16_t subtreeRootID = 0;
+	bool isSubtreeValid = false;
+	bool parseFailed = false;
+};
+
+#endif // OBJECT_FILTER_HPP
@@ -0,0 +1,62 @@
+//================================================================================================
+/// @file object_id_allocator.hpp
+///
+/// @brief Defines a bitset of used object IDs that can find free IDs without probing the pool
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso and the Open-Agriculture developers
+//================================================================================================
+#ifndef OBJECT_ID_ALLOCATOR_HPP
+#define OBJECT_ID_ALLOCATOR_HPP
+
+#include "isobus/isobus/isobus_device_descriptor_object_pool.hpp"
+
+#include <array>
+#include <cstdint>
+
+/// @brief Tracks which of the 16 bit object IDs are in use by a pool.
+/// @details Each ID is one bit, and a second level bitmap marks which 64 bit words are
+/// completely full, so finding the lowest free ID is a fixed number of word scans no matter
+/// how dense the pool is. The NULL object ID (0xFFFF) is always reported as used.
+class ObjectIDAllocator
+{
+public:
+	ObjectIDAllocator();
+
+	/// @brief Marks every ID used by the pool, and frees all others
+	/// @param[in] pool The object pool to scan
+	void rebuild(isobus::DeviceDescriptorObjectPool &pool);
+
+	/// @brief Frees every ID except the NULL object ID
+	void clear();
+
+	/// @brief Marks an ID as used by an object in the pool
+	/// @param[in] objectID The ID to mark
+	void mark_used(std::uint16_t objectID);
+
+	/// @brief Marks an ID as no longer used by any object in the pool
+	/// @param[in] objectID The ID to free
+	void mark_unused(std::uint16_t objectID);
+
+	/// @brief Returns if an ID is in use
+	/// @param[in] objectID The ID to check
+	/// @returns true if an object in the pool uses the ID
+	bool is_used(std::uint16_t objectID) const;
+
+	/// @brief Returns the lowest ID that is not used by any object
+	/// @returns The lowest free ID, or the NULL object ID if the pool is full
+	std::uint16_t get_first_unused_id() const;
+
+private:
+	static constexpr std::size_t BITS_PER_WORD = 64;
+	static constexpr std::size_t NUMBER_OF_WORDS = 65536 / BITS_PER_WORD;
+	static constexpr std::size_t NUMBER_OF_SUMMARY_WORDS = NUMBER_OF_WORDS / BITS_PER_WORD;
+	static constexpr std::uint64_t FULL_WORD = 0xFFFFFFFFFFFFFFFFULL;
+
+	static std::uint32_t count_trailing_zeros(std::uint64_t value);
+
+	std::array<std::uint64_t, NUMBER_OF_WORDS> usedIDs; ///< One bit per object ID
+	std::array<std::uint64_t, NUMBER_OF_SUMMARY_WORDS> fullWords; ///< One bit per word of usedIDs that has no free IDs
+};
+
+#endif // OBJECT_ID_ALLOCATOR_HPP
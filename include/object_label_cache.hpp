@@ -0,0 +1,60 @@
+//================================================================================================
+/// @file object_label_cache.hpp
+///
+/// @brief Defines a cache of the display labels shown for each object in the GUI
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso and the Open-Agriculture developers
+//================================================================================================
+#ifndef OBJECT_LABEL_CACHE_HPP
+#define OBJECT_LABEL_CACHE_HPP
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+/// @brief Stores the labels the object tree shows for each object, keyed by object ID.
+/// @details Building a label involves data dictionary lookups and several string concatenations,
+/// so labels are built once and reused every frame. A label must be invalidated whenever
+/// anything it is built from changes, such as the object's designator, DDI, type, element number or ID.
+class ObjectLabelCache
+{
+public:
+	/// @brief The different labels that can be cached for one object
+	enum class LabelType : std::uint8_t
+	{
+		Name = 0, ///< The object's display name, table ID and object ID
+		Presentation, ///< The label used for a value presentation nested under the object that uses it
+		NumberOfLabelTypes
+	};
+
+	ObjectLabelCache() = default;
+
+	/// @brief Looks up a cached label
+	/// @param[in] objectID The ID of the object the label is for
+	/// @param[in] type The kind of label to get
+	/// @returns The cached label, or nullptr if it has not been built yet
+	const std::string *get(std::uint16_t objectID, LabelType type) const;
+
+	/// @brief Stores a label
+	/// @param[in] objectID The ID of the object the label is for
+	/// @param[in] type The kind of label being stored
+	/// @param[in] label The label to store
+	/// @returns The stored label
+	const std::string &set(std::uint16_t objectID, LabelType type, std::string label);
+
+	/// @brief Discards all labels of one object, so they get rebuilt the next time they are needed
+	/// @param[in] objectID The ID of the object whose labels are stale
+	void invalidate(std::uint16_t objectID);
+
+	/// @brief Discards every label
+	void clear();
+
+private:
+	using LabelSet = std::array<std::string, static_cast<std::size_t>(LabelType::NumberOfLabelTypes)>;
+
+	std::unordered_map<std::uint16_t, LabelSet> labels; ///< Labels by object ID. An empty string means not built yet.
+};
+
+#endif // OBJECT_LABEL_CACHE_HPP
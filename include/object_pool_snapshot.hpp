@@ -0,0 +1,125 @@
+//================================================================================================
+/// @file object_pool_snapshot.hpp
+///
+/// @brief Defines a compact, column oriented copy of the object pool for fast searching
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso and the Open-Agriculture developers
+//================================================================================================
+#ifndef OBJECT_POOL_SNAPSHOT_HPP
+#define OBJECT_POOL_SNAPSHOT_HPP
+
+#include "isobus/isobus/isobus_device_descriptor_object_pool.hpp"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/// @brief Keeps the fields that searches, filters and statistics look at in one contiguous array
+/// per field, one row per object in pool order.
+/// @details Scanning the pool itself means following a shared_ptr to a separate heap object for
+/// every row. Here, filtering by type or DDI is a linear scan over a few bytes per object, done
+/// 8 or 16 objects at a time with SSE2 where it's available. Designators are stored back to back
+/// in one string arena, next to a lower case copy for case insensitive searches.
+///
+/// Like ObjectTreeIndex, it mirrors the pool and must be told about every edit.
+class ObjectPoolSnapshot
+{
+public:
+	static constexpr std::uint16_t NULL_OBJECT_ID = 0xFFFF; ///< Used for a missing parent or presentation
+	static constexpr std::uint16_t NO_DDI = 0xFFFF; ///< Stored as the DDI of objects that have none
+	static constexpr std::uint32_t NO_ROW = 0xFFFFFFFF; ///< Returned by find_row for unknown object IDs
+
+	/// @brief Discards the snapshot and copies every object in the pool
+	/// @param[in] pool The object pool to copy
+	void rebuild(isobus::DeviceDescriptorObjectPool &pool);
+
+	/// @brief Empties the snapshot
+	void clear();
+
+	/// @brief Appends an object that was added to the end of the pool
+	/// @param[in] object The object that was added
+	void on_object_added(const isobus::task_controller_object::Object &object);
+
+	/// @brief Removes an object that was deleted from the pool
+	/// @param[in] objectID The ID of the deleted object
+	void on_object_removed(std::uint16_t objectID);
+
+	/// @brief Re-keys an object whose ID was changed
+	/// @param[in] oldID The object's previous ID
+	/// @param[in] newID The object's new ID
+	void on_object_id_changed(std::uint16_t oldID, std::uint16_t newID);
+
+	/// @brief Copies the designator, parent, DDI and presentation of an edited object again
+	/// @param[in] object The object that was edited
+	void on_object_changed(const isobus::task_controller_object::Object &object);
+
+	/// @brief Returns the number of rows, which is the number of objects in the pool
+	std::size_t size() const;
+
+	/// @brief Returns the row of an object
+	/// @param[in] objectID The ID to look up
+	/// @returns The row, or NO_ROW if there is no object with that ID
+	std::uint32_t find_row(std::uint16_t objectID) const;
+
+	/// @brief Returns the object ID in a row
+	std::uint16_t get_object_id(std::uint32_t row) const;
+
+	/// @brief Returns the object type in a row
+	isobus::task_controller_object::ObjectTypes get_type(std::uint32_t row) const;
+
+	/// @brief Returns the parent object ID of the element in a row, or NULL_OBJECT_ID for other types
+	std::uint16_t get_parent_id(std::uint32_t row) const;
+
+	/// @brief Returns true if the object in a row is process data or a property, which have a DDI
+	bool has_ddi(std::uint32_t row) const;
+
+	/// @brief Returns the DDI of the object in a row, or NO_DDI if has_ddi is false
+	std::uint16_t get_ddi(std::uint32_t row) const;
+
+	/// @brief Returns the value presentation ID of the object in a row, or NULL_OBJECT_ID if it has none
+	std::uint16_t get_presentation_id(std::uint32_t row) const;
+
+	/// @brief Returns the designator of the object in a row. Valid until the snapshot is next changed.
+	std::string_view get_designator(std::uint32_t row) const;
+
+	/// @brief Returns the designator of the object in a row in lower case, for case insensitive searching
+	std::string_view get_folded_designator(std::uint32_t row) const;
+
+	/// @brief Finds every object of one type
+	/// @param[in] type The type to look for
+	/// @param[out] rows The matching rows are appended to this, in ascending order
+	void select_type(isobus::task_controller_object::ObjectTypes type, std::vector<std::uint32_t> &rows) const;
+
+	/// @brief Finds every process data and property object with one DDI
+	/// @param[in] ddi The DDI to look for
+	/// @param[out] rows The matching rows are appended to this, in ascending order
+	void select_ddi(std::uint16_t ddi, std::vector<std::uint32_t> &rows) const;
+
+	/// @brief Returns the table ID (DVC, DET, DPD, DPT or DVP) of an object type
+	static const char *get_table_id(isobus::task_controller_object::ObjectTypes type);
+
+private:
+	void set_row(std::uint32_t row, const isobus::task_controller_object::Object &object);
+	void set_designator(std::uint32_t row, const std::string &designator);
+	void compact_designators();
+
+	static constexpr std::size_t MINIMUM_COMPACTION_SIZE = 4096; ///< Unused arena bytes below this are never worth compacting
+
+	// One entry per row, in pool order
+	std::vector<std::uint16_t> objectIDs;
+	std::vector<std::uint8_t> types;
+	std::vector<std::uint16_t> parentIDs;
+	std::vector<std::uint16_t> ddis;
+	std::vector<std::uint16_t> presentationIDs;
+	std::vector<std::uint32_t> designatorOffsets; ///< Where each designator starts in the arena
+	std::vector<std::uint16_t> designatorLengths;
+
+	std::vector<std::uint32_t> rowsByObjectID; ///< Row of every possible object ID, or NO_ROW
+	std::string designatorArena; ///< Every designator back to back, without terminators
+	std::string foldedDesignatorArena; ///< The same as designatorArena, in lower case
+	std::size_t unusedArenaBytes = 0; ///< Bytes of designators that were replaced or removed
+};
+
+#endif // OBJECT_POOL_SNAPSHOT_HPP
@@ -0,0 +1,96 @@
+//================================================================================================
+/// @file object_reference_index.hpp
+///
+/// @brief Defines an index from each object ID to the objects that refer to it, so that
+/// deleting an object only has to visit the objects that actually reference it.
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso and the Open-Agriculture developers
+//================================================================================================
+#ifndef OBJECT_REFERENCE_INDEX_HPP
+#define OBJECT_REFERENCE_INDEX_HPP
+
+#include "isobus/isobus/isobus_device_descriptor_object_pool.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+/// @brief Maps every referenced object ID to the objects that refer to it.
+/// @details References are child object lists of device elements, the parent object of device
+/// elements, and the value presentation of process data and properties. Referrers are stored by
+/// pointer, so they stay valid when the referrer's own ID changes. References are keyed by the ID
+/// that the referrer holds, exactly like in the pool, so a reference to an ID that was renumbered
+/// stays under the old ID. Like the tree index, it must be told about every edit to a reference.
+class ObjectReferenceIndex
+{
+public:
+	/// @brief The ways one object can refer to another
+	enum class ReferenceType : std::uint8_t
+	{
+		ChildObject, ///< A device element lists the object as one of its children
+		ParentObject, ///< A device element has the object as its parent
+		Presentation ///< A process data or property object uses the object as its value presentation
+	};
+
+	/// @brief One reference to an object
+	struct Reference
+	{
+		std::shared_ptr<isobus::task_controller_object::Object> referrer; ///< The object holding the reference
+		ReferenceType type; ///< How the referrer refers to the object
+	};
+
+	/// @brief Discards the index and rebuilds it from every object in the pool
+	/// @param[in] pool The object pool to index
+	void rebuild(isobus::DeviceDescriptorObjectPool &pool);
+
+	/// @brief Empties the index
+	void clear();
+
+	/// @brief Adds every reference held by a newly created object
+	/// @param[in] object The object that was added to the pool
+	void on_object_added(const std::shared_ptr<isobus::task_controller_object::Object> &object);
+
+	/// @brief Removes every reference held by an object that was deleted from the pool.
+	/// References to the deleted object are kept, since the referrers still hold its ID.
+	/// @param[in] object The object that was removed from the pool
+	void on_object_removed(const std::shared_ptr<isobus::task_controller_object::Object> &object);
+
+	/// @brief Records that a device element gained a child object reference
+	/// @param[in] element The element the reference was added to
+	/// @param[in] childID The ID of the child object
+	void on_child_reference_added(const std::shared_ptr<isobus::task_controller_object::Object> &element, std::uint16_t childID);
+
+	/// @brief Records that a device element lost one reference to a child object
+	/// @param[in] element The element the reference was removed from
+	/// @param[in] childID The ID of the child object
+	void on_child_reference_removed(const std::shared_ptr<isobus::task_controller_object::Object> &element, std::uint16_t childID);
+
+	/// @brief Records that a device element's parent object ID changed
+	/// @param[in] element The element that was re-parented
+	/// @param[in] oldParentID The element's previous parent object ID
+	/// @param[in] newParentID The element's new parent object ID
+	void on_parent_changed(const std::shared_ptr<isobus::task_controller_object::Object> &element, std::uint16_t oldParentID, std::uint16_t newParentID);
+
+	/// @brief Records that a process data or property object's presentation object ID changed
+	/// @param[in] object The object whose presentation changed
+	/// @param[in] oldPresentationID The previous presentation object ID
+	/// @param[in] newPresentationID The new presentation object ID
+	void on_presentation_changed(const std::shared_ptr<isobus::task_controller_object::Object> &object, std::uint16_t oldPresentationID, std::uint16_t newPresentationID);
+
+	/// @brief Returns every reference to an object ID
+	/// @param[in] objectID The referenced object ID
+	/// @returns The references to that ID (may be empty)
+	const std::vector<Reference> &get_references_to(std::uint16_t objectID) const;
+
+private:
+	void add_reference(std::uint16_t objectID, const std::shared_ptr<isobus::task_controller_object::Object> &referrer, ReferenceType type);
+	void remove_reference(std::uint16_t objectID, const std::shared_ptr<isobus::task_controller_object::Object> &referrer, ReferenceType type);
+
+	static const std::vector<Reference> EMPTY_REFERENCE_LIST; ///< Returned when an object is not referenced
+
+	std::unordered_map<std::uint16_t, std::vector<Reference>> referencesByObjectID;
+};
+
+#endif // OBJECT_REFERENCE_INDEX_HPP
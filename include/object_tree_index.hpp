@@ -0,0 +1,85 @@
+//================================================================================================
+/// @file object_tree_index.hpp
+///
+/// @brief Defines an index of the parent/child relationships in a DDOP so that the object
+/// tree can be walked without scanning the whole pool for every expanded element.
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso and the Open-Agriculture developers
+//================================================================================================
+#ifndef OBJECT_TREE_INDEX_HPP
+#define OBJECT_TREE_INDEX_HPP
+
+#include "isobus/isobus/isobus_device_descriptor_object_pool.hpp"
+#include "object_view.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+/// @brief Maps object IDs to objects, and parent object IDs to the device elements that
+/// refer to them as their parent. It mirrors the pool and must be told about every edit
+/// that adds, removes, re-parents or re-numbers an object.
+class ObjectTreeIndex
+{
+public:
+	/// @brief Discards the index and rebuilds it from every object in the pool
+	/// @param[in] pool The object pool to index
+	void rebuild(isobus::DeviceDescriptorObjectPool &pool);
+
+	/// @brief Empties the index
+	void clear();
+
+	/// @brief Adds a newly created object to the index
+	/// @param[in] object The object that was added to the pool
+	void on_object_added(std::shared_ptr<isobus::task_controller_object::Object> object);
+
+	/// @brief Removes an object that was deleted from the pool
+	/// @param[in] objectID The ID of the deleted object
+	void on_object_removed(std::uint16_t objectID);
+
+	/// @brief Moves an element from one parent's child list to another
+	/// @param[in] elementID The ID of the device element that was re-parented
+	/// @param[in] oldParentID The element's previous parent object ID
+	/// @param[in] newParentID The element's new parent object ID
+	void on_parent_changed(std::uint16_t elementID, std::uint16_t oldParentID, std::uint16_t newParentID);
+
+	/// @brief Re-keys an object whose ID was changed
+	/// @param[in] oldID The object's previous ID
+	/// @param[in] newID The object's new ID
+	void on_object_id_changed(std::uint16_t oldID, std::uint16_t newID);
+
+	/// @brief Looks up an object by its ID
+	/// @param[in] objectID The ID to look up
+	/// @returns The object, or nullptr if no object has that ID
+	std::shared_ptr<isobus::task_controller_object::Object> get_object(std::uint16_t objectID) const;
+
+	/// @brief Looks up an object by its ID without copying its shared_ptr, for code that runs every frame
+	/// @param[in] objectID The ID to look up
+	/// @returns A view of the object, which is empty if no object has that ID
+	ObjectView get_object_view(std::uint16_t objectID) const;
+
+	/// @brief Returns the device object of the pool, if there is one
+	/// @returns The device object, or nullptr if the pool has none
+	const std::shared_ptr<isobus::task_controller_object::DeviceObject> &get_device() const;
+
+	/// @brief Returns the device elements that refer to an object as their parent, in pool order
+	/// @param[in] parentID The object ID of the parent
+	/// @returns The child elements of the parent (may be empty)
+	const std::vector<std::shared_ptr<isobus::task_controller_object::DeviceElementObject>> &get_child_elements(std::uint16_t parentID) const;
+
+private:
+	using ElementList = std::vector<std::shared_ptr<isobus::task_controller_object::DeviceElementObject>>;
+
+	void add_child_element(std::uint16_t parentID, std::shared_ptr<isobus::task_controller_object::DeviceElementObject> element);
+	void remove_child_element(std::uint16_t parentID, const std::shared_ptr<isobus::task_controller_object::DeviceElementObject> &element);
+
+	static const ElementList EMPTY_ELEMENT_LIST; ///< Returned when an object has no child elements
+
+	std::unordered_map<std::uint16_t, std::shared_ptr<isobus::task_controller_object::Object>> objectsByID;
+	std::unordered_map<std::uint16_t, ElementList> childElementsByParentID;
+	std::shared_ptr<isobus::task_controller_object::DeviceObject> device;
+};
+
+#endif // OBJECT_TREE_INDEX_HPP
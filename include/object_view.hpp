@@ -0,0 +1,119 @@
+//================================================================================================
+/// @file object_view.hpp
+///
+/// @brief Defines a non-owning, type-tagged view of a DDOP object, so that code which runs every
+/// frame can get at the concrete object type without RTTI casts or shared pointer copies.
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso and the Open-Agriculture developers
+//================================================================================================
+#ifndef OBJECT_VIEW_HPP
+#define OBJECT_VIEW_HPP
+
+#include "isobus/isobus/isobus_task_controller_client_objects.hpp"
+
+#include <memory>
+
+/// @brief A borrowed pointer to a DDOP object, plus the object's type read once when the view is made.
+/// @details The typed accessors check the cached type and then use a static_cast, which replaces
+/// a dynamic_pointer_cast and the reference count traffic of copying a shared_ptr. A view does not
+/// keep its object alive, so it must not outlive the pool or index entry it was taken from.
+class ObjectView
+{
+public:
+	ObjectView() = default;
+
+	/// @brief Makes a view of an object
+	/// @param[in] object The object to view, or nullptr for an empty view
+	ObjectView(isobus::task_controller_object::Object *object) :
+	  object(object),
+	  type((nullptr != object) ? object->get_object_type() : isobus::task_controller_object::ObjectTypes::Device)
+	{
+	}
+
+	/// @brief Makes a view of an object held by a shared_ptr, without taking a reference to it
+	/// @param[in] object The object to view, or nullptr for an empty view
+	template<typename T>
+	ObjectView(const std::shared_ptr<T> &object) :
+	  ObjectView(static_cast<isobus::task_controller_object::Object *>(object.get()))
+	{
+	}
+
+	/// @brief Returns true if the view refers to an object
+	bool is_valid() const
+	{
+		return nullptr != object;
+	}
+
+	/// @brief Returns true if the view refers to an object
+	explicit operator bool() const
+	{
+		return is_valid();
+	}
+
+	/// @brief Returns the type of the viewed object. Only meaningful if the view is valid.
+	isobus::task_controller_object::ObjectTypes get_type() const
+	{
+		return type;
+	}
+
+	/// @brief Returns the viewed object, or nullptr if the view is empty
+	isobus::task_controller_object::Object *get() const
+	{
+		return object;
+	}
+
+	/// @brief Returns the viewed object
+	isobus::task_controller_object::Object *operator->() const
+	{
+		return object;
+	}
+
+	/// @brief Returns the object as a device, or nullptr if it is not one
+	isobus::task_controller_object::DeviceObject *as_device() const
+	{
+		return as<isobus::task_controller_object::DeviceObject, isobus::task_controller_object::ObjectTypes::Device>();
+	}
+
+	/// @brief Returns the object as a device element, or nullptr if it is not one
+	isobus::task_controller_object::DeviceElementObject *as_element() const
+	{
+		return as<isobus::task_controller_object::DeviceElementObject, isobus::task_controller_object::ObjectTypes::DeviceElement>();
+	}
+
+	/// @brief Returns the object as a device process data object, or nullptr if it is not one
+	isobus::task_controller_object::DeviceProcessDataObject *as_process_data() const
+	{
+		return as<isobus::task_controller_object::DeviceProcessDataObject, isobus::task_controller_object::ObjectTypes::DeviceProcessData>();
+	}
+
+	/// @brief Returns the object as a device property, or nullptr if it is not one
+	isobus::task_controller_object::DevicePropertyObject *as_property() const
+	{
+		return as<isobus::task_controller_object::DevicePropertyObject, isobus::task_controller_object::ObjectTypes::DeviceProperty>();
+	}
+
+	/// @brief Returns the object as a device value presentation, or nullptr if it is not one
+	isobus::task_controller_object::DeviceValuePresentationObject *as_presentation() const
+	{
+		return as<isobus::task_controller_object::DeviceValuePresentationObject, isobus::task_controller_object::ObjectTypes::DeviceValuePresentation>();
+	}
+
+private:
+	template<typename T, isobus::task_controller_object::ObjectTypes TYPE>
+	T *as() const
+	{
+		T *retVal = nullptr;
+
+		if ((nullptr != object) && (TYPE == type))
+		{
+			retVal = static_cast<T *>(object);
+		}
+		return retVal;
+	}
+
+	isobus::task_controller_object::Object *object = nullptr; ///< The viewed object, not owned
+	isobus::task_controller_object::ObjectTypes type = isobus::task_controller_object::ObjectTypes::Device; ///< The object's type, read once
+};
+
+#endif // OBJECT_VIEW_HPP
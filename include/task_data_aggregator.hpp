@@ -0,0 +1,58 @@
+//================================================================================================
+/// @file task_data_aggregator.hpp
+///
+/// @brief Defines an exporter that merges many DDOP files into a single TASKDATA.XML
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso and the Open-Agriculture developers
+//================================================================================================
+#ifndef TASK_DATA_AGGREGATOR_HPP
+#define TASK_DATA_AGGREGATOR_HPP
+
+#include "logsink.hpp"
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/// @brief Loads a list of .iop files across a work stealing thread pool and streams every device
+/// into one TASKDATA, in the order the files were given.
+/// @details Files are loaded a window at a time, and each window is written out and freed before
+/// the next one is loaded, so memory use depends on the number of threads and not on the size of
+/// the fleet. DVC and DET IDs are numbered across the whole TASKDATA so they never collide.
+class TaskDataAggregator
+{
+public:
+	/// @brief The outcome of adding one file to the TASKDATA
+	struct Result
+	{
+		std::string filePath;
+		std::vector<LogContext::LogInfo> diagnostics;
+		std::size_t numberOfObjects = 0;
+		bool fileRead = false;
+		bool deserialized = false;
+		bool written = false;
+
+		bool passed() const;
+	};
+
+	/// @brief Constructor for the aggregator
+	/// @param[in] taskControllerVersion The TC version used to parse the DDOPs and written to the TASKDATA
+	/// @param[in] numberOfThreads The number of workers, or 0 to use one per hardware thread
+	TaskDataAggregator(std::uint8_t taskControllerVersion, std::size_t numberOfThreads);
+
+	/// @brief Writes one TASKDATA containing the device of every file that could be loaded
+	/// @param[in] filePaths The files to merge
+	/// @param[in] output The stream to write the TASKDATA to
+	/// @returns One result per file, in the same order as the files
+	std::vector<Result> aggregate(const std::vector<std::string> &filePaths, std::ostream &output) const;
+
+private:
+	static constexpr std::size_t FILES_PER_THREAD = 4; ///< How many files each worker loads per window
+
+	std::size_t numberOfThreads;
+	std::uint8_t taskControllerVersion;
+};
+
+#endif // TASK_DATA_AGGREGATOR_HPP
@@ -0,0 +1,92 @@
+//================================================================================================
+/// @file validation_cache.hpp
+///
+/// @brief Defines an on-disk cache of validation results, keyed by the content of the DDOP
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso and the Open-Agriculture developers
+//================================================================================================
+#ifndef VALIDATION_CACHE_HPP
+#define VALIDATION_CACHE_HPP
+
+#include "logsink.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// @brief Remembers the outcome of validating a DDOP, so identical pools shared by many files
+/// are only deserialized and re-serialized once.
+/// @details Each result is stored in its own file, named after a 64 bit XXH64 hash of the raw
+/// .iop bytes. The hash is seeded with the TC version, the AgIsoStack++ version the tool was
+/// built against and the cache format, so changing any of them never returns a stale result.
+/// Entries are written to a temporary file and renamed into place, which lets any number of
+/// threads or processes share one cache directory: readers see either a whole entry or none.
+/// The AgIsoStack++ version comes from a header the build generates, see cmake/AgIsoStackVersion.cmake.
+class ValidationCache
+{
+public:
+	/// @brief A cached validation outcome
+	struct Entry
+	{
+		std::vector<LogContext::LogInfo> diagnostics;
+		std::size_t numberOfObjects = 0;
+		bool deserialized = false;
+		bool serialized = false;
+	};
+
+	/// @brief Constructor for the cache
+	/// @param[in] directory The directory the entries are stored in. It is created if needed.
+	explicit ValidationCache(const std::string &directory);
+
+	/// @brief Returns true if the AgIsoStack++ version was known at build time.
+	/// Without it a library update couldn't be told apart, so the cache must not be used.
+	static bool is_supported();
+
+	/// @brief Returns the cache key of a DDOP
+	/// @param[in] data The raw .iop bytes
+	/// @param[in] size The number of bytes
+	/// @param[in] taskControllerVersion The TC version the DDOP is parsed with
+	/// @returns The key to pass to find() and store()
+	static std::uint64_t get_key(const std::uint8_t *data, std::size_t size, std::uint8_t taskControllerVersion);
+
+	/// @brief Looks up a cached result. Safe to call from several threads at once.
+	/// @param[in] key The key returned by get_key()
+	/// @param[in] size The size of the DDOP, checked against the entry as a guard against collisions
+	/// @param[out] entry The cached result, if one was found
+	/// @returns true if the result was cached
+	bool find(std::uint64_t key, std::size_t size, Entry &entry);
+
+	/// @brief Stores a result. Safe to call from several threads or processes at once.
+	/// @param[in] key The key returned by get_key()
+	/// @param[in] size The size of the DDOP
+	/// @param[in] entry The result to store
+	/// @returns true if the entry was written
+	bool store(std::uint64_t key, std::size_t size, const Entry &entry);
+
+	/// @brief Returns the number of lookups that found a cached result
+	std::size_t get_number_of_hits() const;
+
+	/// @brief Returns the number of lookups that didn't
+	std::size_t get_number_of_misses() const;
+
+	/// @brief Hashes a block of memory with XXH64
+	/// @param[in] data The bytes to hash
+	/// @param[in] size The number of bytes
+	/// @param[in] seed The seed of the hash
+	/// @returns The 64 bit hash
+	static std::uint64_t hash(const std::uint8_t *data, std::size_t size, std::uint64_t seed);
+
+private:
+	static constexpr std::uint8_t FORMAT_VERSION = 1;
+
+	std::string get_entry_path(std::uint64_t key) const;
+
+	std::string directory;
+	std::atomic<std::size_t> numberOfHits{ 0 };
+	std::atomic<std::size_t> numberOfMisses{ 0 };
+	std::atomic<std::uint32_t> nextTemporaryFile{ 0 };
+};
+
+#endif // VALIDATION_CACHE_HPP
@@ -0,0 +1,54 @@
+//================================================================================================
+/// @file work_stealing_pool.hpp
+///
+/// @brief Defines a small thread pool that spreads a batch of independent tasks across
+/// worker threads, letting idle workers steal tasks from busy ones.
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso and the Open-Agriculture developers
+//================================================================================================
+#ifndef WORK_STEALING_POOL_HPP
+#define WORK_STEALING_POOL_HPP
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class WorkStealingPool
+{
+public:
+	/// @brief The function run for each task, with the index of the task and of the worker running it
+	using Task = std::function<void(std::size_t taskIndex, std::size_t workerIndex)>;
+
+	/// @brief Constructor for the pool
+	/// @param[in] numberOfThreads The number of workers, or 0 to use one per hardware thread
+	explicit WorkStealingPool(std::size_t numberOfThreads = 0);
+
+	/// @brief Returns the number of workers, which is also the upper bound of workerIndex
+	/// @returns The number of worker threads
+	std::size_t get_number_of_threads() const;
+
+	/// @brief Runs a task once for each index in [0, numberOfTasks) and waits for all of them.
+	/// @details Tasks are handed out to workers in contiguous blocks. A worker that runs out of
+	/// its own tasks steals from the back of another worker's queue.
+	/// @param[in] numberOfTasks The number of tasks to run
+	/// @param[in] task The function to run for each task
+	void run(std::size_t numberOfTasks, const Task &task);
+
+private:
+	struct WorkQueue
+	{
+		std::mutex mutex;
+		std::deque<std::size_t> tasks;
+	};
+
+	bool pop_task(std::size_t workerIndex, std::size_t &taskIndex);
+	bool steal_task(std::size_t thiefIndex, std::size_t &taskIndex);
+
+	std::vector<std::unique_ptr<WorkQueue>> queues;
+};
+
+#endif // WORK_STEALING_POOL_HPP
@@ -0,0 +1,256 @@
+//================================================================================================
+/// @file background_validator.cpp
+///
+/// @brief Implements a validator that checks a copy of the DDOP on a worker thread
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso and the Open-Agriculture developers
+//================================================================================================
+#include "background_validator.hpp"
+
+#include <cctype>
+#include <cstring>
+#include <limits>
+
+const std::vector<BackgroundValidator::Issue> BackgroundValidator::EMPTY_ISSUE_LIST;
+
+BackgroundValidator::BackgroundValidator(std::chrono::milliseconds debounceDelay) :
+  debounceDelay(debounceDelay)
+{
+	worker = std::thread(&BackgroundValidator::worker_thread, this);
+}
+
+BackgroundValidator::~BackgroundValidator()
+{
+	{
+		std::lock_guard<std::mutex> lock(jobMutex);
+		stopWorker = true;
+		currentGeneration++;
+	}
+	jobCondition.notify_one();
+	worker.join();
+}
+
+void BackgroundValidator::on_pool_edited()
+{
+	// Bumping the generation is what cancels the worker, it checks it between steps
+	currentGeneration++;
+	lastEditTime = Clock::now();
+	editPending = true;
+}
+
+void BackgroundValidator::clear()
+{
+	currentGeneration++;
+	editPending = false;
+	resultAvailable = false;
+	lastResultSerialized = false;
+	issues.clear();
+	issuesByObjectID.clear();
+
+	std::lock_guard<std::mutex> lock(jobMutex);
+	queuedJob.reset();
+	finishedResult.reset();
+}
+
+bool BackgroundValidator::update(isobus::DeviceDescriptorObjectPool &pool)
+{
+	bool retVal = false;
+
+	if (editPending && ((Clock::now() - lastEditTime) >= debounceDelay))
+	{
+		auto job = std::make_unique<Job>();
+		job->taskControllerVersion = pool.get_task_controller_compatibility_level();
+		job->generation = currentGeneration;
+
+		// One pass over the objects, deserializing and checking the snapshot happens on the worker
+		for (std::uint32_t i = 0; i < pool.size(); i++)
+		{
+			const auto binaryObject = pool.get_object_by_index(i)->get_binary_object();
+			job->binaryPool.insert(job->binaryPool.end(), binaryObject.begin(), binaryObject.end());
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(jobMutex);
+			queuedJob = std::move(job);
+		}
+		jobCondition.notify_one();
+		submittedGeneration = currentGeneration;
+		editPending = false;
+	}
+
+	std::unique_ptr<Result> result;
+	{
+		std::lock_guard<std::mutex> lock(jobMutex);
+
+		if ((nullptr != finishedResult) && (finishedGeneration == currentGeneration))
+		{
+			result = std::move(finishedResult);
+		}
+		finishedResult.reset();
+	}
+
+	if (nullptr != result)
+	{
+		issues = std::move(result->issues);
+		issuesByObjectID.clear();
+
+		for (const auto &issue : issues)
+		{
+			if (isobus::task_controller_object::Object::NULL_OBJECT_ID != issue.objectID)
+			{
+				issuesByObjectID[issue.objectID].push_back(issue);
+			}
+		}
+		lastResultSerialized = result->serialized;
+		resultAvailable = true;
+		retVal = true;
+	}
+	return retVal;
+}
+
+bool BackgroundValidator::is_busy() const
+{
+	bool retVal = editPending;
+
+	if (!retVal)
+	{
+		std::lock_guard<std::mutex> lock(jobMutex);
+		retVal = (submittedGeneration == currentGeneration) && ((finishedGeneration != submittedGeneration) || (nullptr != finishedResult));
+	}
+	return retVal;
+}
+
+bool BackgroundValidator::has_result() const
+{
+	return resultAvailable;
+}
+
+bool BackgroundValidator::is_pool_valid() const
+{
+	return lastResultSerialized;
+}
+
+const std::vector<BackgroundValidator::Issue> &BackgroundValidator::get_issues() const
+{
+	return issues;
+}
+
+const std::vector<BackgroundValidator::Issue> &BackgroundValidator::get_object_issues(std::uint16_t objectID) const
+{
+	auto objectIssues = issuesByObjectID.find(objectID);
+
+	if (issuesByObjectID.end() != objectIssues)
+	{
+		return objectIssues->second;
+	}
+	return EMPTY_ISSUE_LIST;
+}
+
+void BackgroundValidator::worker_thread()
+{
+	LogContext validationLog;
+	isobus::DeviceDescriptorObjectPool pool;
+	std::vector<bool> objectIDs;
+
+	while (true)
+	{
+		std::unique_ptr<Job> job;
+		{
+			std::unique_lock<std::mutex> lock(jobMutex);
+			jobCondition.wait(lock, [this]() { return stopWorker || (nullptr != queuedJob); });
+
+			if (stopWorker)
+			{
+				break;
+			}
+			job = std::move(queuedJob);
+		}
+
+		validationLog.clear();
+		Result result;
+		{
+			ScopedLogContext logScope(validationLog);
+			result.serialized = validate(*job, pool);
+		}
+
+		if (!is_cancelled(job->generation))
+		{
+			objectIDs.assign(static_cast<std::size_t>(std::numeric_limits<std::uint16_t>::max()) + 1, false);
+
+			for (std::uint32_t i = 0; i < pool.size(); i++)
+			{
+				objectIDs[pool.get_object_by_index(i)->get_object_id()] = true;
+			}
+
+			validationLog.for_each_message([&result, &objectIDs](isobus::CANStackLogger::LoggingLevel level, const char *text) {
+				result.issues.push_back({ find_object_id(text, objectIDs), level, text });
+			});
+
+			std::lock_guard<std::mutex> lock(jobMutex);
+			finishedResult = std::make_unique<Result>(std::move(result));
+			finishedGeneration = job->generation;
+		}
+	}
+}
+
+bool BackgroundValidator::is_cancelled(std::uint64_t jobGeneration) const
+{
+	return jobGeneration != currentGeneration.load();
+}
+
+bool BackgroundValidator::validate(const Job &job, isobus::DeviceDescriptorObjectPool &pool)
+{
+	bool retVal = false;
+
+	pool.clear();
+	pool.set_task_controller_compatibility_level(job.taskControllerVersion);
+
+	if ((!job.binaryPool.empty()) &&
+	    pool.deserialize_binary_object_pool(job.binaryPool.data(), static_cast<std::uint32_t>(job.binaryPool.size()), isobus::NAME(0)) &&
+	    (!is_cancelled(job.generation)))
+	{
+		std::vector<std::uint8_t> binaryDDOP;
+		retVal = pool.generate_binary_object_pool(binaryDDOP);
+	}
+	return retVal;
+}
+
+std::uint16_t BackgroundValidator::find_object_id(const std::string &message, const std::vector<bool> &objectIDs)
+{
+	// The library names objects as "object 12" or "object ID 12", so take the first such number that is in the pool
+	std::uint16_t retVal = isobus::task_controller_object::Object::NULL_OBJECT_ID;
+	std::string lowerMessage = message;
+	std::size_t position = 0;
+
+	for (auto &character : lowerMessage)
+	{
+		character = static_cast<char>(std::tolower(static_cast<unsigned char>(character)));
+	}
+
+	while ((isobus::task_controller_object::Object::NULL_OBJECT_ID == retVal) && (std::string::npos != (position = lowerMessage.find("object ", position))))
+	{
+		position += std::strlen("object ");
+
+		if (0 == lowerMessage.compare(position, std::strlen("id "), "id "))
+		{
+			position += std::strlen("id ");
+		}
+
+		std::uint32_t objectID = 0;
+		std::size_t numberOfDigits = 0;
+
+		while ((position < lowerMessage.size()) && (0 != std::isdigit(static_cast<unsigned char>(lowerMessage[position]))) && (objectID < objectIDs.size()))
+		{
+			objectID = (objectID * 10) + static_cast<std::uint32_t>(lowerMessage[position] - '0');
+			numberOfDigits++;
+			position++;
+		}
+
+		if ((numberOfDigits > 0) && (objectID < objectIDs.size()) && objectIDs[objectID])
+		{
+			retVal = static_cast<std::uint16_t>(objectID);
+		}
+	}
+	return retVal;
+}
@@ -0,0 +1,174 @@
+//================================================================================================
+/// @file batch_validator.cpp
+///
+/// @brief Implements a validator that checks many DDOP files in parallel
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso and the Open-Agriculture developers
+//================================================================================================
+#include "batch_validator.hpp"
+#include "isobus/isobus/isobus_device_descriptor_object_pool.hpp"
+#include "json_writer.hpp"
+#include "mapped_file.hpp"
+#include "work_stealing_pool.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+namespace
+{
+	const char *get_log_level_string(isobus::CANStackLogger::LoggingLevel level)
+	{
+		switch (level)
+		{
+			case isobus::CANStackLogger::LoggingLevel::Debug:
+				return "debug";
+			case isobus::CANStackLogger::LoggingLevel::Info:
+				return "info";
+			case isobus::CANStackLogger::LoggingLevel::Warning:
+				return "warning";
+			case isobus::CANStackLogger::LoggingLevel::Error:
+				return "error";
+			case isobus::CANStackLogger::LoggingLevel::Critical:
+				return "critical";
+		}
+		return "unknown";
+	}
+}
+
+bool BatchValidator::Result::passed() const
+{
+	return fileRead && deserialized && serialized;
+}
+
+BatchValidator::BatchValidator(std::uint8_t taskControllerVersion, std::size_t numberOfThreads, ValidationCache *cache) :
+  cache(cache),
+  numberOfThreads(numberOfThreads),
+  taskControllerVersion(taskControllerVersion)
+{
+}
+
+std::vector<BatchValidator::Result> BatchValidator::validate(const std::vector<std::string> &filePaths) const
+{
+	std::vector<Result> results(filePaths.size());
+	WorkStealingPool threadPool(numberOfThreads);
+	std::vector<std::unique_ptr<isobus::DeviceDescriptorObjectPool>> workerPools;
+	std::vector<std::unique_ptr<LogContext>> workerLogs;
+
+	for (std::size_t i = 0; i < threadPool.get_number_of_threads(); i++)
+	{
+		workerPools.push_back(std::make_unique<isobus::DeviceDescriptorObjectPool>());
+		workerLogs.push_back(std::make_unique<LogContext>());
+	}
+
+	threadPool.run(filePaths.size(), [&](std::size_t fileIndex, std::size_t workerIndex) {
+		auto startTime = std::chrono::steady_clock::now();
+		auto &result = results[fileIndex];
+		auto &objectPool = *workerPools[workerIndex];
+		auto &fileLog = *workerLogs[workerIndex];
+		fileLog.clear();
+		ScopedLogContext logScope(fileLog);
+
+		result.filePath = filePaths[fileIndex];
+		MappedFile iopFile(result.filePath);
+		result.fileSize = iopFile.get_size();
+		result.fileRead = iopFile.is_open() && (iopFile.get_size() <= UINT32_MAX);
+
+		std::uint64_t cacheKey = 0;
+		ValidationCache::Entry cacheEntry;
+
+		if (result.fileRead && (nullptr != cache))
+		{
+			cacheKey = ValidationCache::get_key(iopFile.get_data(), iopFile.get_size(), taskControllerVersion);
+			result.cached = cache->find(cacheKey, iopFile.get_size(), cacheEntry);
+		}
+
+		if (result.cached)
+		{
+			result.deserialized = cacheEntry.deserialized;
+			result.serialized = cacheEntry.serialized;
+			result.numberOfObjects = cacheEntry.numberOfObjects;
+			result.diagnostics = std::move(cacheEntry.diagnostics);
+		}
+		else if (result.fileRead)
+		{
+			objectPool.clear();
+			objectPool.set_task_controller_compatibility_level(taskControllerVersion);
+			result.deserialized = objectPool.deserialize_binary_object_pool(iopFile.get_data(), static_cast<std::uint32_t>(iopFile.get_size()), isobus::NAME(0));
+			result.numberOfObjects = objectPool.size();
+			iopFile.close();
+
+			if (result.deserialized)
+			{
+				std::vector<std::uint8_t> binaryDDOP;
+				result.serialized = objectPool.generate_binary_object_pool(binaryDDOP);
+			}
+			result.diagnostics = fileLog.get_messages();
+
+			if (nullptr != cache)
+			{
+				cacheEntry.deserialized = result.deserialized;
+				cacheEntry.serialized = result.serialized;
+				cacheEntry.numberOfObjects = result.numberOfObjects;
+				cacheEntry.diagnostics = result.diagnostics;
+				cache->store(cacheKey, result.fileSize, cacheEntry);
+			}
+		}
+		else
+		{
+			result.diagnostics = fileLog.get_messages();
+		}
+		result.durationMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+	});
+	return results;
+}
+
+void BatchValidator::write_json_report(const std::vector<Result> &results, std::ostream &output) const
+{
+	JsonWriter json(output);
+	std::size_t numberPassed = 0;
+
+	for (const auto &result : results)
+	{
+		if (result.passed())
+		{
+			numberPassed++;
+		}
+	}
+
+	json.begin_object();
+	json.write("taskControllerVersion", taskControllerVersion);
+	json.write("filesChecked", results.size());
+	json.write("filesPassed", numberPassed);
+	json.write("filesFailed", results.size() - numberPassed);
+	json.begin_array("results");
+
+	for (const auto &result : results)
+	{
+		json.begin_object();
+		json.write("file", result.filePath);
+		json.write("passed", result.passed());
+		json.write("fileRead", result.fileRead);
+		json.write("deserialized", result.deserialized);
+		json.write("serialized", result.serialized);
+		json.write("cached", result.cached);
+		json.write("fileSize", result.fileSize);
+		json.write("objects", result.numberOfObjects);
+		json.write("durationMs", result.durationMilliseconds);
+		json.begin_array("diagnostics");
+
+		for (const auto &diagnostic : result.diagnostics)
+		{
+			json.begin_object();
+			json.write("level", get_log_level_string(diagnostic.logLevel));
+			json.write("message", diagnostic.logText);
+			json.end_object();
+		}
+		json.end_array();
+		json.end_object();
+	}
+	json.end_array();
+	json.end_object();
+	output << '\n';
+}
@@ -0,0 +1,841 @@
+//================================================================================================
+/// @file cli.cpp
+///
+/// @brief Implements the headless command line front end
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso and the Open-Agriculture developers
+//================================================================================================
+#include "cli.hpp"
+#include "batch_validator.hpp"
+#include "ddop_diff.hpp"
+#include "isobus/isobus/isobus_device_descriptor_object_pool.hpp"
+#include "iso_xml_writer.hpp"
+#include "json_writer.hpp"
+#include "logsink.hpp"
+#include "mapped_file.hpp"
+#include "task_data_aggregator.hpp"
+#include "validation_cache.hpp"
+#include "work_stealing_pool.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <set>
+
+namespace
+{
+	/// @brief The comparison of one old and new file
+	struct DiffResult
+	{
+		std::string oldFilePath; ///< Empty if the file only exists in the new directory
+		std::string newFilePath; ///< Empty if the file only exists in the old directory
+		std::vector<DdopDiff::ObjectChange> changes;
+		std::vector<LogContext::LogInfo> diagnostics;
+		bool loaded = false;
+	};
+}
+
+int DDOPCommandLine::run(int argumentCount, char *argumentValues[])
+{
+	if (!parse_arguments(argumentCount, argumentValues))
+	{
+		print_usage((argumentCount > 0) ? argumentValues[0] : "AgIsoDDOPGeneratorCLI");
+		return EXIT_CODE_USAGE;
+	}
+
+	isobus::CANStackLogger::set_can_stack_logger_sink(&logger);
+
+	if (Command::Validate == command)
+	{
+		return run_validation();
+	}
+	else if (Command::Aggregate == command)
+	{
+		return run_aggregation();
+	}
+	else if (Command::Diff == command)
+	{
+		return run_diff();
+	}
+	else if (Command::Merge == command)
+	{
+		return run_merge();
+	}
+
+	std::size_t numberOfFailures = 0;
+	std::set<std::string> outputPaths;
+
+	for (std::size_t i = 0; i < inputFiles.size(); i++)
+	{
+		const std::string outputPath = get_output_path(outputNames[i], (Command::Export == command) ? ".XML" : ".iop");
+		std::string outputKey = std::filesystem::path(outputPath).lexically_normal().generic_string();
+
+		// Compare without case, so two inputs never share an output on case insensitive file systems either
+		std::transform(outputKey.begin(), outputKey.end(), outputKey.begin(), [](unsigned char character) { return static_cast<char>(std::tolower(character)); });
+
+		if (!outputPaths.insert(outputKey).second)
+		{
+			std::fprintf(stderr, "FAIL %s: %s is already written for another input file\n", inputFiles[i].c_str(), outputPath.c_str());
+			numberOfFailures++;
+		}
+		else if (!process_file(inputFiles[i], outputPath))
+		{
+			numberOfFailures++;
+		}
+	}
+
+	if (!quiet)
+	{
+		std::printf("%zu of %zu files processed successfully\n", inputFiles.size() - numberOfFailures, inputFiles.size());
+	}
+	return (0 == numberOfFailures) ? EXIT_CODE_SUCCESS : EXIT_CODE_FAILURE;
+}
+
+bool DDOPCommandLine::parse_arguments(int argumentCount, char *argumentValues[])
+{
+	if (argumentCount < 3)
+	{
+		return false;
+	}
+
+	std::string commandName(argumentValues[1]);
+	if ("validate" == commandName)
+	{
+		command = Command::Validate;
+	}
+	else if ("convert" == commandName)
+	{
+		command = Command::Convert;
+	}
+	else if ("export" == commandName)
+	{
+		command = Command::Export;
+	}
+	else if ("aggregate" == commandName)
+	{
+		command = Command::Aggregate;
+	}
+	else if ("diff" == commandName)
+	{
+		command = Command::Diff;
+	}
+	else if ("merge" == commandName)
+	{
+		command = Command::Merge;
+	}
+	else
+	{
+		std::fprintf(stderr, "Unknown command \"%s\"\n", commandName.c_str());
+		return false;
+	}
+
+	for (int i = 2; i < argumentCount; i++)
+	{
+		std::string argument(argumentValues[i]);
+
+		if ((("--tc-version" == argument) || ("--output-dir" == argument) || ("--jobs" == argument) || ("--report" == argument) || ("--cache" == argument)) && (i + 1 >= argumentCount))
+		{
+			std::fprintf(stderr, "%s requires a value\n", argument.c_str());
+			return false;
+		}
+		else if ("--tc-version" == argument)
+		{
+			std::string version(argumentValues[++i]);
+
+			if ("3" == version)
+			{
+				taskControllerVersion = 3;
+			}
+			else if ("4" == version)
+			{
+				taskControllerVersion = 4;
+			}
+			else
+			{
+				std::fprintf(stderr, "Unsupported TC version \"%s\"\n", version.c_str());
+				return false;
+			}
+		}
+		else if ("--output-dir" == argument)
+		{
+			outputDirectory = argumentValues[++i];
+		}
+		else if ("--jobs" == argument)
+		{
+			const char *jobsText = argumentValues[++i];
+			char *end = nullptr;
+			errno = 0;
+
+			// strtoull accepts a sign and leading spaces, so only let it see text that starts with a digit
+			unsigned long long jobs = (0 != std::isdigit(static_cast<unsigned char>(jobsText[0]))) ? std::strtoull(jobsText, &end, 10) : 0;
+
+			if ((0 == jobs) || ('\0' != *end) || (ERANGE == errno))
+			{
+				std::fprintf(stderr, "--jobs needs a positive whole number, not \"%s\"\n", jobsText);
+				return false;
+			}
+			numberOfJobs = static_cast<std::size_t>(std::min<unsigned long long>(jobs, MAX_NUMBER_OF_JOBS));
+		}
+		else if ("--report" == argument)
+		{
+			reportPath = argumentValues[++i];
+		}
+		else if ("--cache" == argument)
+		{
+			cacheDirectory = argumentValues[++i];
+		}
+		else if (("--quiet" == argument) || ("-q" == argument))
+		{
+			quiet = true;
+		}
+		else if ((argument.size() > 1) && ('-' == argument[0]))
+		{
+			std::fprintf(stderr, "Unknown option \"%s\"\n", argument.c_str());
+			return false;
+		}
+		else if ((Command::Diff == command) || (Command::Merge == command))
+		{
+			// Directories given to diff are paired up by run_diff
+			inputFiles.push_back(argument);
+		}
+		else
+		{
+			collect_input_files(argument);
+		}
+	}
+
+	if ((Command::Validate != command) && (Command::Diff != command) && outputDirectory.empty())
+	{
+		std::fprintf(stderr, "--output-dir is required for this command\n");
+		return false;
+	}
+	else if ((Command::Diff == command) && (2 != inputFiles.size()))
+	{
+		std::fprintf(stderr, "diff needs an old and a new file or directory\n");
+		return false;
+	}
+	else if ((Command::Merge == command) && (3 != inputFiles.size()))
+	{
+		std::fprintf(stderr, "merge needs a base, our and their file\n");
+		return false;
+	}
+	else if ((!cacheDirectory.empty()) && (!ValidationCache::is_supported()))
+	{
+		std::fprintf(stderr, "--cache is unavailable: this build doesn't know which AgIsoStack++ revision it uses\n");
+		return false;
+	}
+	return !inputFiles.empty();
+}
+
+void DDOPCommandLine::collect_input_files(const std::string &path)
+{
+	std::error_code errorCode;
+
+	if (std::filesystem::is_directory(path, errorCode))
+	{
+		for (const auto &file : find_iop_files(path))
+		{
+			inputFiles.push_back(file);
+			outputNames.push_back(std::filesystem::path(file).lexically_relative(path).string());
+		}
+	}
+	else
+	{
+		inputFiles.push_back(path);
+		outputNames.push_back(std::filesystem::path(path).filename().string());
+	}
+}
+
+int DDOPCommandLine::run_validation()
+{
+	std::unique_ptr<ValidationCache> cache;
+
+	if (!cacheDirectory.empty())
+	{
+		cache = std::make_unique<ValidationCache>(cacheDirectory);
+	}
+
+	BatchValidator validator(taskControllerVersion, get_number_of_jobs(inputFiles.size()), cache.get());
+	auto results = validator.validate(inputFiles);
+	std::size_t numberOfFailures = 0;
+
+	// Keep stdout clean for the JSON when the report is written there
+	bool printProgress = (!quiet) && ("-" != reportPath);
+
+	for (const auto &result : results)
+	{
+		if (result.passed())
+		{
+			if (printProgress)
+			{
+				std::printf("OK   %s\n", result.filePath.c_str());
+			}
+		}
+		else
+		{
+			const char *reason = "serialization errors detected";
+
+			if (!result.fileRead)
+			{
+				reason = "could not read file";
+			}
+			else if (!result.deserialized)
+			{
+				reason = "could not deserialize the DDOP";
+			}
+			std::fprintf(stderr, "FAIL %s: %s\n", result.filePath.c_str(), reason);
+
+			for (const auto &diagnostic : result.diagnostics)
+			{
+				std::fprintf(stderr, "     %s\n", diagnostic.logText.c_str());
+			}
+			numberOfFailures++;
+		}
+	}
+
+	if (!reportPath.empty())
+	{
+		if ("-" == reportPath)
+		{
+			validator.write_json_report(results, std::cout);
+		}
+		else
+		{
+			std::ofstream reportFile(reportPath, std::ios_base::trunc);
+			validator.write_json_report(results, reportFile);
+
+			if (!reportFile)
+			{
+				std::fprintf(stderr, "Could not write report \"%s\"\n", reportPath.c_str());
+				numberOfFailures++;
+			}
+		}
+	}
+
+	if (printProgress)
+	{
+		std::printf("%zu of %zu files passed validation\n", results.size() - numberOfFailures, results.size());
+
+		if (nullptr != cache)
+		{
+			std::printf("%zu results were taken from the cache\n", cache->get_number_of_hits());
+		}
+	}
+	return (0 == numberOfFailures) ? EXIT_CODE_SUCCESS : EXIT_CODE_FAILURE;
+}
+
+int DDOPCommandLine::run_aggregation()
+{
+	std::error_code errorCode;
+	std::filesystem::create_directories(outputDirectory, errorCode);
+
+	std::string outputPath = (std::filesystem::path(outputDirectory) / "TASKDATA.XML").string();
+	std::ofstream outFile(outputPath, std::ios_base::trunc | std::ios_base::binary);
+
+	if (!outFile)
+	{
+		std::fprintf(stderr, "FAIL %s: could not write file\n", outputPath.c_str());
+		return EXIT_CODE_FAILURE;
+	}
+
+	TaskDataAggregator aggregator(taskControllerVersion, get_number_of_jobs(inputFiles.size()));
+	auto results = aggregator.aggregate(inputFiles, outFile);
+	outFile.close();
+	std::size_t numberOfFailures = 0;
+
+	for (const auto &result : results)
+	{
+		if (result.passed())
+		{
+			if (!quiet)
+			{
+				std::printf("OK   %s\n", result.filePath.c_str());
+			}
+		}
+		else
+		{
+			const char *reason = "the DDOP has no device object";
+
+			if (!result.fileRead)
+			{
+				reason = "could not read file";
+			}
+			else if (!result.deserialized)
+			{
+				reason = "could not deserialize the DDOP";
+			}
+			std::fprintf(stderr, "FAIL %s: %s\n", result.filePath.c_str(), reason);
+
+			for (const auto &diagnostic : result.diagnostics)
+			{
+				std::fprintf(stderr, "     %s\n", diagnostic.logText.c_str());
+			}
+			numberOfFailures++;
+		}
+	}
+
+	if (!outFile)
+	{
+		std::fprintf(stderr, "FAIL %s: could not write file\n", outputPath.c_str());
+		return EXIT_CODE_FAILURE;
+	}
+
+	if (!quiet)
+	{
+		std::printf("%zu of %zu devices written to %s\n", results.size() - numberOfFailures, results.size(), outputPath.c_str());
+	}
+	return (0 == numberOfFailures) ? EXIT_CODE_SUCCESS : EXIT_CODE_FAILURE;
+}
+
+int DDOPCommandLine::run_diff()
+{
+	std::vector<DiffResult> results;
+	std::error_code errorCode;
+	const bool isOldDirectory = std::filesystem::is_directory(inputFiles[0], errorCode);
+	const bool isNewDirectory = std::filesystem::is_directory(inputFiles[1], errorCode);
+
+	if (isOldDirectory != isNewDirectory)
+	{
+		std::fprintf(stderr, "diff needs two files or two directories\n");
+		return EXIT_CODE_USAGE;
+	}
+	else if (isOldDirectory)
+	{
+		// Pair the files with the same path relative to each directory. Both lists are sorted.
+		auto oldFiles = find_iop_files(inputFiles[0]);
+		auto newFiles = find_iop_files(inputFiles[1]);
+		std::size_t oldIndex = 0;
+		std::size_t newIndex = 0;
+
+		while ((oldIndex < oldFiles.size()) || (newIndex < newFiles.size()))
+		{
+			DiffResult result;
+			std::string oldRelativePath = (oldIndex < oldFiles.size()) ? std::filesystem::path(oldFiles[oldIndex]).lexically_relative(inputFiles[0]).generic_string() : std::string();
+			std::string newRelativePath = (newIndex < newFiles.size()) ? std::filesystem::path(newFiles[newIndex]).lexically_relative(inputFiles[1]).generic_string() : std::string();
+
+			if ((!oldRelativePath.empty()) && (newRelativePath.empty() || (oldRelativePath <= newRelativePath)))
+			{
+				result.oldFilePath = oldFiles[oldIndex++];
+			}
+			if ((!newRelativePath.empty()) && (oldRelativePath.empty() || (newRelativePath <= oldRelativePath)))
+			{
+				result.newFilePath = newFiles[newIndex++];
+			}
+			results.push_back(std::move(result));
+		}
+	}
+	else
+	{
+		results.push_back({ inputFiles[0], inputFiles[1], {}, {}, false });
+	}
+
+	WorkStealingPool threadPool(get_number_of_jobs(results.size()));
+	std::vector<std::unique_ptr<LogContext>> workerLogs;
+
+	for (std::size_t i = 0; i < threadPool.get_number_of_threads(); i++)
+	{
+		workerLogs.push_back(std::make_unique<LogContext>());
+	}
+
+	threadPool.run(results.size(), [&](std::size_t resultIndex, std::size_t workerIndex) {
+		auto &result = results[resultIndex];
+		auto &fileLog = *workerLogs[workerIndex];
+		fileLog.clear();
+		ScopedLogContext logScope(fileLog);
+
+		if ((!result.oldFilePath.empty()) && (!result.newFilePath.empty()))
+		{
+			isobus::DeviceDescriptorObjectPool oldPool;
+			isobus::DeviceDescriptorObjectPool newPool;
+			result.loaded = load_object_pool(result.oldFilePath, oldPool) && load_object_pool(result.newFilePath, newPool);
+
+			if (result.loaded)
+			{
+				result.changes = DdopDiff::compare(oldPool, newPool);
+			}
+		}
+		result.diagnostics = fileLog.get_messages();
+	});
+
+	std::size_t numberOfDifferences = 0;
+
+	// Keep stdout clean for the JSON when the report is written there
+	bool printDifferences = ("-" != reportPath);
+	bool printProgress = (!quiet) && printDifferences;
+
+	for (const auto &result : results)
+	{
+		if (result.oldFilePath.empty() || result.newFilePath.empty())
+		{
+			if (printDifferences)
+			{
+				std::printf("ONLY %s\n", result.oldFilePath.empty() ? result.newFilePath.c_str() : result.oldFilePath.c_str());
+			}
+			numberOfDifferences++;
+		}
+		else if (!result.loaded)
+		{
+			std::fprintf(stderr, "FAIL %s: could not load both DDOPs\n", result.newFilePath.c_str());
+
+			for (const auto &diagnostic : result.diagnostics)
+			{
+				std::fprintf(stderr, "     %s\n", diagnostic.logText.c_str());
+			}
+			numberOfDifferences++;
+		}
+		else if (result.changes.empty())
+		{
+			if (printProgress)
+			{
+				std::printf("SAME %s\n", result.newFilePath.c_str());
+			}
+		}
+		else if (printDifferences)
+		{
+			std::printf("DIFF %s\n", result.newFilePath.c_str());
+			numberOfDifferences++;
+
+			for (const auto &change : result.changes)
+			{
+				const char *changeSymbol = (DdopDiff::ChangeType::Added == change.type) ? "+" : ((DdopDiff::ChangeType::Removed == change.type) ? "-" : "~");
+				const std::uint16_t objectID = (DdopDiff::ChangeType::Removed == change.type) ? change.oldObjectID : change.newObjectID;
+				std::printf("     %s %s %u \"%s\"\n", changeSymbol, change.tableID.c_str(), objectID, change.designator.c_str());
+
+				for (const auto &fieldChange : change.fieldChanges)
+				{
+					std::printf("         %s: %s -> %s\n", DdopDiff::get_field_name(fieldChange.field), fieldChange.oldValue.c_str(), fieldChange.newValue.c_str());
+				}
+			}
+		}
+		else
+		{
+			numberOfDifferences++;
+		}
+	}
+
+	if (!reportPath.empty())
+	{
+		std::ofstream reportFile;
+		std::ostream *reportStream = &std::cout;
+
+		if ("-" != reportPath)
+		{
+			reportFile.open(reportPath, std::ios_base::trunc);
+			reportStream = &reportFile;
+		}
+
+		JsonWriter json(*reportStream);
+		json.begin_object();
+		json.write("filesCompared", results.size());
+		json.write("filesChanged", numberOfDifferences);
+		json.begin_array("results");
+
+		for (const auto &result : results)
+		{
+			json.begin_object();
+			json.write("oldFile", result.oldFilePath);
+			json.write("newFile", result.newFilePath);
+			json.write("loaded", result.loaded);
+			json.begin_array("changes");
+
+			for (const auto &change : result.changes)
+			{
+				json.begin_object();
+				json.write("change", DdopDiff::get_change_type_name(change.type));
+				json.write("type", change.tableID);
+				json.write("designator", change.designator);
+
+				if (DdopDiff::ChangeType::Added != change.type)
+				{
+					json.write("oldObjectID", change.oldObjectID);
+				}
+				if (DdopDiff::ChangeType::Removed != change.type)
+				{
+					json.write("newObjectID", change.newObjectID);
+				}
+				json.begin_array("fields");
+
+				for (const auto &fieldChange : change.fieldChanges)
+				{
+					json.begin_object();
+					json.write("field", DdopDiff::get_field_name(fieldChange.field));
+					json.write("old", fieldChange.oldValue);
+					json.write("new", fieldChange.newValue);
+					json.end_object();
+				}
+				json.end_array();
+				json.end_object();
+			}
+			json.end_array();
+			json.end_object();
+		}
+		json.end_array();
+		json.end_object();
+		*reportStream << '\n';
+
+		if (!*reportStream)
+		{
+			std::fprintf(stderr, "Could not write report \"%s\"\n", reportPath.c_str());
+			return EXIT_CODE_FAILURE;
+		}
+	}
+
+	if (printProgress)
+	{
+		std::printf("%zu of %zu files differ\n", numberOfDifferences, results.size());
+	}
+	return (0 == numberOfDifferences) ? EXIT_CODE_SUCCESS : EXIT_CODE_FAILURE;
+}
+
+int DDOPCommandLine::run_merge()
+{
+	LogContext mergeLog;
+	ScopedLogContext logScope(mergeLog);
+	isobus::DeviceDescriptorObjectPool basePool;
+	isobus::DeviceDescriptorObjectPool ourPool;
+	isobus::DeviceDescriptorObjectPool theirPool;
+	isobus::DeviceDescriptorObjectPool mergedPool;
+	std::vector<DdopDiff::Conflict> conflicts;
+
+	for (std::size_t i = 0; i < inputFiles.size(); i++)
+	{
+		auto &pool = (0 == i) ? basePool : ((1 == i) ? ourPool : theirPool);
+
+		if (!load_object_pool(inputFiles[i], pool))
+		{
+			std::fprintf(stderr, "FAIL %s: could not load the DDOP\n", inputFiles[i].c_str());
+			print_log_history(mergeLog);
+			return EXIT_CODE_FAILURE;
+		}
+	}
+
+	mergedPool.set_task_controller_compatibility_level(taskControllerVersion);
+	std::vector<std::uint8_t> binaryDDOP;
+	const std::string outputPath = get_output_path(std::filesystem::path(inputFiles[1]).filename().string(), ".iop");
+
+	if ((!DdopDiff::merge(basePool, ourPool, theirPool, mergedPool, conflicts)) || (!mergedPool.generate_binary_object_pool(binaryDDOP)))
+	{
+		std::fprintf(stderr, "FAIL %s: the merged DDOP is not valid\n", outputPath.c_str());
+		print_log_history(mergeLog);
+		return EXIT_CODE_FAILURE;
+	}
+
+	for (const auto &conflict : conflicts)
+	{
+		std::fprintf(stderr,
+		             "CONFLICT %s %u \"%s\" %s: base %s, ours %s, theirs %s. Kept ours.\n",
+		             conflict.tableID.c_str(),
+		             conflict.objectID,
+		             conflict.designator.c_str(),
+		             DdopDiff::get_field_name(conflict.field),
+		             conflict.baseValue.c_str(),
+		             conflict.ourValue.c_str(),
+		             conflict.theirValue.c_str());
+	}
+
+	if (!write_file(outputPath, reinterpret_cast<const char *>(binaryDDOP.data()), binaryDDOP.size()))
+	{
+		return EXIT_CODE_FAILURE;
+	}
+
+	if (!quiet)
+	{
+		std::printf("Merged %zu objects into %s with %zu conflict(s)\n", static_cast<std::size_t>(mergedPool.size()), outputPath.c_str(), conflicts.size());
+	}
+	return conflicts.empty() ? EXIT_CODE_SUCCESS : EXIT_CODE_FAILURE;
+}
+
+bool DDOPCommandLine::load_object_pool(const std::string &path, isobus::DeviceDescriptorObjectPool &pool) const
+{
+	bool retVal = false;
+	MappedFile iopFile(path);
+
+	if (iopFile.is_open() && (iopFile.get_size() <= UINT32_MAX))
+	{
+		pool.set_task_controller_compatibility_level(taskControllerVersion);
+		retVal = pool.deserialize_binary_object_pool(iopFile.get_data(), static_cast<std::uint32_t>(iopFile.get_size()), isobus::NAME(0));
+	}
+	return retVal;
+}
+
+bool DDOPCommandLine::process_file(const std::string &path, const std::string &outputPath)
+{
+	bool retVal = false;
+	LogContext fileLog;
+	ScopedLogContext logScope(fileLog);
+
+	MappedFile iopFile(path);
+
+	if ((!iopFile.is_open()) || (iopFile.get_size() > UINT32_MAX))
+	{
+		std::fprintf(stderr, "FAIL %s: could not read file\n", path.c_str());
+		return false;
+	}
+
+	isobus::DeviceDescriptorObjectPool objectPool;
+	objectPool.set_task_controller_compatibility_level(taskControllerVersion);
+
+	bool deserialized = objectPool.deserialize_binary_object_pool(iopFile.get_data(), static_cast<std::uint32_t>(iopFile.get_size()), isobus::NAME(0));
+	iopFile.close();
+
+	if (!deserialized)
+	{
+		std::fprintf(stderr, "FAIL %s: could not deserialize the DDOP\n", path.c_str());
+	}
+	else
+	{
+		std::vector<std::uint8_t> binaryDDOP;
+
+		if (!objectPool.generate_binary_object_pool(binaryDDOP))
+		{
+			std::fprintf(stderr, "FAIL %s: serialization errors detected\n", path.c_str());
+		}
+		else if (Command::Convert == command)
+		{
+			retVal = write_file(outputPath, reinterpret_cast<const char *>(binaryDDOP.data()), binaryDDOP.size());
+		}
+		else if (Command::Export == command)
+		{
+			retVal = write_iso_xml_file(outputPath, objectPool);
+		}
+		else
+		{
+			retVal = true;
+		}
+	}
+
+	if (!retVal)
+	{
+		print_log_history(fileLog);
+	}
+	else if (!quiet)
+	{
+		std::printf("OK   %s\n", path.c_str());
+	}
+	return retVal;
+}
+
+bool DDOPCommandLine::write_file(const std::string &path, const char *data, std::size_t size) const
+{
+	std::error_code errorCode;
+	std::filesystem::create_directories(std::filesystem::path(path).parent_path(), errorCode);
+
+	std::ofstream outFile(path, std::ios_base::trunc | std::ios_base::binary);
+
+	if (outFile)
+	{
+		outFile.write(data, static_cast<std::streamsize>(size));
+	}
+
+	if (!outFile)
+	{
+		std::fprintf(stderr, "FAIL %s: could not write file\n", path.c_str());
+		return false;
+	}
+	return true;
+}
+
+bool DDOPCommandLine::write_iso_xml_file(const std::string &path, isobus::DeviceDescriptorObjectPool &pool) const
+{
+	std::error_code errorCode;
+	std::filesystem::create_directories(std::filesystem::path(path).parent_path(), errorCode);
+
+	std::ofstream outFile(path, std::ios_base::trunc | std::ios_base::binary);
+
+	if (!outFile)
+	{
+		std::fprintf(stderr, "FAIL %s: could not write file\n", path.c_str());
+		return false;
+	}
+
+	if (!IsoXmlWriter::write_task_data(pool, outFile))
+	{
+		std::fprintf(stderr, "FAIL %s: ISOXML export failed\n", path.c_str());
+		return false;
+	}
+	return true;
+}
+
+std::size_t DDOPCommandLine::get_number_of_jobs(std::size_t numberOfTasks) const
+{
+	// 0 leaves the choice to the thread pool, which uses one worker per hardware thread
+	std::size_t retVal = numberOfJobs;
+
+	if (0 != retVal)
+	{
+		retVal = std::min(retVal, std::max<std::size_t>(1, numberOfTasks));
+	}
+	return retVal;
+}
+
+std::string DDOPCommandLine::get_output_path(const std::string &outputName, const std::string &extension) const
+{
+	auto outputPath = std::filesystem::path(outputDirectory) / outputName;
+	outputPath.replace_extension(extension);
+	return outputPath.string();
+}
+
+std::vector<std::string> DDOPCommandLine::find_iop_files(const std::string &directory)
+{
+	std::vector<std::string> retVal;
+	std::error_code errorCode;
+
+	for (auto &entry : std::filesystem::recursive_directory_iterator(directory, errorCode))
+	{
+		if (entry.is_regular_file(errorCode))
+		{
+			std::string extension = entry.path().extension().string();
+			std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char character) { return static_cast<char>(std::tolower(character)); });
+
+			if (".iop" == extension)
+			{
+				retVal.push_back(entry.path().string());
+			}
+		}
+	}
+
+	// Directory iteration order is unspecified, so sort to keep reports reproducible
+	std::sort(retVal.begin(), retVal.end());
+	return retVal;
+}
+
+void DDOPCommandLine::print_usage(const char *programName)
+{
+	std::fprintf(stderr,
+	             "Usage: %s <command> [options] <file.iop | directory>...\n"
+	             "\n"
+	             "Commands:\n"
+	             "  validate   Deserialize and re-serialize each DDOP and report errors\n"
+	             "  convert    Re-serialize each DDOP into --output-dir\n"
+	             "  export     Export each DDOP as ISOXML into --output-dir\n"
+	             "  aggregate  Export every DDOP as one device of a single TASKDATA.XML in --output-dir\n"
+	             "  diff       Compare <old> <new> DDOPs, or every DDOP with the same path in two directories\n"
+	             "  merge      Merge the changes <ours> and <theirs> made to <base> into --output-dir\n"
+	             "\n"
+	             "Options:\n"
+	             "  --tc-version <3|4>   TC version used to parse the DDOPs (default 4)\n"
+	             "  --output-dir <dir>   Directory that converted or exported files are written to\n"
+	             "  --jobs <count>       Number of files to validate, aggregate or compare in parallel (default: one per CPU)\n"
+	             "  --report <file>      Write a JSON validation or diff report to a file, or - for stdout\n"
+	             "  --cache <dir>        Reuse validation results of identical DDOPs stored in a directory\n"
+	             "  --quiet, -q          Only print failures\n"
+	             "\n"
+	             "Directories are searched recursively for .iop files.\n",
+	             programName);
+}
+
+void DDOPCommandLine::print_log_history(const LogContext &log)
+{
+	log.for_each_message([](isobus::CANStackLogger::LoggingLevel, const char *text) {
+		std::fprintf(stderr, "     %s\n", text);
+	});
+}
@@ -0,0 +1,16 @@
+//================================================================================================
+/// @file cli_main.cpp
+///
+/// @brief Implements main for the headless DDOP command line tool
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso and the Open-Agriculture developers
+//================================================================================================
+#include "cli.hpp"
+
+int main(int aArgCount, char *apArgValues[])
+{
+	DDOPCommandLine commandLine;
+
+	return commandLine.run(aArgCount, apArgValues);
+}
@@ -0,0 +1,400 @@
+//================================================================================================
+/// @file ddi_search_index.cpp
+///
+/// @brief Implements a search index over the ISO 11783-11 data dictionary
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso and the Open-Agriculture developers
+//================================================================================================
+#include "ddi_search_index.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstdio>
+#include <map>
+
+namespace
+{
+	constexpr std::uint32_t EXACT_NUMBER_SCORE = 8;
+	constexpr std::uint32_t EXACT_WORD_SCORE = 6;
+	constexpr std::uint32_t NUMBER_PREFIX_SCORE = 4;
+	constexpr std::uint32_t WORD_PREFIX_SCORE = 3;
+	constexpr std::uint32_t RANGE_SCORE = 2;
+	constexpr std::uint32_t FUZZY_WORD_SCORE = 1;
+	constexpr std::uint16_t LAST_VALID_DDI = 0xFFFE; ///< 0xFFFF is what the dictionary returns for unknown DDIs
+
+	bool starts_with(const std::string &text, const std::string &prefix)
+	{
+		return (text.size() >= prefix.size()) && (0 == text.compare(0, prefix.size(), prefix));
+	}
+}
+
+void DdiSearchIndex::build()
+{
+	if (built)
+	{
+		return;
+	}
+
+	// The dictionary can only be queried one DDI at a time, so every possible DDI is asked for once
+	std::map<std::string, std::vector<std::uint32_t>> entriesByWord;
+	std::vector<std::string> entryWords;
+
+	for (std::uint32_t ddi = 0; ddi <= LAST_VALID_DDI; ddi++)
+	{
+		const auto &entry = isobus::DataDictionary::get_entry(static_cast<std::uint16_t>(ddi));
+
+		if (entry.ddi == ddi)
+		{
+			const auto entryIndex = static_cast<std::uint32_t>(entries.size());
+			char hexDDI[5];
+			std::snprintf(hexDDI, sizeof(hexDDI), "%X", static_cast<unsigned int>(ddi));
+
+			entries.push_back(&entry);
+			decimalDDIs.push_back(std::to_string(ddi));
+			hexDDIs.push_back(hexDDI);
+
+			entryWords.clear();
+			split_words(entry.name, entryWords);
+			split_words(entry.units, entryWords);
+
+			for (const auto &word : entryWords)
+			{
+				auto &wordEntries = entriesByWord[word];
+
+				// Entries are visited in order, so a repeated word only needs comparing with the last one
+				if (wordEntries.empty() || (wordEntries.back() != entryIndex))
+				{
+					wordEntries.push_back(entryIndex);
+				}
+			}
+		}
+	}
+
+	words.reserve(entriesByWord.size());
+	for (auto &word : entriesByWord)
+	{
+		words.push_back({ word.first, std::move(word.second) });
+	}
+
+	scores.resize(entries.size());
+	termScores.resize(entries.size());
+	termsMatched.resize(entries.size());
+	built = true;
+}
+
+bool DdiSearchIndex::is_built() const
+{
+	return built;
+}
+
+std::size_t DdiSearchIndex::size() const
+{
+	return entries.size();
+}
+
+const std::vector<DdiSearchIndex::Match> &DdiSearchIndex::search(const std::string &query, std::size_t maxResults)
+{
+	search(query, maxResults, results);
+	return results;
+}
+
+void DdiSearchIndex::search(const std::string &query, std::size_t maxResults, std::vector<Match> &matches)
+{
+	build();
+	matches.clear();
+	std::fill(scores.begin(), scores.end(), 0);
+	std::fill(termScores.begin(), termScores.end(), 0);
+	std::fill(termsMatched.begin(), termsMatched.end(), 0);
+
+	// Terms are separated by white space only, so that ranges like "100-200" stay in one piece
+	queryTerms.clear();
+	std::size_t termStart = std::string::npos;
+	for (std::size_t i = 0; i <= query.size(); i++)
+	{
+		bool isSpace = (i == query.size()) || (0 != std::isspace(static_cast<unsigned char>(query[i])));
+
+		if (isSpace && (std::string::npos != termStart))
+		{
+			queryTerms.push_back(query.substr(termStart, i - termStart));
+			termStart = std::string::npos;
+		}
+		else if ((!isSpace) && (std::string::npos == termStart))
+		{
+			termStart = i;
+		}
+	}
+
+	std::uint32_t numberOfTerms = 0;
+	auto finishTerm = [this, &numberOfTerms]() {
+		for (std::size_t entryIndex = 0; entryIndex < entries.size(); entryIndex++)
+		{
+			if (0 != termScores[entryIndex])
+			{
+				scores[entryIndex] += termScores[entryIndex];
+				termsMatched[entryIndex]++;
+				termScores[entryIndex] = 0;
+			}
+		}
+		numberOfTerms++;
+	};
+
+	for (const auto &term : queryTerms)
+	{
+		if (match_number_term(term))
+		{
+			// A plain decimal number can also be part of a name, like the 16 in "(1-16)"
+			if (std::all_of(term.begin(), term.end(), [](unsigned char character) { return 0 != std::isdigit(character); }))
+			{
+				match_word_term(term);
+			}
+			finishTerm();
+		}
+		else
+		{
+			// A term like "rate/area" is several words, and each of them has to match.
+			// Punctuation on its own has no words, so it doesn't rule anything out.
+			termWords.clear();
+			split_words(term, termWords);
+
+			for (const auto &word : termWords)
+			{
+				match_word_term(word);
+				finishTerm();
+			}
+		}
+	}
+
+	for (std::size_t entryIndex = 0; entryIndex < entries.size(); entryIndex++)
+	{
+		if (termsMatched[entryIndex] == numberOfTerms)
+		{
+			matches.push_back({ entries[entryIndex], scores[entryIndex] });
+		}
+	}
+
+	auto isBetter = [](const Match &a, const Match &b) {
+		return (a.score != b.score) ? (a.score > b.score) : (a.entry->ddi < b.entry->ddi);
+	};
+
+	if (matches.size() > maxResults)
+	{
+		std::partial_sort(matches.begin(), matches.begin() + maxResults, matches.end(), isBetter);
+		matches.resize(maxResults);
+	}
+	else
+	{
+		std::sort(matches.begin(), matches.end(), isBetter);
+	}
+}
+
+const std::vector<DdiSearchIndex::Match> &DdiSearchIndex::get_results() const
+{
+	return results;
+}
+
+void DdiSearchIndex::split_words(const std::string &text, std::vector<std::string> &words)
+{
+	std::string word;
+
+	for (char character : text)
+	{
+		auto byte = static_cast<unsigned char>(character);
+
+		// Bytes of multi-byte UTF-8 characters are kept, so units like "mm³" stay one word
+		if ((0 != std::isalnum(byte)) || (byte >= 0x80))
+		{
+			word += static_cast<char>(std::tolower(byte));
+		}
+		else if (!word.empty())
+		{
+			words.push_back(word);
+			word.clear();
+		}
+	}
+
+	if (!word.empty())
+	{
+		words.push_back(word);
+	}
+}
+
+bool DdiSearchIndex::is_within_prefix_edit_distance(const std::string &term, const std::string &word, std::size_t maximumDistance)
+{
+	constexpr std::size_t MAX_WORD_LENGTH = 63;
+
+	// Prefixes longer than this are always more than maximumDistance edits away
+	const std::size_t wordLength = std::min(word.size(), term.size() + maximumDistance);
+
+	if ((term.size() > MAX_WORD_LENGTH) || (wordLength > MAX_WORD_LENGTH) || (wordLength + maximumDistance < term.size()))
+	{
+		return false;
+	}
+
+	// Levenshtein distance with two rows, giving up as soon as a whole row is over the limit.
+	// The last row holds the distance to every prefix of the word, so typos made while still
+	// typing a longer word are forgiven as well.
+	std::array<std::size_t, MAX_WORD_LENGTH + 1> previousRow;
+	std::array<std::size_t, MAX_WORD_LENGTH + 1> currentRow;
+
+	for (std::size_t j = 0; j <= wordLength; j++)
+	{
+		previousRow[j] = j;
+	}
+
+	for (std::size_t i = 1; i <= term.size(); i++)
+	{
+		std::size_t rowMinimum = i;
+		currentRow[0] = i;
+
+		for (std::size_t j = 1; j <= wordLength; j++)
+		{
+			std::size_t substitutionCost = (term[i - 1] == word[j - 1]) ? 0 : 1;
+			currentRow[j] = std::min({ previousRow[j] + 1, currentRow[j - 1] + 1, previousRow[j - 1] + substitutionCost });
+			rowMinimum = std::min(rowMinimum, currentRow[j]);
+		}
+
+		if (rowMinimum > maximumDistance)
+		{
+			return false;
+		}
+		std::swap(previousRow, currentRow);
+	}
+	return *std::min_element(previousRow.begin(), previousRow.begin() + wordLength + 1) <= maximumDistance;
+}
+
+bool DdiSearchIndex::parse_number(const std::string &text, std::uint32_t &value, bool &isHex)
+{
+	isHex = (text.size() > 2) && ('0' == text[0]) && (('x' == text[1]) || ('X' == text[1]));
+	std::size_t start = isHex ? 2 : 0;
+	value = 0;
+
+	if ((text.size() <= start) || (text.size() - start > (isHex ? 4 : 5)))
+	{
+		return false;
+	}
+
+	for (std::size_t i = start; i < text.size(); i++)
+	{
+		auto digit = static_cast<unsigned char>(text[i]);
+
+		if (isHex && (0 != std::isxdigit(digit)))
+		{
+			value = (value * 16) + static_cast<std::uint32_t>(std::isdigit(digit) ? (digit - '0') : (std::tolower(digit) - 'a' + 10));
+		}
+		else if ((!isHex) && (0 != std::isdigit(digit)))
+		{
+			value = (value * 10) + (digit - '0');
+		}
+		else
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+bool DdiSearchIndex::match_number_term(const std::string &term)
+{
+	std::uint32_t value = 0;
+	bool isHex = false;
+	auto dash = term.find('-');
+
+	if ((std::string::npos != dash) && (dash > 0))
+	{
+		std::uint32_t rangeEnd = 0;
+		bool isEndHex = false;
+
+		if (parse_number(term.substr(0, dash), value, isHex) && parse_number(term.substr(dash + 1), rangeEnd, isEndHex))
+		{
+			if (value > rangeEnd)
+			{
+				std::swap(value, rangeEnd);
+			}
+
+			// Entries are sorted by DDI, so the range is one contiguous run of them
+			for (std::size_t entryIndex = 0; entryIndex < entries.size(); entryIndex++)
+			{
+				if ((entries[entryIndex]->ddi >= value) && (entries[entryIndex]->ddi <= rangeEnd))
+				{
+					add_term_score(static_cast<std::uint32_t>(entryIndex), RANGE_SCORE);
+				}
+			}
+			return true;
+		}
+		return false;
+	}
+
+	if (!parse_number(term, value, isHex))
+	{
+		return false;
+	}
+
+	std::string digits = isHex ? term.substr(2) : term;
+	if (isHex)
+	{
+		std::transform(digits.begin(), digits.end(), digits.begin(), [](unsigned char character) { return static_cast<char>(std::toupper(character)); });
+
+		// Leading zeros are allowed when typing hex, but the stored hex text has none
+		auto firstNonZero = digits.find_first_not_of('0');
+		digits = (std::string::npos == firstNonZero) ? "0" : digits.substr(firstNonZero);
+	}
+
+	const auto &ddiTexts = isHex ? hexDDIs : decimalDDIs;
+	for (std::size_t entryIndex = 0; entryIndex < entries.size(); entryIndex++)
+	{
+		if (entries[entryIndex]->ddi == value)
+		{
+			add_term_score(static_cast<std::uint32_t>(entryIndex), EXACT_NUMBER_SCORE);
+		}
+		else if (starts_with(ddiTexts[entryIndex], digits))
+		{
+			add_term_score(static_cast<std::uint32_t>(entryIndex), NUMBER_PREFIX_SCORE);
+		}
+	}
+	return true;
+}
+
+void DdiSearchIndex::match_word_term(const std::string &term)
+{
+	auto word = std::lower_bound(words.begin(), words.end(), term, [](const Word &candidate, const std::string &text) {
+		return candidate.text < text;
+	});
+	bool anyPrefixMatch = false;
+
+	// Every word the term is a prefix of sorts right after the term itself
+	for (; (words.end() != word) && starts_with(word->text, term); word++)
+	{
+		std::uint32_t score = (word->text.size() == term.size()) ? EXACT_WORD_SCORE : WORD_PREFIX_SCORE;
+
+		for (auto entryIndex : word->entryIndices)
+		{
+			add_term_score(entryIndex, score);
+		}
+		anyPrefixMatch = true;
+	}
+
+	// Only fall back to typo tolerance when nothing starts with the term, and not for very short
+	// terms, which would be within reach of almost every short word
+	if ((!anyPrefixMatch) && (term.size() >= 3))
+	{
+		std::size_t maximumDistance = (term.size() >= 7) ? 2 : 1;
+
+		for (const auto &candidate : words)
+		{
+			if (is_within_prefix_edit_distance(term, candidate.text, maximumDistance))
+			{
+				for (auto entryIndex : candidate.entryIndices)
+				{
+					add_term_score(entryIndex, FUZZY_WORD_SCORE);
+				}
+			}
+		}
+	}
+}
+
+void DdiSearchIndex::add_term_score(std::uint32_t entryIndex, std::uint32_t score)
+{
+	termScores[entryIndex] = std::max(termScores[entryIndex], score);
+}
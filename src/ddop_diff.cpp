@@ -0,0 +1,1121 @@
+//================================================================================================
+/// @file ddop_diff.cpp
+///
+/// @brief Implements the structural comparison and three-way merge of device descriptor object pools
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso and the Open-Agriculture developers
+//================================================================================================
+#include "ddop_diff.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <limits>
+#include <memory>
+#include <tuple>
+
+namespace
+{
+	using Object = isobus::task_controller_object::Object;
+	using ObjectTypes = isobus::task_controller_object::ObjectTypes;
+	using Field = DdopDiff::Field;
+
+	/// @brief The object IDs of one pool, indexed by the ID of the object they are paired with in another
+	using IDMap = std::vector<std::uint16_t>;
+
+	constexpr std::size_t NUMBER_OF_IDS = static_cast<std::size_t>(std::numeric_limits<std::uint16_t>::max()) + 1;
+	constexpr std::uint16_t NULL_OBJECT_ID = Object::NULL_OBJECT_ID;
+	constexpr std::uint32_t NO_PARENT_ELEMENT = 0x10000; ///< Sorts after every real element number
+
+	/// @brief What an object is, independent of its object ID
+	struct MatchKey
+	{
+		std::uint32_t poolIndex;
+		std::uint16_t objectID;
+		std::uint8_t type;
+		std::uint32_t number; ///< The element number, or that of the parent element for process data and properties
+		std::uint32_t ddi;
+		std::string content; ///< The fields of a presentation, which has nothing else to identify it
+
+		bool has_same_key(const MatchKey &other) const
+		{
+			return std::tie(type, number, ddi, content) == std::tie(other.type, other.number, other.ddi, other.content);
+		}
+
+		bool operator<(const MatchKey &other) const
+		{
+			return std::tie(type, number, ddi, content, poolIndex) < std::tie(other.type, other.number, other.ddi, other.content, other.poolIndex);
+		}
+	};
+
+	bool is_key_less(const MatchKey &left, const MatchKey &right)
+	{
+		return std::tie(left.type, left.number, left.ddi, left.content) < std::tie(right.type, right.number, right.ddi, right.content);
+	}
+
+	std::vector<std::shared_ptr<Object>> get_objects_by_id(isobus::DeviceDescriptorObjectPool &pool)
+	{
+		std::vector<std::shared_ptr<Object>> retVal(NUMBER_OF_IDS);
+
+		for (std::uint32_t i = 0; i < pool.size(); i++)
+		{
+			auto object = pool.get_object_by_index(i);
+			retVal[object->get_object_id()] = object;
+		}
+		return retVal;
+	}
+
+	std::string format_number(double value)
+	{
+		char buffer[32];
+		std::snprintf(buffer, sizeof(buffer), "%.9g", value);
+		return buffer;
+	}
+
+	std::string format_hex(std::uint64_t value, int digits)
+	{
+		char buffer[24];
+		std::snprintf(buffer, sizeof(buffer), "0x%0*llX", digits, static_cast<unsigned long long>(value));
+		return buffer;
+	}
+
+	std::string format_bytes(const std::uint8_t *bytes, std::size_t size)
+	{
+		static constexpr char HEX_DIGITS[] = "0123456789ABCDEF";
+		std::string retVal;
+		retVal.reserve(size * 2);
+
+		for (std::size_t i = 0; i < size; i++)
+		{
+			retVal += HEX_DIGITS[bytes[i] >> 4];
+			retVal += HEX_DIGITS[bytes[i] & 0x0F];
+		}
+		return retVal;
+	}
+
+	/// @brief Formats a reference to another object, translated into the other pool's IDs if a map is given.
+	/// A reference to an object without a pair is marked, so it never equals a reference in the other pool.
+	std::string format_reference(std::uint16_t objectID, const IDMap *idMap)
+	{
+		if (NULL_OBJECT_ID == objectID)
+		{
+			return "none";
+		}
+		else if ((nullptr != idMap) && (NULL_OBJECT_ID == (*idMap)[objectID]))
+		{
+			return "unpaired " + std::to_string(objectID);
+		}
+		return std::to_string((nullptr != idMap) ? (*idMap)[objectID] : objectID);
+	}
+
+	/// @brief Translates a reference into the other pool's IDs if a map is given.
+	/// A reference to an object without a pair becomes NULL_OBJECT_ID, since its raw ID may belong
+	/// to an unrelated object in the other pool.
+	std::uint16_t map_reference(std::uint16_t objectID, const IDMap *idMap)
+	{
+		if ((nullptr == idMap) || (NULL_OBJECT_ID == objectID))
+		{
+			return objectID;
+		}
+		return (*idMap)[objectID];
+	}
+
+	/// @brief Returns the object a parent or presentation field refers to, or NULL_OBJECT_ID for other fields
+	std::uint16_t get_reference(Object &object, Field field)
+	{
+		std::uint16_t retVal = NULL_OBJECT_ID;
+
+		if (Field::ParentObject == field)
+		{
+			retVal = static_cast<isobus::task_controller_object::DeviceElementObject &>(object).get_parent_object();
+		}
+		else if ((Field::PresentationObject == field) && (ObjectTypes::DeviceProcessData == object.get_object_type()))
+		{
+			retVal = static_cast<isobus::task_controller_object::DeviceProcessDataObject &>(object).get_device_value_presentation_object_id();
+		}
+		else if (Field::PresentationObject == field)
+		{
+			retVal = static_cast<isobus::task_controller_object::DevicePropertyObject &>(object).get_device_value_presentation_object_id();
+		}
+		return retVal;
+	}
+
+	/// @brief Returns true if a field refers to an object that has no pair in idMap
+	bool is_unpaired_reference(Object &object, Field field, const IDMap &idMap)
+	{
+		const std::uint16_t objectID = get_reference(object, field);
+		return (NULL_OBJECT_ID != objectID) && (NULL_OBJECT_ID == idMap[objectID]);
+	}
+
+	std::uint16_t get_ddi(Object &object)
+	{
+		if (ObjectTypes::DeviceProcessData == object.get_object_type())
+		{
+			return static_cast<isobus::task_controller_object::DeviceProcessDataObject &>(object).get_ddi();
+		}
+		return static_cast<isobus::task_controller_object::DevicePropertyObject &>(object).get_ddi();
+	}
+
+	const std::vector<Field> &get_fields(ObjectTypes type)
+	{
+		static const std::vector<Field> DEVICE_FIELDS = { Field::Designator, Field::SoftwareVersion, Field::SerialNumber, Field::StructureLabel, Field::LocalizationLabel, Field::ExtendedStructureLabel, Field::IsoName };
+		static const std::vector<Field> ELEMENT_FIELDS = { Field::Designator, Field::ElementType, Field::ElementNumber, Field::ParentObject, Field::ChildObjects };
+		static const std::vector<Field> PROCESS_DATA_FIELDS = { Field::Designator, Field::DDI, Field::PropertiesBitfield, Field::TriggerMethodsBitfield, Field::PresentationObject };
+		static const std::vector<Field> PROPERTY_FIELDS = { Field::Designator, Field::DDI, Field::Value, Field::PresentationObject };
+		static const std::vector<Field> PRESENTATION_FIELDS = { Field::Designator, Field::Offset, Field::Scale, Field::NumberOfDecimals };
+
+		switch (type)
+		{
+			case ObjectTypes::Device:
+				return DEVICE_FIELDS;
+			case ObjectTypes::DeviceElement:
+				return ELEMENT_FIELDS;
+			case ObjectTypes::DeviceProcessData:
+				return PROCESS_DATA_FIELDS;
+			case ObjectTypes::DeviceProperty:
+				return PROPERTY_FIELDS;
+			case ObjectTypes::DeviceValuePresentation:
+				return PRESENTATION_FIELDS;
+		}
+		return PRESENTATION_FIELDS;
+	}
+
+	/// @brief Returns a field as text, with references translated through idMap if it isn't null
+	std::string get_field_value(Object &object, Field field, const IDMap *idMap)
+	{
+		std::string retVal;
+
+		switch (field)
+		{
+			case Field::ObjectID:
+			{
+				retVal = std::to_string(object.get_object_id());
+			}
+			break;
+
+			case Field::Designator:
+			{
+				retVal = object.get_designator();
+			}
+			break;
+
+			case Field::SoftwareVersion:
+			{
+				retVal = static_cast<isobus::task_controller_object::DeviceObject &>(object).get_software_version();
+			}
+			break;
+
+			case Field::SerialNumber:
+			{
+				retVal = static_cast<isobus::task_controller_object::DeviceObject &>(object).get_serial_number();
+			}
+			break;
+
+			case Field::StructureLabel:
+			{
+				retVal = static_cast<isobus::task_controller_object::DeviceObject &>(object).get_structure_label();
+			}
+			break;
+
+			case Field::LocalizationLabel:
+			{
+				auto label = static_cast<isobus::task_controller_object::DeviceObject &>(object).get_localization_label();
+				retVal = format_bytes(label.data(), label.size());
+			}
+			break;
+
+			case Field::ExtendedStructureLabel:
+			{
+				auto label = static_cast<isobus::task_controller_object::DeviceObject &>(object).get_extended_structure_label();
+				retVal = format_bytes(label.data(), label.size());
+			}
+			break;
+
+			case Field::IsoName:
+			{
+				retVal = format_hex(static_cast<isobus::task_controller_object::DeviceObject &>(object).get_iso_name(), 16);
+			}
+			break;
+
+			case Field::ElementType:
+			{
+				retVal = std::to_string(static_cast<std::uint32_t>(static_cast<isobus::task_controller_object::DeviceElementObject &>(object).get_type()));
+			}
+			break;
+
+			case Field::ElementNumber:
+			{
+				retVal = std::to_string(static_cast<isobus::task_controller_object::DeviceElementObject &>(object).get_element_number());
+			}
+			break;
+
+			case Field::ParentObject:
+			{
+				retVal = format_reference(static_cast<isobus::task_controller_object::DeviceElementObject &>(object).get_parent_object(), idMap);
+			}
+			break;
+
+			case Field::ChildObjects:
+			{
+				auto &element = static_cast<isobus::task_controller_object::DeviceElementObject &>(object);
+
+				for (std::uint16_t i = 0; i < element.get_number_child_objects(); i++)
+				{
+					if (0 != i)
+					{
+						retVal += ", ";
+					}
+					retVal += format_reference(element.get_child_object_id(i), idMap);
+				}
+			}
+			break;
+
+			case Field::DDI:
+			{
+				retVal = std::to_string(get_ddi(object));
+			}
+			break;
+
+			case Field::PropertiesBitfield:
+			{
+				retVal = format_hex(static_cast<isobus::task_controller_object::DeviceProcessDataObject &>(object).get_properties_bitfield(), 2);
+			}
+			break;
+
+			case Field::TriggerMethodsBitfield:
+			{
+				retVal = format_hex(static_cast<isobus::task_controller_object::DeviceProcessDataObject &>(object).get_trigger_methods_bitfield(), 2);
+			}
+			break;
+
+			case Field::Value:
+			{
+				retVal = std::to_string(static_cast<isobus::task_controller_object::DevicePropertyObject &>(object).get_value());
+			}
+			break;
+
+			case Field::PresentationObject:
+			{
+				if (ObjectTypes::DeviceProcessData == object.get_object_type())
+				{
+					retVal = format_reference(static_cast<isobus::task_controller_object::DeviceProcessDataObject &>(object).get_device_value_presentation_object_id(), idMap);
+				}
+				else
+				{
+					retVal = format_reference(static_cast<isobus::task_controller_object::DevicePropertyObject &>(object).get_device_value_presentation_object_id(), idMap);
+				}
+			}
+			break;
+
+			case Field::Offset:
+			{
+				retVal = std::to_string(static_cast<isobus::task_controller_object::DeviceValuePresentationObject &>(object).get_offset());
+			}
+			break;
+
+			case Field::Scale:
+			{
+				retVal = format_number(static_cast<isobus::task_controller_object::DeviceValuePresentationObject &>(object).get_scale());
+			}
+			break;
+
+			case Field::NumberOfDecimals:
+			{
+				retVal = std::to_string(static_cast<isobus::task_controller_object::DeviceValuePresentationObject &>(object).get_number_of_decimals());
+			}
+			break;
+
+			case Field::Object:
+				break;
+		}
+		return retVal;
+	}
+
+	/// @brief Copies a field from one object to another of the same type, translating references through idMap
+	void set_field(Object &object, Field field, Object &source, const IDMap *idMap)
+	{
+		switch (field)
+		{
+			case Field::Designator:
+			{
+				object.set_designator(source.get_designator());
+			}
+			break;
+
+			case Field::SoftwareVersion:
+			{
+				static_cast<isobus::task_controller_object::DeviceObject &>(object).set_software_version(static_cast<isobus::task_controller_object::DeviceObject &>(source).get_software_version());
+			}
+			break;
+
+			case Field::SerialNumber:
+			{
+				static_cast<isobus::task_controller_object::DeviceObject &>(object).set_serial_number(static_cast<isobus::task_controller_object::DeviceObject &>(source).get_serial_number());
+			}
+			break;
+
+			case Field::StructureLabel:
+			{
+				static_cast<isobus::task_controller_object::DeviceObject &>(object).set_structure_label(static_cast<isobus::task_controller_object::DeviceObject &>(source).get_structure_label());
+			}
+			break;
+
+			case Field::LocalizationLabel:
+			{
+				static_cast<isobus::task_controller_object::DeviceObject &>(object).set_localization_label(static_cast<isobus::task_controller_object::DeviceObject &>(source).get_localization_label());
+			}
+			break;
+
+			case Field::ExtendedStructureLabel:
+			{
+				static_cast<isobus::task_controller_object::DeviceObject &>(object).set_extended_structure_label(static_cast<isobus::task_controller_object::DeviceObject &>(source).get_extended_structure_label());
+			}
+			break;
+
+			case Field::IsoName:
+			{
+				static_cast<isobus::task_controller_object::DeviceObject &>(object).set_iso_name(static_cast<isobus::task_controller_object::DeviceObject &>(source).get_iso_name());
+			}
+			break;
+
+			case Field::ElementNumber:
+			{
+				static_cast<isobus::task_controller_object::DeviceElementObject &>(object).set_element_number(static_cast<isobus::task_controller_object::DeviceElementObject &>(source).get_element_number());
+			}
+			break;
+
+			case Field::ParentObject:
+			{
+				static_cast<isobus::task_controller_object::DeviceElementObject &>(object).set_parent_object(map_reference(static_cast<isobus::task_controller_object::DeviceElementObject &>(source).get_parent_object(), idMap));
+			}
+			break;
+
+			case Field::DDI:
+			{
+				if (ObjectTypes::DeviceProcessData == object.get_object_type())
+				{
+					static_cast<isobus::task_controller_object::DeviceProcessDataObject &>(object).set_ddi(static_cast<isobus::task_controller_object::DeviceProcessDataObject &>(source).get_ddi());
+				}
+				else
+				{
+					static_cast<isobus::task_controller_object::DevicePropertyObject &>(object).set_ddi(static_cast<isobus::task_controller_object::DevicePropertyObject &>(source).get_ddi());
+				}
+			}
+			break;
+
+			case Field::PropertiesBitfield:
+			{
+				static_cast<isobus::task_controller_object::DeviceProcessDataObject &>(object).set_properties_bitfield(static_cast<isobus::task_controller_object::DeviceProcessDataObject &>(source).get_properties_bitfield());
+			}
+			break;
+
+			case Field::TriggerMethodsBitfield:
+			{
+				static_cast<isobus::task_controller_object::DeviceProcessDataObject &>(object).set_trigger_methods_bitfield(static_cast<isobus::task_controller_object::DeviceProcessDataObject &>(source).get_trigger_methods_bitfield());
+			}
+			break;
+
+			case Field::Value:
+			{
+				static_cast<isobus::task_controller_object::DevicePropertyObject &>(object).set_value(static_cast<isobus::task_controller_object::DevicePropertyObject &>(source).get_value());
+			}
+			break;
+
+			case Field::PresentationObject:
+			{
+				if (ObjectTypes::DeviceProcessData == object.get_object_type())
+				{
+					static_cast<isobus::task_controller_object::DeviceProcessDataObject &>(object).set_device_value_presentation_object_id(map_reference(static_cast<isobus::task_controller_object::DeviceProcessDataObject &>(source).get_device_value_presentation_object_id(), idMap));
+				}
+				else
+				{
+					static_cast<isobus::task_controller_object::DevicePropertyObject &>(object).set_device_value_presentation_object_id(map_reference(static_cast<isobus::task_controller_object::DevicePropertyObject &>(source).get_device_value_presentation_object_id(), idMap));
+				}
+			}
+			break;
+
+			case Field::Offset:
+			{
+				static_cast<isobus::task_controller_object::DeviceValuePresentationObject &>(object).set_offset(static_cast<isobus::task_controller_object::DeviceValuePresentationObject &>(source).get_offset());
+			}
+			break;
+
+			case Field::Scale:
+			{
+				static_cast<isobus::task_controller_object::DeviceValuePresentationObject &>(object).set_scale(static_cast<isobus::task_controller_object::DeviceValuePresentationObject &>(source).get_scale());
+			}
+			break;
+
+			case Field::NumberOfDecimals:
+			{
+				static_cast<isobus::task_controller_object::DeviceValuePresentationObject &>(object).set_number_of_decimals(static_cast<isobus::task_controller_object::DeviceValuePresentationObject &>(source).get_number_of_decimals());
+			}
+			break;
+
+			default:
+				break;
+		}
+	}
+
+	/// @brief Adds a copy of an object to a pool under a given ID, translating its references through idMap.
+	/// Device elements are added without their child references.
+	/// @returns The copy, or nullptr if the pool rejected it
+	std::shared_ptr<Object> add_object_with_id(isobus::DeviceDescriptorObjectPool &pool, Object &object, std::uint16_t objectID, const IDMap *idMap)
+	{
+		bool added = false;
+
+		switch (object.get_object_type())
+		{
+			case ObjectTypes::Device:
+			{
+				auto &device = static_cast<isobus::task_controller_object::DeviceObject &>(object);
+				added = pool.add_device(device.get_designator(),
+				                        device.get_software_version(),
+				                        device.get_serial_number(),
+				                        device.get_structure_label(),
+				                        device.get_localization_label(),
+				                        device.get_extended_structure_label(),
+				                        device.get_iso_name());
+			}
+			break;
+
+			case ObjectTypes::DeviceElement:
+			{
+				auto &element = static_cast<isobus::task_controller_object::DeviceElementObject &>(object);
+				added = pool.add_device_element(element.get_designator(),
+				                                element.get_element_number(),
+				                                map_reference(element.get_parent_object(), idMap),
+				                                element.get_type(),
+				                                objectID);
+			}
+			break;
+
+			case ObjectTypes::DeviceProcessData:
+			{
+				auto &processData = static_cast<isobus::task_controller_object::DeviceProcessDataObject &>(object);
+				added = pool.add_device_process_data(processData.get_designator(),
+				                                     processData.get_ddi(),
+				                                     map_reference(processData.get_device_value_presentation_object_id(), idMap),
+				                                     processData.get_properties_bitfield(),
+				                                     processData.get_trigger_methods_bitfield(),
+				                                     objectID);
+			}
+			break;
+
+			case ObjectTypes::DeviceProperty:
+			{
+				auto &property = static_cast<isobus::task_controller_object::DevicePropertyObject &>(object);
+				added = pool.add_device_property(property.get_designator(),
+				                                 property.get_value(),
+				                                 property.get_ddi(),
+				                                 map_reference(property.get_device_value_presentation_object_id(), idMap),
+				                                 objectID);
+			}
+			break;
+
+			case ObjectTypes::DeviceValuePresentation:
+			{
+				auto &presentation = static_cast<isobus::task_controller_object::DeviceValuePresentationObject &>(object);
+				added = pool.add_device_value_presentation(presentation.get_designator(),
+				                                           presentation.get_offset(),
+				                                           presentation.get_scale(),
+				                                           presentation.get_number_of_decimals(),
+				                                           objectID);
+			}
+			break;
+		}
+		return added ? pool.get_object_by_index(pool.size() - 1) : nullptr;
+	}
+
+	std::vector<MatchKey> get_match_keys(isobus::DeviceDescriptorObjectPool &pool)
+	{
+		std::vector<MatchKey> retVal(pool.size());
+		std::vector<std::uint32_t> parentElementNumbers(NUMBER_OF_IDS, NO_PARENT_ELEMENT);
+
+		// Process data and properties are identified by the first element that lists them
+		for (std::uint32_t i = 0; i < pool.size(); i++)
+		{
+			auto object = pool.get_object_by_index(i);
+
+			if (ObjectTypes::DeviceElement == object->get_object_type())
+			{
+				auto element = std::static_pointer_cast<isobus::task_controller_object::DeviceElementObject>(object);
+
+				for (std::uint16_t j = 0; j < element->get_number_child_objects(); j++)
+				{
+					auto &parentElementNumber = parentElementNumbers[element->get_child_object_id(j)];
+
+					if (NO_PARENT_ELEMENT == parentElementNumber)
+					{
+						parentElementNumber = element->get_element_number();
+					}
+				}
+			}
+		}
+
+		for (std::uint32_t i = 0; i < pool.size(); i++)
+		{
+			auto object = pool.get_object_by_index(i);
+			auto &key = retVal[i];
+			key.poolIndex = i;
+			key.objectID = object->get_object_id();
+			key.type = static_cast<std::uint8_t>(object->get_object_type());
+			key.number = 0;
+			key.ddi = 0;
+
+			switch (object->get_object_type())
+			{
+				case ObjectTypes::DeviceElement:
+				{
+					key.number = std::static_pointer_cast<isobus::task_controller_object::DeviceElementObject>(object)->get_element_number();
+				}
+				break;
+
+				case ObjectTypes::DeviceProcessData:
+				case ObjectTypes::DeviceProperty:
+				{
+					key.number = parentElementNumbers[key.objectID];
+					key.ddi = get_ddi(*object);
+				}
+				break;
+
+				case ObjectTypes::DeviceValuePresentation:
+				{
+					for (auto field : get_fields(ObjectTypes::DeviceValuePresentation))
+					{
+						key.content += get_field_value(*object, field, nullptr);
+						key.content += '\n';
+					}
+				}
+				break;
+
+				default:
+					break;
+			}
+		}
+		return retVal;
+	}
+
+	/// @brief Pairs the objects of two pools, first by ID, then by what they are, then by ID again
+	void match_objects(isobus::DeviceDescriptorObjectPool &oldPool, isobus::DeviceDescriptorObjectPool &newPool, IDMap &oldToNew, IDMap &newToOld)
+	{
+		auto oldKeys = get_match_keys(oldPool);
+		auto newKeys = get_match_keys(newPool);
+		std::vector<const MatchKey *> newKeysByID(NUMBER_OF_IDS, nullptr);
+
+		oldToNew.assign(NUMBER_OF_IDS, NULL_OBJECT_ID);
+		newToOld.assign(NUMBER_OF_IDS, NULL_OBJECT_ID);
+
+		for (const auto &key : newKeys)
+		{
+			newKeysByID[key.objectID] = &key;
+		}
+
+		// Objects that kept their ID
+		for (const auto &key : oldKeys)
+		{
+			const MatchKey *newKey = newKeysByID[key.objectID];
+
+			if ((nullptr != newKey) && newKey->has_same_key(key))
+			{
+				oldToNew[key.objectID] = key.objectID;
+				newToOld[key.objectID] = key.objectID;
+			}
+		}
+
+		// Renumbered objects. Within a group of equal keys, objects are paired in pool order.
+		std::vector<const MatchKey *> unpairedOldKeys;
+		std::vector<const MatchKey *> unpairedNewKeys;
+		auto isKeyPointerLess = [](const MatchKey *left, const MatchKey *right) { return *left < *right; };
+
+		for (const auto &key : oldKeys)
+		{
+			if (NULL_OBJECT_ID == oldToNew[key.objectID])
+			{
+				unpairedOldKeys.push_back(&key);
+			}
+		}
+		for (const auto &key : newKeys)
+		{
+			if (NULL_OBJECT_ID == newToOld[key.objectID])
+			{
+				unpairedNewKeys.push_back(&key);
+			}
+		}
+		std::sort(unpairedOldKeys.begin(), unpairedOldKeys.end(), isKeyPointerLess);
+		std::sort(unpairedNewKeys.begin(), unpairedNewKeys.end(), isKeyPointerLess);
+
+		for (std::size_t oldIndex = 0, newIndex = 0; (oldIndex < unpairedOldKeys.size()) && (newIndex < unpairedNewKeys.size());)
+		{
+			const MatchKey &oldKey = *unpairedOldKeys[oldIndex];
+			const MatchKey &newKey = *unpairedNewKeys[newIndex];
+
+			if (is_key_less(oldKey, newKey))
+			{
+				oldIndex++;
+			}
+			else if (is_key_less(newKey, oldKey))
+			{
+				newIndex++;
+			}
+			else
+			{
+				oldToNew[oldKey.objectID] = newKey.objectID;
+				newToOld[newKey.objectID] = oldKey.objectID;
+				oldIndex++;
+				newIndex++;
+			}
+		}
+
+		// Objects that kept their ID but changed what identifies them, such as their DDI
+		for (const auto &key : oldKeys)
+		{
+			const MatchKey *newKey = newKeysByID[key.objectID];
+
+			if ((NULL_OBJECT_ID == oldToNew[key.objectID]) &&
+			    (nullptr != newKey) &&
+			    (NULL_OBJECT_ID == newToOld[key.objectID]) &&
+			    (newKey->type == key.type))
+			{
+				oldToNew[key.objectID] = key.objectID;
+				newToOld[key.objectID] = key.objectID;
+			}
+		}
+	}
+
+	void compare_fields(Object &oldObject, Object &newObject, const IDMap &oldToNew, std::vector<DdopDiff::FieldChange> &fieldChanges)
+	{
+		for (auto field : get_fields(newObject.get_object_type()))
+		{
+			std::string newValue = get_field_value(newObject, field, nullptr);
+
+			if (get_field_value(oldObject, field, &oldToNew) != newValue)
+			{
+				fieldChanges.push_back({ field, get_field_value(oldObject, field, nullptr), newValue });
+			}
+		}
+	}
+
+	bool has_changed(Object &oldObject, Object &newObject, const IDMap &oldToNew)
+	{
+		for (auto field : get_fields(newObject.get_object_type()))
+		{
+			if (get_field_value(oldObject, field, &oldToNew) != get_field_value(newObject, field, nullptr))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+}
+
+std::vector<DdopDiff::ObjectChange> DdopDiff::compare(isobus::DeviceDescriptorObjectPool &oldPool, isobus::DeviceDescriptorObjectPool &newPool)
+{
+	std::vector<ObjectChange> retVal;
+	IDMap oldToNew;
+	IDMap newToOld;
+	auto oldObjects = get_objects_by_id(oldPool);
+
+	match_objects(oldPool, newPool, oldToNew, newToOld);
+
+	for (std::uint32_t i = 0; i < newPool.size(); i++)
+	{
+		auto newObject = newPool.get_object_by_index(i);
+		const std::uint16_t oldObjectID = newToOld[newObject->get_object_id()];
+		ObjectChange change{ ChangeType::Added, newObject->get_table_id(), newObject->get_designator(), oldObjectID, newObject->get_object_id(), {} };
+
+		if (NULL_OBJECT_ID != oldObjectID)
+		{
+			if (oldObjectID != newObject->get_object_id())
+			{
+				change.fieldChanges.push_back({ Field::ObjectID, std::to_string(oldObjectID), std::to_string(newObject->get_object_id()) });
+			}
+			compare_fields(*oldObjects[oldObjectID], *newObject, oldToNew, change.fieldChanges);
+
+			if (change.fieldChanges.empty())
+			{
+				continue;
+			}
+			change.type = ChangeType::Modified;
+		}
+		retVal.push_back(std::move(change));
+	}
+
+	for (std::uint32_t i = 0; i < oldPool.size(); i++)
+	{
+		auto oldObject = oldPool.get_object_by_index(i);
+
+		if (NULL_OBJECT_ID == oldToNew[oldObject->get_object_id()])
+		{
+			retVal.push_back({ ChangeType::Removed, oldObject->get_table_id(), oldObject->get_designator(), oldObject->get_object_id(), NULL_OBJECT_ID, {} });
+		}
+	}
+	return retVal;
+}
+
+bool DdopDiff::merge(isobus::DeviceDescriptorObjectPool &basePool,
+                     isobus::DeviceDescriptorObjectPool &ourPool,
+                     isobus::DeviceDescriptorObjectPool &theirPool,
+                     isobus::DeviceDescriptorObjectPool &mergedPool,
+                     std::vector<Conflict> &conflicts)
+{
+	bool retVal = true;
+	IDMap baseToOurs;
+	IDMap oursToBase;
+	IDMap baseToTheirs;
+	IDMap theirsToBase;
+	IDMap theirsToMerged(NUMBER_OF_IDS, NULL_OBJECT_ID);
+	std::vector<bool> usedIDs(NUMBER_OF_IDS, false);
+	std::vector<bool> deletedIDs(NUMBER_OF_IDS, false);
+	std::vector<bool> keptIDs(NUMBER_OF_IDS, false);
+	auto baseObjects = get_objects_by_id(basePool);
+	auto ourObjects = get_objects_by_id(ourPool);
+	auto theirObjects = get_objects_by_id(theirPool);
+
+	match_objects(basePool, ourPool, baseToOurs, oursToBase);
+	match_objects(basePool, theirPool, baseToTheirs, theirsToBase);
+	conflicts.clear();
+
+	// The merged pool uses our IDs. Objects only they added keep theirs if it's free, and IDs of
+	// base objects we deleted aren't reused, so they can't be mistaken for the deleted object.
+	for (std::uint32_t i = 0; i < ourPool.size(); i++)
+	{
+		usedIDs[ourPool.get_object_by_index(i)->get_object_id()] = true;
+	}
+	for (std::uint32_t i = 0; i < basePool.size(); i++)
+	{
+		usedIDs[basePool.get_object_by_index(i)->get_object_id()] = true;
+	}
+
+	std::uint32_t nextFreeID = 0;
+	for (std::uint32_t i = 0; i < theirPool.size(); i++)
+	{
+		const std::uint16_t theirID = theirPool.get_object_by_index(i)->get_object_id();
+
+		if (NULL_OBJECT_ID != theirsToBase[theirID])
+		{
+			theirsToMerged[theirID] = baseToOurs[theirsToBase[theirID]];
+		}
+		else if (!usedIDs[theirID])
+		{
+			theirsToMerged[theirID] = theirID;
+			usedIDs[theirID] = true;
+		}
+		else
+		{
+			while ((nextFreeID < NULL_OBJECT_ID) && usedIDs[nextFreeID])
+			{
+				nextFreeID++;
+			}
+
+			if (NULL_OBJECT_ID == nextFreeID)
+			{
+				return false;
+			}
+			theirsToMerged[theirID] = static_cast<std::uint16_t>(nextFreeID);
+			usedIDs[nextFreeID] = true;
+		}
+	}
+
+	// Objects deleted on one side stay deleted, unless the other side edited them
+	for (std::uint32_t i = 0; i < basePool.size(); i++)
+	{
+		auto baseObject = basePool.get_object_by_index(i);
+		const std::uint16_t ourID = baseToOurs[baseObject->get_object_id()];
+		const std::uint16_t theirID = baseToTheirs[baseObject->get_object_id()];
+
+		if ((NULL_OBJECT_ID == theirID) && (NULL_OBJECT_ID != ourID))
+		{
+			auto &ourObject = ourObjects[ourID];
+
+			if (has_changed(*baseObject, *ourObject, baseToOurs))
+			{
+				conflicts.push_back({ baseObject->get_table_id(), ourObject->get_designator(), ourID, Field::Object, "present", "modified", "deleted" });
+				keptIDs[ourID] = true;
+			}
+			else
+			{
+				deletedIDs[ourID] = true;
+			}
+		}
+		else if ((NULL_OBJECT_ID == ourID) && (NULL_OBJECT_ID != theirID) && has_changed(*baseObject, *theirObjects[theirID], baseToTheirs))
+		{
+			conflicts.push_back({ baseObject->get_table_id(), baseObject->get_designator(), baseObject->get_object_id(), Field::Object, "present", "deleted", "modified" });
+		}
+	}
+
+	// Our objects, with the fields only they changed taken from theirs
+	for (std::uint32_t i = 0; i < ourPool.size(); i++)
+	{
+		auto ourObject = ourPool.get_object_by_index(i);
+		const std::uint16_t ourID = ourObject->get_object_id();
+		const std::uint16_t baseID = oursToBase[ourID];
+		const std::uint16_t theirID = (NULL_OBJECT_ID != baseID) ? baseToTheirs[baseID] : NULL_OBJECT_ID;
+
+		if (deletedIDs[ourID])
+		{
+			continue;
+		}
+
+		if (NULL_OBJECT_ID == theirID)
+		{
+			auto copy = add_object_with_id(mergedPool, *ourObject, ourID, nullptr);
+
+			if (nullptr == copy)
+			{
+				retVal = false;
+			}
+			else if (ObjectTypes::DeviceElement == ourObject->get_object_type())
+			{
+				auto ourElement = std::static_pointer_cast<isobus::task_controller_object::DeviceElementObject>(ourObject);
+				auto mergedElement = std::static_pointer_cast<isobus::task_controller_object::DeviceElementObject>(copy);
+
+				for (std::uint16_t j = 0; j < ourElement->get_number_child_objects(); j++)
+				{
+					if (!deletedIDs[ourElement->get_child_object_id(j)])
+					{
+						mergedElement->add_reference_to_child_object(ourElement->get_child_object_id(j));
+					}
+				}
+			}
+			continue;
+		}
+
+		auto &baseObject = *baseObjects[baseID];
+		auto &theirObject = *theirObjects[theirID];
+		const auto &fields = get_fields(ourObject->get_object_type());
+		std::vector<bool> takeTheirs(fields.size(), false);
+
+		for (std::size_t j = 0; j < fields.size(); j++)
+		{
+			if (Field::ChildObjects == fields[j])
+			{
+				continue;
+			}
+
+			const std::string baseValue = get_field_value(baseObject, fields[j], &baseToOurs);
+			const std::string ourValue = get_field_value(*ourObject, fields[j], nullptr);
+			const std::string theirValue = get_field_value(theirObject, fields[j], &theirsToMerged);
+
+			if ((theirValue != baseValue) && (theirValue != ourValue))
+			{
+				// Their reference to an object we deleted can't be carried over, so it's a conflict too
+				if ((ourValue == baseValue) && (!is_unpaired_reference(theirObject, fields[j], theirsToMerged)))
+				{
+					takeTheirs[j] = true;
+				}
+				else
+				{
+					conflicts.push_back({ ourObject->get_table_id(), ourObject->get_designator(), ourID, fields[j], get_field_value(baseObject, fields[j], nullptr), ourValue, get_field_value(theirObject, fields[j], nullptr) });
+				}
+			}
+		}
+
+		// An element's type can only be set when it's created, so start from their copy if theirs wins
+		auto typeField = std::find(fields.begin(), fields.end(), Field::ElementType);
+		const bool startFromTheirs = (fields.end() != typeField) && takeTheirs[static_cast<std::size_t>(typeField - fields.begin())];
+		auto copy = startFromTheirs ? add_object_with_id(mergedPool, theirObject, ourID, &theirsToMerged) : add_object_with_id(mergedPool, *ourObject, ourID, nullptr);
+
+		if (nullptr == copy)
+		{
+			retVal = false;
+			continue;
+		}
+
+		for (std::size_t j = 0; j < fields.size(); j++)
+		{
+			if ((Field::ChildObjects != fields[j]) && (Field::ElementType != fields[j]))
+			{
+				if (takeTheirs[j])
+				{
+					set_field(*copy, fields[j], theirObject, &theirsToMerged);
+				}
+				else
+				{
+					set_field(*copy, fields[j], *ourObject, nullptr);
+				}
+			}
+		}
+
+		if (ObjectTypes::DeviceElement == ourObject->get_object_type())
+		{
+			// Child references are merged as sets: ours, minus what they removed, plus what they added
+			auto &baseElement = static_cast<isobus::task_controller_object::DeviceElementObject &>(baseObject);
+			auto &ourElement = static_cast<isobus::task_controller_object::DeviceElementObject &>(*ourObject);
+			auto &theirElement = static_cast<isobus::task_controller_object::DeviceElementObject &>(theirObject);
+			auto &mergedElement = static_cast<isobus::task_controller_object::DeviceElementObject &>(*copy);
+			std::vector<std::uint16_t> baseChildren;
+			std::vector<std::uint16_t> theirChildren;
+			std::vector<std::uint16_t> mergedChildren;
+
+			for (std::uint16_t j = 0; j < baseElement.get_number_child_objects(); j++)
+			{
+				baseChildren.push_back(baseToOurs[baseElement.get_child_object_id(j)]);
+			}
+			for (std::uint16_t j = 0; j < theirElement.get_number_child_objects(); j++)
+			{
+				theirChildren.push_back(theirsToMerged[theirElement.get_child_object_id(j)]);
+			}
+			std::sort(baseChildren.begin(), baseChildren.end());
+			std::sort(theirChildren.begin(), theirChildren.end());
+
+			for (std::uint16_t j = 0; j < theirElement.get_number_child_objects(); j++)
+			{
+				const std::uint16_t theirChildID = theirElement.get_child_object_id(j);
+				const std::uint16_t baseChildID = theirsToBase[theirChildID];
+				bool isBaseChild = false;
+
+				for (std::uint16_t k = 0; (k < baseElement.get_number_child_objects()) && (!isBaseChild); k++)
+				{
+					isBaseChild = (NULL_OBJECT_ID != baseChildID) && (baseChildID == baseElement.get_child_object_id(k));
+				}
+
+				// A child they added that refers to an object we deleted can't be carried over
+				if ((NULL_OBJECT_ID != theirChildID) && (NULL_OBJECT_ID == theirsToMerged[theirChildID]) && (!isBaseChild))
+				{
+					conflicts.push_back({ ourObject->get_table_id(), ourObject->get_designator(), ourID, Field::ChildObjects, "none", "none", std::to_string(theirChildID) });
+				}
+			}
+
+			for (std::uint16_t j = 0; j < ourElement.get_number_child_objects(); j++)
+			{
+				const std::uint16_t childID = ourElement.get_child_object_id(j);
+				// A child they deleted but we edited is kept, so its reference is kept too
+				const bool removedByThem = std::binary_search(baseChildren.begin(), baseChildren.end(), childID) && !std::binary_search(theirChildren.begin(), theirChildren.end(), childID) && (!keptIDs[childID]);
+
+				if ((!removedByThem) && (!deletedIDs[childID]))
+				{
+					mergedChildren.push_back(childID);
+				}
+			}
+
+			for (std::uint16_t j = 0; j < theirElement.get_number_child_objects(); j++)
+			{
+				const std::uint16_t childID = theirsToMerged[theirElement.get_child_object_id(j)];
+
+				if ((NULL_OBJECT_ID != childID) &&
+				    (!std::binary_search(baseChildren.begin(), baseChildren.end(), childID)) &&
+				    (mergedChildren.end() == std::find(mergedChildren.begin(), mergedChildren.end(), childID)))
+				{
+					mergedChildren.push_back(childID);
+				}
+			}
+
+			for (auto childID : mergedChildren)
+			{
+				mergedElement.add_reference_to_child_object(childID);
+			}
+		}
+	}
+
+	// Objects only they added
+	for (std::uint32_t i = 0; i < theirPool.size(); i++)
+	{
+		auto theirObject = theirPool.get_object_by_index(i);
+
+		if (NULL_OBJECT_ID == theirsToBase[theirObject->get_object_id()])
+		{
+			const std::uint16_t mergedID = theirsToMerged[theirObject->get_object_id()];
+			auto copy = add_object_with_id(mergedPool, *theirObject, mergedID, &theirsToMerged);
+
+			for (Field field : get_fields(theirObject->get_object_type()))
+			{
+				// References to objects we deleted were cleared by add_object_with_id
+				if (is_unpaired_reference(*theirObject, field, theirsToMerged))
+				{
+					conflicts.push_back({ theirObject->get_table_id(), theirObject->get_designator(), mergedID, field, "none", "none", get_field_value(*theirObject, field, nullptr) });
+				}
+			}
+
+			if (nullptr == copy)
+			{
+				retVal = false;
+			}
+			else if (ObjectTypes::DeviceElement == theirObject->get_object_type())
+			{
+				auto theirElement = std::static_pointer_cast<isobus::task_controller_object::DeviceElementObject>(theirObject);
+				auto mergedElement = std::static_pointer_cast<isobus::task_controller_object::DeviceElementObject>(copy);
+
+				for (std::uint16_t j = 0; j < theirElement->get_number_child_objects(); j++)
+				{
+					const std::uint16_t theirChildID = theirElement->get_child_object_id(j);
+					const std::uint16_t childID = theirsToMerged[theirChildID];
+
+					if (NULL_OBJECT_ID != childID)
+					{
+						mergedElement->add_reference_to_child_object(childID);
+					}
+					else if (NULL_OBJECT_ID != theirChildID)
+					{
+						conflicts.push_back({ theirObject->get_table_id(), theirObject->get_designator(), mergedID, Field::ChildObjects, "none", "none", std::to_string(theirChildID) });
+					}
+				}
+			}
+		}
+	}
+	return retVal;
+}
+
+const char *DdopDiff::get_field_name(Field field)
+{
+	switch (field)
+	{
+		case Field::ObjectID:
+			return "Object ID";
+		case Field::Designator:
+			return "Designator";
+		case Field::SoftwareVersion:
+			return "Software Version";
+		case Field::SerialNumber:
+			return "Serial Number";
+		case Field::StructureLabel:
+			return "Structure Label";
+		case Field::LocalizationLabel:
+			return "Localization Label";
+		case Field::ExtendedStructureLabel:
+			return "Extended Structure Label";
+		case Field::IsoName:
+			return "ISO NAME";
+		case Field::ElementType:
+			return "Element Type";
+		case Field::ElementNumber:
+			return "Element Number";
+		case Field::ParentObject:
+			return "Parent Object";
+		case Field::ChildObjects:
+			return "Child Objects";
+		case Field::DDI:
+			return "DDI";
+		case Field::PropertiesBitfield:
+			return "Properties";
+		case Field::TriggerMethodsBitfield:
+			return "Trigger Methods";
+		case Field::Value:
+			return "Value";
+		case Field::PresentationObject:
+			return "Presentation Object";
+		case Field::Offset:
+			return "Offset";
+		case Field::Scale:
+			return "Scale";
+		case Field::NumberOfDecimals:
+			return "Number of Decimals";
+		case Field::Object:
+			return "Object";
+	}
+	return "Unknown";
+}
+
+const char *DdopDiff::get_change_type_name(ChangeType type)
+{
+	switch (type)
+	{
+		case ChangeType::Added:
+			return "added";
+		case ChangeType::Removed:
+			return "removed";
+		case ChangeType::Modified:
+			return "modified";
+	}
+	return "unknown";
+}
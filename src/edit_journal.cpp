@@ -0,0 +1,240 @@
+//================================================================================================
+/// @file edit_journal.cpp
+///
+/// @brief Implements an undo/redo history made of field level edits to DDOP objects
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso and the Open-Agriculture developers
+//================================================================================================
+#include "edit_journal.hpp"
+
+#include <utility>
+
+EditJournal::Delta EditJournal::Delta::number(std::uint16_t objectID, Field field, std::int64_t oldValue, std::int64_t newValue)
+{
+	return { objectID, field, 0, oldValue, newValue };
+}
+
+EditJournal::Delta EditJournal::Delta::text(std::uint16_t objectID, Field field, const std::string &oldValue, const std::string &newValue)
+{
+	return { objectID, field, 0, oldValue, newValue };
+}
+
+EditJournal::Delta EditJournal::Delta::scale(std::uint16_t objectID, float oldValue, float newValue)
+{
+	return { objectID, Field::Scale, 0, oldValue, newValue };
+}
+
+EditJournal::Delta EditJournal::Delta::child_reference_added(std::uint16_t elementID, std::uint16_t position, std::uint16_t childID)
+{
+	return { elementID, Field::ChildReference, position, std::monostate(), static_cast<std::int64_t>(childID) };
+}
+
+EditJournal::Delta EditJournal::Delta::child_reference_removed(std::uint16_t elementID, std::uint16_t position, std::uint16_t childID)
+{
+	return { elementID, Field::ChildReference, position, static_cast<std::int64_t>(childID), std::monostate() };
+}
+
+EditJournal::Delta EditJournal::Delta::object_added(const std::shared_ptr<isobus::task_controller_object::Object> &object)
+{
+	return { object->get_object_id(), Field::Object, 0, std::monostate(), object };
+}
+
+EditJournal::Delta EditJournal::Delta::object_removed(const std::shared_ptr<isobus::task_controller_object::Object> &object)
+{
+	return { object->get_object_id(), Field::Object, 0, object, std::monostate() };
+}
+
+EditJournal::EditJournal(std::size_t byteBudget, std::chrono::milliseconds coalesceWindow) :
+  coalesceWindow(coalesceWindow),
+  byteBudget(byteBudget)
+{
+}
+
+void EditJournal::record(Delta delta)
+{
+	if (0 != groupDepth)
+	{
+		openGroup.sizeInBytes += get_size_in_bytes(delta);
+		openGroup.deltas.push_back(std::move(delta));
+	}
+	else if (!try_coalesce(delta))
+	{
+		Entry entry;
+		entry.sizeInBytes = get_size_in_bytes(delta);
+		entry.deltas.push_back(std::move(delta));
+		push_entry(std::move(entry));
+		sealed = false;
+	}
+	lastRecordTime = Clock::now();
+}
+
+void EditJournal::begin_group()
+{
+	groupDepth++;
+}
+
+void EditJournal::end_group()
+{
+	if ((0 != groupDepth) && (0 == --groupDepth) && (!openGroup.deltas.empty()))
+	{
+		push_entry(std::move(openGroup));
+		openGroup = Entry();
+
+		// Don't let a later edit get merged into a group
+		sealed = true;
+	}
+}
+
+void EditJournal::seal()
+{
+	sealed = true;
+}
+
+bool EditJournal::can_undo() const
+{
+	return 0 != numberOfUndoableEntries;
+}
+
+bool EditJournal::can_redo() const
+{
+	return numberOfUndoableEntries < entries.size();
+}
+
+const EditJournal::Entry *EditJournal::undo()
+{
+	const Entry *retVal = nullptr;
+
+	if (can_undo())
+	{
+		numberOfUndoableEntries--;
+		retVal = &entries.at(numberOfUndoableEntries);
+	}
+	sealed = true;
+	return retVal;
+}
+
+const EditJournal::Entry *EditJournal::redo()
+{
+	const Entry *retVal = nullptr;
+
+	if (can_redo())
+	{
+		retVal = &entries.at(numberOfUndoableEntries);
+		numberOfUndoableEntries++;
+	}
+	sealed = true;
+	return retVal;
+}
+
+void EditJournal::clear()
+{
+	entries.clear();
+	openGroup = Entry();
+	totalSizeInBytes = 0;
+	numberOfUndoableEntries = 0;
+	groupDepth = 0;
+	sealed = true;
+}
+
+void EditJournal::set_byte_budget(std::size_t newByteBudget)
+{
+	byteBudget = newByteBudget;
+	trim_to_budget();
+}
+
+std::size_t EditJournal::get_byte_budget() const
+{
+	return byteBudget;
+}
+
+std::size_t EditJournal::get_size_in_bytes() const
+{
+	return totalSizeInBytes;
+}
+
+std::size_t EditJournal::get_size_in_bytes(const Delta &delta)
+{
+	return sizeof(Delta) + get_size_in_bytes(delta.oldValue) + get_size_in_bytes(delta.newValue);
+}
+
+std::size_t EditJournal::get_size_in_bytes(const FieldValue &value)
+{
+	std::size_t retVal = 0;
+
+	if (auto text = std::get_if<std::string>(&value))
+	{
+		retVal = text->capacity();
+	}
+	else if (auto object = std::get_if<std::shared_ptr<isobus::task_controller_object::Object>>(&value))
+	{
+		// A rough guess, the object is kept alive by the journal once it is out of the pool
+		retVal = 128 + (*object)->get_designator().size();
+	}
+	return retVal;
+}
+
+bool EditJournal::try_coalesce(const Delta &delta)
+{
+	bool retVal = false;
+
+	if ((!sealed) &&
+	    (!can_redo()) &&
+	    (!entries.empty()) &&
+	    (1 == entries.back().deltas.size()) &&
+	    ((Clock::now() - lastRecordTime) < coalesceWindow) &&
+	    (Field::ChildReference != delta.field) &&
+	    (Field::Object != delta.field) &&
+	    (Field::ObjectID != delta.field))
+	{
+		auto &lastEntry = entries.back();
+		auto &lastDelta = lastEntry.deltas.front();
+
+		if ((lastDelta.objectID == delta.objectID) && (lastDelta.field == delta.field))
+		{
+			totalSizeInBytes -= lastEntry.sizeInBytes;
+			lastDelta.newValue = delta.newValue;
+
+			if (lastDelta.newValue == lastDelta.oldValue)
+			{
+				// The field is back where it started, so there is nothing left to undo
+				entries.pop_back();
+				numberOfUndoableEntries--;
+				sealed = true;
+			}
+			else
+			{
+				lastEntry.sizeInBytes = get_size_in_bytes(lastDelta);
+				totalSizeInBytes += lastEntry.sizeInBytes;
+			}
+			retVal = true;
+		}
+	}
+	return retVal;
+}
+
+void EditJournal::push_entry(Entry entry)
+{
+	// A new edit makes anything that was undone unreachable
+	while (can_redo())
+	{
+		totalSizeInBytes -= entries.back().sizeInBytes;
+		entries.pop_back();
+	}
+
+	totalSizeInBytes += entry.sizeInBytes;
+	entries.push_back(std::move(entry));
+	numberOfUndoableEntries++;
+	trim_to_budget();
+}
+
+void EditJournal::trim_to_budget()
+{
+	// The newest entry is always kept, so the last edit can be undone however large it was
+	while ((totalSizeInBytes > byteBudget) && (entries.size() > 1) && (0 != numberOfUndoableEntries))
+	{
+		totalSizeInBytes -= entries.front().sizeInBytes;
+		entries.pop_front();
+		numberOfUndoableEntries--;
+	}
+}
@@ -0,0 +1,348 @@
+//================================================================================================
+/// @file frame_profiler.cpp
+///
+/// @brief Implements a profiler that times the expensive parts of each GUI frame
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso and the Open-Agriculture developers
+//================================================================================================
+#include "frame_profiler.hpp"
+#include "imgui.h"
+#include "json_writer.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+
+#ifdef DDOP_PROFILER_COUNT_ALLOCATIONS
+namespace
+{
+	// Only the owning thread touches its counter, so counting costs a single increment
+	thread_local std::uint64_t threadAllocationCount = 0;
+}
+
+// new[] and the nothrow and sized variants all end up in these, so they don't need replacing
+void *operator new(std::size_t size)
+{
+	threadAllocationCount++;
+
+	void *retVal = std::malloc((0 == size) ? 1 : size);
+	while (nullptr == retVal)
+	{
+		std::new_handler handler = std::get_new_handler();
+
+		if (nullptr == handler)
+		{
+			throw std::bad_alloc();
+		}
+		handler();
+		retVal = std::malloc((0 == size) ? 1 : size);
+	}
+	return retVal;
+}
+
+void operator delete(void *pointer) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept
+{
+	std::free(pointer);
+}
+#endif
+
+FrameProfiler::ScopedZone::ScopedZone(FrameProfiler &profiler, Zone zone) :
+  profiler(profiler),
+  startTime(Clock::now()),
+  startAllocations(get_allocation_count()),
+  zone(zone)
+{
+}
+
+FrameProfiler::ScopedZone::~ScopedZone()
+{
+	profiler.end_zone(zone, startTime, startAllocations);
+}
+
+void FrameProfiler::begin_frame()
+{
+	frameStartTime = Clock::now();
+	frameStartAllocations = get_allocation_count();
+	currentFrame = FrameRecord();
+	currentFrame.frameNumber = totalFrames;
+	currentFrame.startTime_us = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(frameStartTime - creationTime).count());
+	inFrame = !paused;
+}
+
+void FrameProfiler::end_frame()
+{
+	totalFrames++;
+
+	if (inFrame)
+	{
+		currentFrame.duration_ms = std::chrono::duration<float, std::milli>(Clock::now() - frameStartTime).count();
+		currentFrame.allocations = static_cast<float>(get_allocation_count() - frameStartAllocations);
+		history[historyIndex] = currentFrame;
+		historyIndex = (historyIndex + 1) % HISTORY_LENGTH;
+		numberOfRecordedFrames = std::min(numberOfRecordedFrames + 1, HISTORY_LENGTH);
+		inFrame = false;
+	}
+}
+
+void FrameProfiler::render_overlay(bool *isOpen)
+{
+	ImGui::SetNextWindowBgAlpha(0.85f);
+	if (ImGui::Begin("Frame Profiler", isOpen, ImGuiWindowFlags_AlwaysAutoResize))
+	{
+		ImGui::Checkbox("Pause recording", &paused);
+		ImGui::SameLine();
+		ImGui::Text("%u of %u frames recorded", static_cast<unsigned int>(numberOfRecordedFrames), static_cast<unsigned int>(HISTORY_LENGTH));
+		if (!is_counting_allocations())
+		{
+			ImGui::TextDisabled("Allocation counting is not enabled in this build");
+		}
+
+		const ImGuiTableFlags tableFlags = ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersOuter | ImGuiTableFlags_BordersV;
+		if (ImGui::BeginTable("##ProfilerZones", 5, tableFlags))
+		{
+			ImGui::TableSetupColumn("Zone");
+			ImGui::TableSetupColumn("Avg / max (ms)");
+			ImGui::TableSetupColumn("Frame time (ms)");
+			ImGui::TableSetupColumn("Avg / max allocs");
+			ImGui::TableSetupColumn("Allocations");
+			ImGui::TableHeadersRow();
+
+			for (std::size_t zoneIndex = 0; zoneIndex <= NUMBER_OF_ZONES; zoneIndex++)
+			{
+				render_zone_row(zoneIndex);
+			}
+			ImGui::EndTable();
+		}
+
+		if (ImGui::Button("Export CSV"))
+		{
+			export_to_file("frame_profile.csv", false);
+		}
+		ImGui::SameLine();
+		if (ImGui::Button("Export Chrome Trace"))
+		{
+			export_to_file("frame_profile.trace.json", true);
+		}
+		if (!exportStatus.empty())
+		{
+			ImGui::TextUnformatted(exportStatus.c_str());
+		}
+	}
+	ImGui::End();
+}
+
+bool FrameProfiler::export_csv(std::ostream &output) const
+{
+	output << "frame,start_us,frame_ms,frame_allocations";
+	for (std::size_t zoneIndex = 0; zoneIndex < NUMBER_OF_ZONES; zoneIndex++)
+	{
+		const char *name = get_zone_name(static_cast<Zone>(zoneIndex));
+		output << ',' << name << "_ms," << name << "_allocations," << name << "_calls";
+	}
+	output << '\n';
+
+	for (std::size_t i = 0; i < numberOfRecordedFrames; i++)
+	{
+		const auto &frame = get_recorded_frame(i);
+
+		output << frame.frameNumber << ',' << frame.startTime_us << ',' << frame.duration_ms << ',' << static_cast<std::uint64_t>(frame.allocations);
+		for (const auto &zone : frame.zones)
+		{
+			output << ',' << zone.duration_ms << ',' << static_cast<std::uint64_t>(zone.allocations) << ',' << zone.calls;
+		}
+		output << '\n';
+	}
+	output.flush();
+	return static_cast<bool>(output);
+}
+
+bool FrameProfiler::export_chrome_trace(std::ostream &output) const
+{
+	JsonWriter json(output);
+
+	// Complete ("X") events, with integer microsecond timestamps so long sessions keep their precision.
+	// Each zone is one event per frame, spanning from its first call to the end of its total time,
+	// which is exact for zones called once a frame.
+	auto writeEvent = [&json](const char *name, std::uint64_t start_us, double duration_us, std::uint64_t frameNumber, float allocations, std::uint32_t calls) {
+		json.begin_object();
+		json.write("name", name);
+		json.write("cat", "frame");
+		json.write("ph", "X");
+		json.write("ts", start_us);
+		json.write("dur", duration_us);
+		json.write("pid", 1);
+		json.write("tid", 1);
+		json.begin_object("args");
+		json.write("frame", frameNumber);
+		json.write("allocations", static_cast<std::uint64_t>(allocations));
+		json.write("calls", calls);
+		json.end_object();
+		json.end_object();
+	};
+
+	json.begin_object();
+	json.write("displayTimeUnit", "ms");
+	json.begin_array("traceEvents");
+	for (std::size_t i = 0; i < numberOfRecordedFrames; i++)
+	{
+		const auto &frame = get_recorded_frame(i);
+
+		writeEvent("Frame", frame.startTime_us, frame.duration_ms * 1000.0, frame.frameNumber, frame.allocations, 1);
+		for (std::size_t zoneIndex = 0; zoneIndex < NUMBER_OF_ZONES; zoneIndex++)
+		{
+			const auto &zone = frame.zones[zoneIndex];
+
+			if (0 != zone.calls)
+			{
+				writeEvent(get_zone_name(static_cast<Zone>(zoneIndex)), frame.startTime_us + static_cast<std::uint64_t>(zone.start_ms * 1000.0f), zone.duration_ms * 1000.0, frame.frameNumber, zone.allocations, zone.calls);
+			}
+		}
+	}
+	json.end_array();
+	json.end_object();
+	output << '\n';
+	output.flush();
+	return static_cast<bool>(output);
+}
+
+const char *FrameProfiler::get_zone_name(Zone zone)
+{
+	const char *retVal = "Unknown";
+
+	switch (zone)
+	{
+		case Zone::ObjectTree:
+		{
+			retVal = "ObjectTree";
+		}
+		break;
+
+		case Zone::AllObjects:
+		{
+			retVal = "AllObjects";
+		}
+		break;
+
+		case Zone::SelectedObjectSettings:
+		{
+			retVal = "SelectedObjectSettings";
+		}
+		break;
+
+		case Zone::Save:
+		{
+			retVal = "Save";
+		}
+		break;
+
+		case Zone::GLRender:
+		{
+			retVal = "GLRender";
+		}
+		break;
+
+		default:
+			break;
+	}
+	return retVal;
+}
+
+std::uint64_t FrameProfiler::get_allocation_count()
+{
+#ifdef DDOP_PROFILER_COUNT_ALLOCATIONS
+	return threadAllocationCount;
+#else
+	return 0;
+#endif
+}
+
+bool FrameProfiler::is_counting_allocations()
+{
+#ifdef DDOP_PROFILER_COUNT_ALLOCATIONS
+	return true;
+#else
+	return false;
+#endif
+}
+
+void FrameProfiler::end_zone(Zone zone, Clock::time_point startTime, std::uint64_t startAllocations)
+{
+	if (inFrame)
+	{
+		auto &sample = currentFrame.zones[static_cast<std::size_t>(zone)];
+
+		if (0 == sample.calls)
+		{
+			sample.start_ms = std::chrono::duration<float, std::milli>(startTime - frameStartTime).count();
+		}
+		sample.duration_ms += std::chrono::duration<float, std::milli>(Clock::now() - startTime).count();
+		sample.allocations += static_cast<float>(get_allocation_count() - startAllocations);
+		sample.calls++;
+	}
+}
+
+const FrameProfiler::FrameRecord &FrameProfiler::get_recorded_frame(std::size_t index) const
+{
+	return history[(historyIndex + HISTORY_LENGTH - numberOfRecordedFrames + index) % HISTORY_LENGTH];
+}
+
+void FrameProfiler::render_zone_row(std::size_t zoneIndex)
+{
+	// The last row is the whole frame. The histograms read straight out of the history with a
+	// stride, so drawing them doesn't copy anything.
+	const bool isWholeFrame = (NUMBER_OF_ZONES == zoneIndex);
+	const float *durations = isWholeFrame ? &history[0].duration_ms : &history[0].zones[zoneIndex].duration_ms;
+	const float *allocations = isWholeFrame ? &history[0].allocations : &history[0].zones[zoneIndex].allocations;
+	const int stride = static_cast<int>(sizeof(FrameRecord));
+	float averageDuration_ms = 0.0f;
+	float maximumDuration_ms = 0.0f;
+	float averageAllocations = 0.0f;
+	float maximumAllocations = 0.0f;
+
+	for (std::size_t i = 0; i < numberOfRecordedFrames; i++)
+	{
+		const auto &frame = get_recorded_frame(i);
+		float duration_ms = isWholeFrame ? frame.duration_ms : frame.zones[zoneIndex].duration_ms;
+		float frameAllocations = isWholeFrame ? frame.allocations : frame.zones[zoneIndex].allocations;
+
+		averageDuration_ms += duration_ms;
+		maximumDuration_ms = std::max(maximumDuration_ms, duration_ms);
+		averageAllocations += frameAllocations;
+		maximumAllocations = std::max(maximumAllocations, frameAllocations);
+	}
+	if (0 != numberOfRecordedFrames)
+	{
+		averageDuration_ms /= static_cast<float>(numberOfRecordedFrames);
+		averageAllocations /= static_cast<float>(numberOfRecordedFrames);
+	}
+
+	ImGui::PushID(static_cast<int>(zoneIndex));
+	ImGui::TableNextRow();
+	ImGui::TableNextColumn();
+	ImGui::TextUnformatted(isWholeFrame ? "Whole frame" : get_zone_name(static_cast<Zone>(zoneIndex)));
+	ImGui::TableNextColumn();
+	ImGui::Text("%.3f / %.3f", averageDuration_ms, maximumDuration_ms);
+	ImGui::TableNextColumn();
+	ImGui::PlotHistogram("##Durations", durations, static_cast<int>(HISTORY_LENGTH), static_cast<int>(historyIndex), nullptr, 0.0f, std::max(maximumDuration_ms, 0.1f), ImVec2(160, 30), stride);
+	ImGui::TableNextColumn();
+	ImGui::Text("%.1f / %.0f", averageAllocations, maximumAllocations);
+	ImGui::TableNextColumn();
+	ImGui::PlotHistogram("##Allocations", allocations, static_cast<int>(HISTORY_LENGTH), static_cast<int>(historyIndex), nullptr, 0.0f, std::max(maximumAllocations, 1.0f), ImVec2(160, 30), stride);
+	ImGui::PopID();
+}
+
+void FrameProfiler::export_to_file(const std::string &fileName, bool chromeTrace)
+{
+	std::ofstream outputFile(fileName, std::ios::out | std::ios::trunc);
+	bool exported = outputFile.is_open() && (chromeTrace ? export_chrome_trace(outputFile) : export_csv(outputFile));
+
+	exportStatus = (exported ? "Wrote " : "Failed to write ") + fileName;
+}
@@ -0,0 +1,143 @@
+//================================================================================================
+/// @file frame_scheduler.cpp
+///
+/// @brief Implements a scheduler that only renders frames when the GUI might have changed
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso and the Open-Agriculture developers
+//================================================================================================
+#include "frame_scheduler.hpp"
+#include "imgui.h"
+
+#include <algorithm>
+
+bool FrameScheduler::wait_for_event(SDL_Event &event)
+{
+	bool retVal = false;
+
+	if ((!settings.idleWhenInactive) || (0 != pendingFrames))
+	{
+		retVal = (0 != SDL_PollEvent(&event));
+	}
+	else
+	{
+		auto waitStartTime = Clock::now();
+
+		if (0 == settings.keepAliveInterval_ms)
+		{
+			retVal = (0 != SDL_WaitEvent(&event));
+		}
+		else
+		{
+			retVal = (0 != SDL_WaitEventTimeout(&event, static_cast<int>(settings.keepAliveInterval_ms)));
+			waitTimedOut = !retVal;
+		}
+		idleTimeInRateWindow += Clock::now() - waitStartTime;
+		totalWakeups++;
+	}
+	return retVal;
+}
+
+void FrameScheduler::on_event()
+{
+	pendingFrames = std::max(pendingFrames, settings.settleFrames);
+}
+
+void FrameScheduler::request_frames(std::uint32_t numberOfFrames)
+{
+	pendingFrames = std::max(pendingFrames, numberOfFrames);
+}
+
+bool FrameScheduler::should_render_frame()
+{
+	bool retVal = (!settings.idleWhenInactive) || (0 != pendingFrames) || waitTimedOut;
+
+	waitTimedOut = false;
+	if (!retVal)
+	{
+		update_rates(Clock::now());
+	}
+	return retVal;
+}
+
+void FrameScheduler::begin_frame()
+{
+	frameStartTime = Clock::now();
+}
+
+void FrameScheduler::end_frame()
+{
+	auto now = Clock::now();
+
+	frameTimeHistory_ms[frameHistoryIndex] = std::chrono::duration<float, std::milli>(now - frameStartTime).count();
+	frameHistoryIndex = (frameHistoryIndex + 1) % FRAME_HISTORY_LENGTH;
+	totalFramesRendered++;
+	framesInRateWindow++;
+
+	if (0 != pendingFrames)
+	{
+		pendingFrames--;
+	}
+	update_rates(now);
+}
+
+void FrameScheduler::render_statistics_window(bool *isOpen)
+{
+	float averageFrameTime_ms = 0.0f;
+	float maximumFrameTime_ms = 0.0f;
+
+	for (float frameTime_ms : frameTimeHistory_ms)
+	{
+		averageFrameTime_ms += frameTime_ms;
+		maximumFrameTime_ms = std::max(maximumFrameTime_ms, frameTime_ms);
+	}
+	averageFrameTime_ms /= static_cast<float>(FRAME_HISTORY_LENGTH);
+
+	ImGui::SetNextWindowBgAlpha(0.85f);
+	if (ImGui::Begin("Frame Statistics", isOpen, ImGuiWindowFlags_AlwaysAutoResize))
+	{
+		ImGui::Text("Frames per second: %.1f", framesPerSecond);
+		ImGui::Text("Time spent idle: %.1f%%", idlePercentage);
+		ImGui::Text("Frame time (avg / max): %.2f / %.2f ms", averageFrameTime_ms, maximumFrameTime_ms);
+		ImGui::Text("Frames rendered: %llu", static_cast<unsigned long long>(totalFramesRendered));
+		ImGui::Text("Idle wakeups: %llu", static_cast<unsigned long long>(totalWakeups));
+		ImGui::PlotLines("##FrameTimes", frameTimeHistory_ms.data(), static_cast<int>(FRAME_HISTORY_LENGTH), static_cast<int>(frameHistoryIndex), "Frame time (ms)", 0.0f, std::max(maximumFrameTime_ms, 16.7f), ImVec2(0, 60));
+
+		ImGui::SeparatorText("Settings");
+		ImGui::Checkbox("Sleep when idle", &settings.idleWhenInactive);
+
+		int settleFrames = static_cast<int>(settings.settleFrames);
+		if (ImGui::SliderInt("Settle frames", &settleFrames, 1, 30))
+		{
+			settings.settleFrames = static_cast<std::uint32_t>(settleFrames);
+		}
+
+		int keepAliveInterval_ms = static_cast<int>(settings.keepAliveInterval_ms);
+		if (ImGui::SliderInt("Keep alive (ms)", &keepAliveInterval_ms, 0, 5000))
+		{
+			settings.keepAliveInterval_ms = static_cast<std::uint32_t>(keepAliveInterval_ms);
+		}
+	}
+	ImGui::End();
+}
+
+FrameScheduler::Settings &FrameScheduler::get_settings()
+{
+	return settings;
+}
+
+void FrameScheduler::update_rates(Clock::time_point now)
+{
+	auto elapsedTime = now - rateWindowStartTime;
+
+	if (elapsedTime >= std::chrono::seconds(1))
+	{
+		float elapsedSeconds = std::chrono::duration<float>(elapsedTime).count();
+
+		framesPerSecond = static_cast<float>(framesInRateWindow) / elapsedSeconds;
+		idlePercentage = 100.0f * std::chrono::duration<float>(idleTimeInRateWindow).count() / elapsedSeconds;
+		framesInRateWindow = 0;
+		idleTimeInRateWindow = Clock::duration::zero();
+		rateWindowStartTime = now;
+	}
+}
@@ -13,15 +13,22 @@
 #include "imgui.h"
 #include "imgui_impl_opengl3.h"
 #include "imgui_impl_sdl2.h"
-#include "isobus/utility/iop_file_interface.hpp"
+#include "iso_xml_writer.hpp"
 #include "isobus/isobus/isobus_data_dictionary.hpp"
 #include "logsink.hpp"
+#include "mapped_file.hpp"
+#include "object_copy.hpp"
 
+#include <algorithm>
+#include <cctype>
 #include <cerrno>
+#include <cstdint>
 #include <cstdio>
 #include <cstring>
 #include <fstream>
+#include <limits>
 #include <sstream>
+#include <unordered_set>
 
 void DDOPGeneratorGUI::start()
 {
@@ -113,10 +120,13 @@ void DDOPGeneratorGUI::start()
 		// - When io.WantCaptureMouse is true, do not dispatch mouse input data to your main application, or clear/overwrite your copy of the mouse data.
 		// - When io.WantCaptureKeyboard is true, do not dispatch keyboard input data to your main application, or clear/overwrite your copy of the keyboard data.
 		// Generally you may always pass all inputs to dear imgui, and hide them from your application based on those two flags.
+		// When nothing is happening, this blocks until the next event instead of spinning
 		SDL_Event lEvent;
-		while (0 != SDL_PollEvent(&lEvent))
+		bool hasEvent = frameScheduler.wait_for_event(lEvent);
+		while (hasEvent)
 		{
 			ImGui_ImplSDL2_ProcessEvent(&lEvent);
+			frameScheduler.on_event();
 			if (SDL_QUIT == lEvent.type)
 			{
 				shouldExit = true;
@@ -127,14 +137,42 @@ void DDOPGeneratorGUI::start()
 			{
 				shouldExit = true;
 			}
+			hasEvent = (0 != SDL_PollEvent(&lEvent));
 		}
 
+		if (shouldExit || !frameScheduler.should_render_frame())
+		{
+			continue;
+		}
+		frameScheduler.begin_frame();
+		frameProfiler.begin_frame();
+
 		// Start the Dear ImGui frame
 		ImGui_ImplOpenGL3_NewFrame();
 		ImGui_ImplSDL2_NewFrame();
 		ImGui::NewFrame();
 
 		// GUI Main Code:
+		if ((nullptr != currentObjectPool) && currentPoolValid && lIO.KeyCtrl && (!lIO.WantTextInput))
+		{
+			// Text boxes have their own undo, so the shortcuts only apply outside of them
+			if (ImGui::IsKeyPressed(ImGuiKey_Z, false))
+			{
+				if (lIO.KeyShift)
+				{
+					redo_edit();
+				}
+				else
+				{
+					undo_edit();
+				}
+			}
+			else if (ImGui::IsKeyPressed(ImGuiKey_Y, false))
+			{
+				redo_edit();
+			}
+		}
+
 		bool prevSaveAsModalState = saveAsModal;
 		bool prevSaveModalState = saveModal;
 		shouldExit = render_menu_bar();
@@ -158,9 +196,26 @@ void DDOPGeneratorGUI::start()
 
 		render_save();
 
+		if (showFrameStatistics)
+		{
+			frameScheduler.render_statistics_window(&showFrameStatistics);
+		}
+
+		if (showFrameProfiler)
+		{
+			frameProfiler.render_overlay(&showFrameProfiler);
+		}
+
 		if ((nullptr != currentObjectPool) && currentPoolValid)
 		{
 			// A pool is being worked on
+			backgroundValidator.update(*currentObjectPool);
+			if (backgroundValidator.is_busy())
+			{
+				// Keep drawing until the validation of the latest edit comes back
+				frameScheduler.request_frames(1);
+			}
+
 			ImGui::SetNextWindowSize({ lIO.DisplaySize.x, lIO.DisplaySize.y - 20 });
 			ImGui::SetNextWindowPos({ 0, 18 });
 			ImGui::Begin("DDOP", NULL, ImGuiWindowFlags_NoCollapse);
@@ -169,6 +224,7 @@ void DDOPGeneratorGUI::start()
 			{
 				ImGui::BeginChild("ChildL", ImVec2(ImGui::GetContentRegionAvail().x * 0.5f, ImGui::GetContentRegionAvail().y), false);
 				ImGui::SeparatorText("Object Tree");
+				render_validation_status();
 				render_object_tree();
 				render_all_objects();
 				ImGui::EndChild();
@@ -179,7 +235,7 @@ void DDOPGeneratorGUI::start()
 				if (0xFFFF != selectedObjectID)
 				{
 					ImGui::SeparatorText("Edit Selected Object");
-					auto selectedObject = currentObjectPool->get_object_by_id(selectedObjectID);
+					auto selectedObject = objectTreeIndex.get_object(selectedObjectID);
 					if (nullptr != selectedObject)
 					{
 						ImGui::Text("Object Type: ");
@@ -193,31 +249,18 @@ void DDOPGeneratorGUI::start()
 						if ((selectedObject->get_object_type() != isobus::task_controller_object::ObjectTypes::Device) &&
 						    ImGui::Button("Delete Object"))
 						{
-							std::uint16_t idOfDeletedObject = selectedObject->get_object_id();
-							currentObjectPool->remove_object_by_id(selectedObject->get_object_id());
-
-							// Prune all other references to this object
-							for (std::uint32_t i = 0; i < currentObjectPool->size(); i++)
+							delete_objects({ selectedObject->get_object_id() });
+						}
+						if (isobus::task_controller_object::ObjectTypes::DeviceElement == selectedObject->get_object_type())
+						{
+							ImGui::SameLine();
+							if (ImGui::Button("Delete Element and Children"))
+							{
+								delete_objects(get_element_subtree(selectedObject->get_object_id()));
+							}
+							if (ImGui::IsItemHovered())
 							{
-								auto objectToProcess = currentObjectPool->get_object_by_index(i);
-
-								if ((nullptr != objectToProcess) &&
-								    (isobus::task_controller_object::ObjectTypes::DeviceElement == objectToProcess->get_object_type()))
-								{
-									auto element = std::dynamic_pointer_cast<isobus::task_controller_object::DeviceElementObject>(objectToProcess);
-
-									for (std::size_t j = 0; j < element->get_number_child_objects(); j++)
-									{
-										if (element->get_child_object_id(j) != idOfDeletedObject)
-										{
-											element->remove_reference_to_child_object(idOfDeletedObject);
-										}
-										if (element->get_parent_object() == idOfDeletedObject)
-										{
-											element->set_parent_object(0xFFFF);
-										}
-									}
-								}
+								ImGui::SetTooltip("Also deletes all child elements, and any process data or properties only they refer to");
 							}
 						}
 						ImGui::PopStyleColor(3);
@@ -230,13 +273,19 @@ void DDOPGeneratorGUI::start()
 		}
 
 		// Rendering
-		ImGui::Render();
-		glViewport(0, 0, static_cast<int>(lIO.DisplaySize.x), static_cast<int>(lIO.DisplaySize.y));
-		glClearColor(lClearColor.x * lClearColor.w, lClearColor.y * lClearColor.w, lClearColor.z * lClearColor.w, lClearColor.w);
-		glClear(GL_COLOR_BUFFER_BIT);
-		ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+		{
+			// The swap is left out, since with vsync it mostly measures waiting for the display
+			FrameProfiler::ScopedZone profilerZone(frameProfiler, FrameProfiler::Zone::GLRender);
+			ImGui::Render();
+			glViewport(0, 0, static_cast<int>(lIO.DisplaySize.x), static_cast<int>(lIO.DisplaySize.y));
+			glClearColor(lClearColor.x * lClearColor.w, lClearColor.y * lClearColor.w, lClearColor.z * lClearColor.w, lClearColor.w);
+			glClear(GL_COLOR_BUFFER_BIT);
+			ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+		}
 
 		SDL_GL_SwapWindow(lpWindow);
+		frameScheduler.end_frame();
+		frameProfiler.end_frame();
 	}
 
 	// Cleanup
@@ -281,6 +330,7 @@ bool DDOPGeneratorGUI::render_menu_bar()
 				                              std::array<std::uint8_t, 7>(),
 				                              std::vector<std::uint8_t>(),
 				                              0);
+				rebuild_object_indexes();
 			}
 			if (ImGui::MenuItem("Open", "Load a DDOP from a file"))
 			{
@@ -322,6 +372,7 @@ bool DDOPGeneratorGUI::render_menu_bar()
 			{
 				lastFileName.clear();
 				currentObjectPool.reset();
+				rebuild_object_indexes();
 				currentPoolValid = false;
 			}
 			else if (!currentPoolValid)
@@ -338,13 +389,27 @@ bool DDOPGeneratorGUI::render_menu_bar()
 				ImGui::BeginDisabled();
 			}
 
+			if (ImGui::MenuItem("Undo", "Ctrl+Z", false, editJournal.can_undo()))
+			{
+				undo_edit();
+			}
+			if (ImGui::MenuItem("Redo", "Ctrl+Y", false, editJournal.can_redo()))
+			{
+				redo_edit();
+			}
+			ImGui::Separator();
+
 			if (true == ImGui::MenuItem("Check for Errors", "Serialize the DDOP and display detected errors"))
 			{
 				if ((nullptr != currentObjectPool) && currentPoolValid)
 				{
 					std::vector<std::uint8_t> binaryDDOP;
-					logger.logHistory.clear();
-					auto serializationSuccess = currentObjectPool->generate_binary_object_pool(binaryDDOP);
+					operationLog.clear();
+					ScopedLogContext logScope(operationLog);
+
+					// Only the full path validates references, so an explicit check never reuses the cache
+					ddopSerializer.invalidate();
+					auto serializationSuccess = ddopSerializer.serialize(*currentObjectPool, binaryDDOP);
 
 					if (serializationSuccess)
 					{
@@ -374,6 +439,8 @@ bool DDOPGeneratorGUI::render_menu_bar()
 			{
 				currentObjectPool->add_device_element("Designator", 0, 0xFFFF, isobus::task_controller_object::DeviceElementObject::Type::Function, get_first_unused_id());
 				auto newObject = currentObjectPool->get_object_by_index(currentObjectPool->size() - 1);
+				on_object_added(newObject);
+				editJournal.record(EditJournal::Delta::object_added(newObject));
 				on_selected_object_changed(newObject);
 				selectedObjectID = newObject->get_object_id();
 			}
@@ -381,6 +448,8 @@ bool DDOPGeneratorGUI::render_menu_bar()
 			{
 				currentObjectPool->add_device_process_data("Designator", 0, 0xFFFF, 0, 0, get_first_unused_id());
 				auto newObject = currentObjectPool->get_object_by_index(currentObjectPool->size() - 1);
+				on_object_added(newObject);
+				editJournal.record(EditJournal::Delta::object_added(newObject));
 				on_selected_object_changed(newObject);
 				selectedObjectID = newObject->get_object_id();
 			}
@@ -388,6 +457,8 @@ bool DDOPGeneratorGUI::render_menu_bar()
 			{
 				currentObjectPool->add_device_property("Designator", 0, 0, 0xFFFF, get_first_unused_id());
 				auto newObject = currentObjectPool->get_object_by_index(currentObjectPool->size() - 1);
+				on_object_added(newObject);
+				editJournal.record(EditJournal::Delta::object_added(newObject));
 				on_selected_object_changed(newObject);
 				selectedObjectID = newObject->get_object_id();
 			}
@@ -395,6 +466,8 @@ bool DDOPGeneratorGUI::render_menu_bar()
 			{
 				currentObjectPool->add_device_value_presentation("Designator", 0, 0.0f, 0, get_first_unused_id());
 				auto newObject = currentObjectPool->get_object_by_index(currentObjectPool->size() - 1);
+				on_object_added(newObject);
+				editJournal.record(EditJournal::Delta::object_added(newObject));
 				on_selected_object_changed(newObject);
 				selectedObjectID = newObject->get_object_id();
 			}
@@ -406,6 +479,14 @@ bool DDOPGeneratorGUI::render_menu_bar()
 			ImGui::EndDisabled();
 		}
 
+		if (true == ImGui::BeginMenu("View"))
+		{
+			ImGui::MenuItem("Frame Statistics", nullptr, &showFrameStatistics);
+			ImGui::MenuItem("Frame Profiler", nullptr, &showFrameProfiler);
+			ImGui::MenuItem("Sleep When Idle", nullptr, &frameScheduler.get_settings().idleWhenInactive);
+			ImGui::EndMenu();
+		}
+
 		if (true == ImGui::BeginMenu("About"))
 		{
 			ImGui::EndMenu();
@@ -450,10 +531,7 @@ bool DDOPGeneratorGUI::render_menu_bar()
 		ImGui::Text("Serialization errors detected.");
 		ImGui::Separator();
 
-		for (auto &logString : logger.logHistory)
-		{
-			ImGui::Text("%s", logString.logText.c_str());
-		}
+		render_operation_log();
 
 		ImGui::SetItemDefaultFocus();
 		if (ImGui::Button("OK", ImVec2(120, 0)))
@@ -468,8 +546,9 @@ bool DDOPGeneratorGUI::render_menu_bar()
 		ImGui::Separator();
 
 		selectedObjectID = 0;
-		on_selected_object_changed(currentObjectPool->get_object_by_index(0));
-		render_device_settings(std::dynamic_pointer_cast<isobus::task_controller_object::DeviceObject>(currentObjectPool->get_object_by_index(0)));
+		ObjectView device = currentObjectPool->get_object_by_index(0);
+		on_selected_object_changed(device);
+		render_current_selected_object_settings(device);
 		ImGui::Separator();
 
 		ImGui::SetItemDefaultFocus();
@@ -510,12 +589,14 @@ void DDOPGeneratorGUI::render_open_file_menu()
 
 		if (!selectedFileToRead.empty())
 		{
-			loadedIopData = isobus::IOPFileInterface::read_iop_file(selectedFileToRead);
+			// Parse straight out of a read-only mapping of the file instead of copying it into memory first
+			MappedFile iopFile(selectedFileToRead);
 
-			if (!loadedIopData.empty())
+			if (iopFile.is_open() && (iopFile.get_size() <= UINT32_MAX))
 			{
 				selectedObjectID = 0xFFFF;
-				logger.logHistory.clear();
+				operationLog.clear();
+				ScopedLogContext logScope(operationLog);
 				currentObjectPool.reset();
 				currentObjectPool = std::make_unique<isobus::DeviceDescriptorObjectPool>();
 
@@ -528,15 +609,20 @@ void DDOPGeneratorGUI::render_open_file_menu()
 					currentObjectPool->set_task_controller_compatibility_level(4);
 				}
 
-				if (true == currentObjectPool->deserialize_binary_object_pool(loadedIopData, isobus::NAME(0)))
+				bool deserialized = currentObjectPool->deserialize_binary_object_pool(iopFile.get_data(), static_cast<std::uint32_t>(iopFile.get_size()), isobus::NAME(0));
+				iopFile.close();
+
+				if (true == deserialized)
 				{
 					// Valid pool?
 					currentPoolValid = true;
 					lastFileName = selectedFileToRead;
+					rebuild_object_indexes();
 				}
 				else
 				{
 					currentObjectPool.reset();
+					rebuild_object_indexes();
 					currentPoolValid = false;
 
 					ImGui::OpenPopup("Error Loading DDOP");
@@ -554,10 +640,7 @@ void DDOPGeneratorGUI::render_open_file_menu()
 		ImGui::Text("There were errors loading the DDOP. Make sure you selected the correct TC version.");
 		ImGui::Separator();
 
-		for (auto &logString : logger.logHistory)
-		{
-			ImGui::Text("%s", logString.logText.c_str());
-		}
+		render_operation_log();
 
 		ImGui::SetItemDefaultFocus();
 		if (ImGui::Button("OK", ImVec2(120, 0)))
@@ -570,57 +653,55 @@ void DDOPGeneratorGUI::render_open_file_menu()
 
 void DDOPGeneratorGUI::parseElementChildrenOfElement(std::uint16_t aObjectID)
 {
-	// Search device elements for all elements that refer to aObjectID their parent
-	for (std::uint32_t k = 0; k < currentObjectPool->size(); k++)
+	// Render every device element that refers to aObjectID as its parent
+	for (auto &currentElement : objectTreeIndex.get_child_elements(aObjectID))
 	{
-		auto currentObject = currentObjectPool->get_object_by_index(k);
-
-		if ((isobus::task_controller_object::ObjectTypes::DeviceElement == currentObject->get_object_type()) &&
-		    (nullptr != std::dynamic_pointer_cast<isobus::task_controller_object::DeviceElementObject>(currentObject)) &&
-		    (std::dynamic_pointer_cast<isobus::task_controller_object::DeviceElementObject>(currentObject)->get_parent_object() == aObjectID))
+		if (!is_visible_in_object_tree(currentElement->get_object_id()))
 		{
-			auto currentElement = std::dynamic_pointer_cast<isobus::task_controller_object::DeviceElementObject>(currentObject);
-			std::string elementType = get_element_type_string(currentElement->get_type());
+			continue;
+		}
 
-			ImGuiTreeNodeFlags rootElementFlags = ImGuiTreeNodeFlags_OpenOnArrow | ImGuiTreeNodeFlags_OpenOnDoubleClick | ImGuiTreeNodeFlags_SpanAvailWidth;
-			if (selectedObjectID == currentElement->get_object_id())
-			{
-				rootElementFlags |= ImGuiTreeNodeFlags_Selected;
-			}
+		ImGuiTreeNodeFlags rootElementFlags = ImGuiTreeNodeFlags_OpenOnArrow | ImGuiTreeNodeFlags_OpenOnDoubleClick | ImGuiTreeNodeFlags_SpanAvailWidth;
+		if (selectedObjectID == currentElement->get_object_id())
+		{
+			rootElementFlags |= ImGuiTreeNodeFlags_Selected;
+		}
 
-			ImGui::Indent();
-			bool isElementOpen = ImGui::TreeNodeEx((get_object_display_name(currentElement) + " (" + currentElement->get_table_id() + " " + std::to_string(currentElement->get_object_id()) + ")").c_str(), rootElementFlags);
-			ImGui::Unindent();
+		ImGui::Indent();
+		open_if_object_tree_ancestor(currentElement->get_object_id());
+		bool hasIssues = push_object_issue_style(currentElement->get_object_id());
+		bool isElementOpen = ImGui::TreeNodeEx(get_object_label(currentElement).c_str(), rootElementFlags);
+		pop_object_issue_style(hasIssues, currentElement->get_object_id());
+		ImGui::Unindent();
 
-			if (ImGui::IsItemClicked() && !ImGui::IsItemToggledOpen())
-			{
-				selectedObjectID = currentElement->get_object_id();
-				on_selected_object_changed(currentElement);
-			}
+		if (ImGui::IsItemClicked() && !ImGui::IsItemToggledOpen())
+		{
+			selectedObjectID = currentElement->get_object_id();
+			on_selected_object_changed(currentElement);
+		}
 
-			if (isElementOpen)
-			{
-				render_device_element_components(currentElement);
+		if (isElementOpen)
+		{
+			render_device_element_components(*currentElement);
 
-				parseChildren(currentElement);
-				ImGui::TreePop();
+			parseChildren(*currentElement);
+			ImGui::TreePop();
 
-				ImGui::Indent();
-				parseElementChildrenOfElement(currentElement->get_object_id());
-				ImGui::Unindent();
-			}
+			ImGui::Indent();
+			parseElementChildrenOfElement(currentElement->get_object_id());
+			ImGui::Unindent();
 		}
 	}
 }
 
-void DDOPGeneratorGUI::parseChildren(std::shared_ptr<isobus::task_controller_object::DeviceElementObject> element)
+void DDOPGeneratorGUI::parseChildren(isobus::task_controller_object::DeviceElementObject &element)
 {
-	for (std::uint32_t c = 0; c < element->get_number_child_objects(); c++)
+	for (std::uint32_t c = 0; c < element.get_number_child_objects(); c++)
 	{
 		ImGuiTreeNodeFlags childFlags = ImGuiTreeNodeFlags_OpenOnArrow | ImGuiTreeNodeFlags_OpenOnDoubleClick | ImGuiTreeNodeFlags_SpanAvailWidth;
-		auto currentChild = currentObjectPool->get_object_by_id(element->get_child_object_id(c));
+		ObjectView currentChild = objectTreeIndex.get_object_view(element.get_child_object_id(c));
 
-		if (nullptr != currentChild)
+		if (currentChild.is_valid() && is_visible_in_object_tree(currentChild->get_object_id()))
 		{
 			if (selectedObjectID == currentChild->get_object_id())
 			{
@@ -629,10 +710,13 @@ void DDOPGeneratorGUI::parseChildren(std::shared_ptr<isobus::task_controller_obj
 
 			bool isChildOpen = false;
 
-			if (currentChild->get_object_type() != isobus::task_controller_object::ObjectTypes::DeviceElement)
+			if (currentChild.get_type() != isobus::task_controller_object::ObjectTypes::DeviceElement)
 			{
 				ImGui::Indent();
-				isChildOpen = ImGui::TreeNodeEx((get_object_display_name(currentChild) + " (" + currentChild->get_table_id() + " " + std::to_string(currentChild->get_object_id()) + ")").c_str(), childFlags);
+				open_if_object_tree_ancestor(currentChild->get_object_id());
+				bool hasIssues = push_object_issue_style(currentChild->get_object_id());
+				isChildOpen = ImGui::TreeNodeEx(get_object_label(currentChild).c_str(), childFlags);
+				pop_object_issue_style(hasIssues, currentChild->get_object_id());
 				ImGui::Unindent();
 
 				if (ImGui::IsItemClicked() && !ImGui::IsItemToggledOpen())
@@ -644,17 +728,13 @@ void DDOPGeneratorGUI::parseChildren(std::shared_ptr<isobus::task_controller_obj
 
 			if (isChildOpen)
 			{
-				if (isobus::task_controller_object::ObjectTypes::DeviceProcessData == currentChild->get_object_type())
+				if (auto currentDPD = currentChild.as_process_data())
 				{
-					auto currentDPD = std::dynamic_pointer_cast<isobus::task_controller_object::DeviceProcessDataObject>(currentChild);
-
-					render_device_process_data_components(currentDPD);
+					render_device_process_data_components(*currentDPD);
 				}
-				else if (isobus::task_controller_object::ObjectTypes::DeviceProperty == currentChild->get_object_type())
+				else if (auto lpDPT = currentChild.as_property())
 				{
-					auto lpDPT = std::dynamic_pointer_cast<isobus::task_controller_object::DevicePropertyObject>(currentChild);
-
-					render_device_property_components(lpDPT);
+					render_device_property_components(*lpDPT);
 				}
 				ImGui::TreePop();
 			}
@@ -664,115 +744,272 @@ void DDOPGeneratorGUI::parseChildren(std::shared_ptr<isobus::task_controller_obj
 
 void DDOPGeneratorGUI::render_object_tree()
 {
-	for (std::uint32_t j = 0; j < currentObjectPool->size(); j++)
+	FrameProfiler::ScopedZone profilerZone(frameProfiler, FrameProfiler::Zone::ObjectTree);
+
+	render_object_tree_filter();
+
+	auto &lpObject = objectTreeIndex.get_device();
+
+	if ((nullptr != lpObject) && is_visible_in_object_tree(lpObject->get_object_id()))
 	{
-		auto lpObject = currentObjectPool->get_object_by_index(j);
+		ImGuiTreeNodeFlags base_flags = ImGuiTreeNodeFlags_OpenOnArrow | ImGuiTreeNodeFlags_OpenOnDoubleClick | ImGuiTreeNodeFlags_SpanAvailWidth;
 
-		if (nullptr != lpObject)
+		if (selectedObjectID == lpObject->get_object_id())
 		{
-			if (isobus::task_controller_object::ObjectTypes::Device == lpObject->get_object_type())
-			{
-				ImGuiTreeNodeFlags base_flags = ImGuiTreeNodeFlags_OpenOnArrow | ImGuiTreeNodeFlags_OpenOnDoubleClick | ImGuiTreeNodeFlags_SpanAvailWidth;
+			base_flags |= ImGuiTreeNodeFlags_Selected;
+		}
 
-				if (selectedObjectID == lpObject->get_object_id())
-				{
-					base_flags |= ImGuiTreeNodeFlags_Selected;
-				}
+		open_if_object_tree_ancestor(lpObject->get_object_id());
+		bool hasIssues = push_object_issue_style(lpObject->get_object_id());
+		bool isOpen = ImGui::TreeNodeEx(get_object_label(lpObject).c_str(), base_flags);
+		pop_object_issue_style(hasIssues, lpObject->get_object_id());
 
-				bool isOpen = ImGui::TreeNodeEx((lpObject->get_designator() + "(" + lpObject->get_table_id() + " " + std::to_string(lpObject->get_object_id()) + ")").c_str(), base_flags);
+		if (ImGui::IsItemClicked() && !ImGui::IsItemToggledOpen())
+		{
+			selectedObjectID = lpObject->get_object_id();
+			on_selected_object_changed(lpObject);
+		}
 
-				if (ImGui::IsItemClicked() && !ImGui::IsItemToggledOpen())
-				{
-					selectedObjectID = lpObject->get_object_id();
-					on_selected_object_changed(lpObject);
-				}
+		if (isOpen)
+		{
+			ImGui::Text("Serial Number: %s", lpObject->get_serial_number().c_str());
 
-				if (isOpen)
-				{
-					ImGui::Text("%s", ("Serial Number: " + std::dynamic_pointer_cast<isobus::task_controller_object::DeviceObject>(lpObject)->get_serial_number()).c_str());
+			// Render all elements with the device object as their parent recursively
+			parseElementChildrenOfElement(lpObject->get_object_id());
 
-					// Search for all elements with the device object as their parent and render recursively
-					// Search device elements for all elements that refer to aElementNumbers their parent
-					for (std::uint32_t k = 0; k < currentObjectPool->size(); k++)
-					{
-						auto currentObject = currentObjectPool->get_object_by_index(k);
+			ImGui::TreePop();
+		}
+	}
+	objectTreeFilterChanged = false;
+}
 
-						if ((isobus::task_controller_object::ObjectTypes::DeviceElement == currentObject->get_object_type()) &&
-						    (nullptr != std::dynamic_pointer_cast<isobus::task_controller_object::DeviceElementObject>(currentObject)) &&
-						    (std::dynamic_pointer_cast<isobus::task_controller_object::DeviceElementObject>(currentObject)->get_parent_object() == lpObject->get_object_id()))
-						{
-							parseElementChildrenOfElement(lpObject->get_object_id());
-							parseChildren(std::dynamic_pointer_cast<isobus::task_controller_object::DeviceElementObject>(currentObject));
-						}
-					}
+void DDOPGeneratorGUI::render_object_tree_filter()
+{
+	ImGui::SetNextItemWidth(-FLT_MIN);
+	if (ImGui::InputTextWithHint("##ObjectTreeFilter", "Search the tree: text, type:dpd, ddi:119, id:1-20, under:12", objectTreeFilterBuffer, IM_ARRAYSIZE(objectTreeFilterBuffer)))
+	{
+		objectTreeFilter.parse(objectTreeFilterBuffer);
+		objectTreeFilterDirty = true;
+		objectTreeFilterChanged = true;
+	}
 
-					ImGui::TreePop();
-					break;
+	if (ImGui::IsItemHovered())
+	{
+		ImGui::SetTooltip("Objects must match every term. Terms are separated by spaces.\n"
+		  "text           Designator contains the text\n"
+		  "type:dpd,dpt   Object type is DVC, DET, DPD, DPT or DVP\n"
+		  "ddi:119        DDI, in decimal or hex (ddi:0x77), or a range (ddi:100-200)\n"
+		  "ddi:\"work state\"  DDI name from the data dictionary\n"
+		  "id:100-200     Object ID, or a range of them\n"
+		  "under:12       Below object 12 in the tree");
+	}
+
+	if (objectTreeFilterDirty)
+	{
+		rebuild_object_tree_filter();
+		objectTreeFilterDirty = false;
+	}
+
+	if (!objectTreeFilter.get_error().empty())
+	{
+		ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "%s", objectTreeFilter.get_error().c_str());
+	}
+	else if (!objectTreeFilter.is_empty())
+	{
+		ImGui::TextDisabled("%zu matching object(s)", objectTreeFilterRows.size());
+	}
+}
+
+void DDOPGeneratorGUI::rebuild_object_tree_filter()
+{
+	objectTreeFilterRows.clear();
+	objectTreeVisibility.clear();
+
+	if (objectTreeFilter.is_empty())
+	{
+		return;
+	}
+
+	objectTreeFilter.apply(objectPoolSnapshot, objectTreeIndex, ddiSearchIndex, objectTreeFilterRows);
+
+	objectTreeVisibility.assign(static_cast<std::size_t>(std::numeric_limits<std::uint16_t>::max()) + 1, 0);
+
+	std::vector<std::uint16_t> pendingIDs;
+	pendingIDs.reserve(objectTreeFilterRows.size());
+
+	for (auto row : objectTreeFilterRows)
+	{
+		objectTreeVisibility[objectPoolSnapshot.get_object_id(row)] |= OBJECT_TREE_MATCH;
+		pendingIDs.push_back(objectPoolSnapshot.get_object_id(row));
+	}
+
+	// Walk up from every match to the device, stopping at objects that are already known ancestors.
+	// Elements are drawn under their parent, and other objects under every element that lists them
+	// as a child, or inside the process data and properties that use them as their presentation.
+	while (!pendingIDs.empty())
+	{
+		const std::uint16_t currentID = pendingIDs.back();
+		const std::uint32_t row = objectPoolSnapshot.find_row(currentID);
+		pendingIDs.pop_back();
+
+		if (ObjectPoolSnapshot::NO_ROW == row)
+		{
+			continue;
+		}
+
+		if (isobus::task_controller_object::ObjectTypes::DeviceElement == objectPoolSnapshot.get_type(row))
+		{
+			const std::uint16_t parentID = objectPoolSnapshot.get_parent_id(row);
+
+			if ((ObjectPoolSnapshot::NULL_OBJECT_ID != parentID) && (0 == (objectTreeVisibility[parentID] & OBJECT_TREE_ANCESTOR)))
+			{
+				objectTreeVisibility[parentID] |= OBJECT_TREE_ANCESTOR;
+				pendingIDs.push_back(parentID);
+			}
+		}
+		else
+		{
+			for (const auto &reference : objectReferenceIndex.get_references_to(currentID))
+			{
+				if ((ObjectReferenceIndex::ReferenceType::ParentObject != reference.type) &&
+				  (0 == (objectTreeVisibility[reference.referrer->get_object_id()] & OBJECT_TREE_ANCESTOR)))
+				{
+					objectTreeVisibility[reference.referrer->get_object_id()] |= OBJECT_TREE_ANCESTOR;
+					pendingIDs.push_back(reference.referrer->get_object_id());
 				}
-				break;
 			}
 		}
 	}
 }
 
-void DDOPGeneratorGUI::render_device_settings(std::shared_ptr<isobus::task_controller_object::DeviceObject> object)
+bool DDOPGeneratorGUI::is_visible_in_object_tree(std::uint16_t objectID) const
 {
-	ImGui::InputText("Designator", designatorBuffer, IM_ARRAYSIZE(designatorBuffer));
+	return objectTreeVisibility.empty() || (0 != objectTreeVisibility[objectID]);
+}
 
-	auto designator = std::string(designatorBuffer);
-	if (designator != object->get_designator())
+void DDOPGeneratorGUI::open_if_object_tree_ancestor(std::uint16_t objectID)
+{
+	// Only forced once, so the user can still collapse the tree while the filter is active
+	if (objectTreeFilterChanged && (!objectTreeVisibility.empty()) && (0 != (objectTreeVisibility[objectID] & OBJECT_TREE_ANCESTOR)))
 	{
-		object->set_designator(designator);
+		ImGui::SetNextItemOpen(true, ImGuiCond_Always);
 	}
+}
 
-	ImGui::InputText("Software Version", softwareVersionBuffer, IM_ARRAYSIZE(softwareVersionBuffer));
-
-	auto version = std::string(softwareVersionBuffer);
-	if (version != object->get_software_version())
+void DDOPGeneratorGUI::render_validation_status()
+{
+	if (backgroundValidator.is_busy())
+	{
+		ImGui::TextDisabled("Checking for errors...");
+	}
+	else if (backgroundValidator.has_result())
 	{
-		object->set_software_version(version);
+		const auto &issues = backgroundValidator.get_issues();
+
+		if (!issues.empty())
+		{
+			ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "%zu problem(s) found", issues.size());
+
+			if (ImGui::IsItemHovered())
+			{
+				ImGui::BeginTooltip();
+				for (const auto &issue : issues)
+				{
+					if (isobus::task_controller_object::Object::NULL_OBJECT_ID != issue.objectID)
+					{
+						ImGui::BulletText("Object %u: %s", issue.objectID, issue.message.c_str());
+					}
+					else
+					{
+						ImGui::BulletText("%s", issue.message.c_str());
+					}
+				}
+				ImGui::EndTooltip();
+			}
+		}
+		else if (!backgroundValidator.is_pool_valid())
+		{
+			ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "The DDOP could not be serialized");
+		}
+		else
+		{
+			ImGui::TextDisabled("No problems found");
+		}
 	}
+}
 
-	ImGui::InputText("Serial Number", serialNumberBuffer, IM_ARRAYSIZE(serialNumberBuffer));
+bool DDOPGeneratorGUI::push_object_issue_style(std::uint16_t objectID)
+{
+	bool retVal = !backgroundValidator.get_object_issues(objectID).empty();
 
-	auto serial = std::string(serialNumberBuffer);
-	if (serial != object->get_serial_number())
+	if (retVal)
 	{
-		object->set_serial_number(serial);
+		ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(1.0f, 0.4f, 0.4f, 1.0f));
 	}
+	return retVal;
+}
+
+void DDOPGeneratorGUI::pop_object_issue_style(bool hasIssues, std::uint16_t objectID)
+{
+	if (hasIssues)
+	{
+		ImGui::PopStyleColor();
 
-	ImGui::InputText("Structure Label", structureLabelBuffer, IM_ARRAYSIZE(structureLabelBuffer));
+		if (ImGui::IsItemHovered())
+		{
+			ImGui::BeginTooltip();
+			for (const auto &issue : backgroundValidator.get_object_issues(objectID))
+			{
+				ImGui::BulletText("%s", issue.message.c_str());
+			}
+			ImGui::EndTooltip();
+		}
+	}
+}
 
-	auto structureLabel = std::string(structureLabelBuffer);
-	if (structureLabel != object->get_structure_label())
+void DDOPGeneratorGUI::render_device_settings(isobus::task_controller_object::DeviceObject &object)
+{
+	if (ImGui::InputText("Designator", designatorBuffer, IM_ARRAYSIZE(designatorBuffer)))
 	{
-		object->set_structure_label(structureLabel);
+		commit_edit(EditJournal::Delta::text(object.get_object_id(), EditJournal::Field::Designator, object.get_designator(), designatorBuffer));
 	}
 
-	ImGui::InputText("Extended Structure Label", extendedStructureLabelBuffer, IM_ARRAYSIZE(extendedStructureLabelBuffer));
+	if (ImGui::InputText("Software Version", softwareVersionBuffer, IM_ARRAYSIZE(softwareVersionBuffer)))
+	{
+		commit_edit(EditJournal::Delta::text(object.get_object_id(), EditJournal::Field::SoftwareVersion, object.get_software_version(), softwareVersionBuffer));
+	}
 
-	auto extendedStructureLabel = std::string(extendedStructureLabelBuffer);
-	if (extendedStructureLabel != object->get_structure_label())
+	if (ImGui::InputText("Serial Number", serialNumberBuffer, IM_ARRAYSIZE(serialNumberBuffer)))
 	{
-		std::vector<std::uint8_t> convertedLabel(extendedStructureLabel.begin(), extendedStructureLabel.end());
-		object->set_extended_structure_label(convertedLabel);
+		commit_edit(EditJournal::Delta::text(object.get_object_id(), EditJournal::Field::SerialNumber, object.get_serial_number(), serialNumberBuffer));
 	}
 
-	ImGui::InputText("ISO NAME (hex)", hexIsoNameBuffer, IM_ARRAYSIZE(hexIsoNameBuffer));
+	if (ImGui::InputText("Structure Label", structureLabelBuffer, IM_ARRAYSIZE(structureLabelBuffer)))
+	{
+		commit_edit(EditJournal::Delta::text(object.get_object_id(), EditJournal::Field::StructureLabel, object.get_structure_label(), structureLabelBuffer));
+	}
 
-	char **nameEnd = nullptr;
-	std::string tempNAME(hexIsoNameBuffer);
-	auto integerISONAME = strtoull(tempNAME.c_str(), nameEnd, 16);
+	if (ImGui::InputText("Extended Structure Label", extendedStructureLabelBuffer, IM_ARRAYSIZE(extendedStructureLabelBuffer)))
+	{
+		auto currentExtendedStructureLabel = object.get_extended_structure_label();
+		commit_edit(EditJournal::Delta::text(object.get_object_id(), EditJournal::Field::ExtendedStructureLabel, std::string(currentExtendedStructureLabel.begin(), currentExtendedStructureLabel.end()), extendedStructureLabelBuffer));
+	}
 
-	if (integerISONAME != object->get_iso_name())
+	if (ImGui::InputText("ISO NAME (hex)", hexIsoNameBuffer, IM_ARRAYSIZE(hexIsoNameBuffer)))
 	{
-		object->set_iso_name(integerISONAME);
+		auto integerISONAME = strtoull(hexIsoNameBuffer, nullptr, 16);
+		commit_edit(EditJournal::Delta::number(object.get_object_id(), EditJournal::Field::IsoName, object.get_iso_name(), integerISONAME));
 	}
 
 	ImGui::SeparatorText("Localization Label");
 
-	ImGui::InputText("Language Code", languageCodeBuffer, IM_ARRAYSIZE(languageCodeBuffer));
-	languageCode = std::string(languageCodeBuffer);
+	bool localizationEdited = false;
+
+	if (ImGui::InputText("Language Code", languageCodeBuffer, IM_ARRAYSIZE(languageCodeBuffer)))
+	{
+		languageCode = languageCodeBuffer;
+		localizationEdited = true;
+	}
 
 	{
 		const char *strings[] = { "Comma", "Decimal", "Reserved", "N/A" };
@@ -784,6 +1021,7 @@ void DDOPGeneratorGUI::render_device_settings(std::shared_ptr<isobus::task_contr
 				if (ImGui::Selectable(strings[i], is_selected))
 				{
 					timeFormat = static_cast<isobus::LanguageCommandInterface::TimeFormats>(i);
+					localizationEdited = true;
 				}
 
 				if (is_selected)
@@ -806,6 +1044,7 @@ void DDOPGeneratorGUI::render_device_settings(std::shared_ptr<isobus::task_contr
 				if (ImGui::Selectable(strings[i], is_selected))
 				{
 					dateFormat = static_cast<isobus::LanguageCommandInterface::DateFormats>(i);
+					localizationEdited = true;
 				}
 
 				if (is_selected)
@@ -828,6 +1067,7 @@ void DDOPGeneratorGUI::render_device_settings(std::shared_ptr<isobus::task_contr
 				if (ImGui::Selectable(strings[i], is_selected))
 				{
 					distanceUnitSystem = static_cast<isobus::LanguageCommandInterface::DistanceUnits>(i);
+					localizationEdited = true;
 				}
 
 				if (is_selected)
@@ -849,6 +1089,7 @@ void DDOPGeneratorGUI::render_device_settings(std::shared_ptr<isobus::task_contr
 				if (ImGui::Selectable(strings[i], is_selected))
 				{
 					areaUnitSystem = static_cast<isobus::LanguageCommandInterface::AreaUnits>(i);
+					localizationEdited = true;
 				}
 
 				if (is_selected)
@@ -871,6 +1112,7 @@ void DDOPGeneratorGUI::render_device_settings(std::shared_ptr<isobus::task_contr
 				if (ImGui::Selectable(strings[i], is_selected))
 				{
 					volumeUnitSystem = static_cast<isobus::LanguageCommandInterface::VolumeUnits>(i);
+					localizationEdited = true;
 				}
 
 				if (is_selected)
@@ -893,6 +1135,7 @@ void DDOPGeneratorGUI::render_device_settings(std::shared_ptr<isobus::task_contr
 				if (ImGui::Selectable(strings[i], is_selected))
 				{
 					massUnitSystem = static_cast<isobus::LanguageCommandInterface::MassUnits>(i);
+					localizationEdited = true;
 				}
 
 				if (is_selected)
@@ -914,6 +1157,7 @@ void DDOPGeneratorGUI::render_device_settings(std::shared_ptr<isobus::task_contr
 				if (ImGui::Selectable(strings[i], is_selected))
 				{
 					forceUnitSystem = static_cast<isobus::LanguageCommandInterface::ForceUnits>(i);
+					localizationEdited = true;
 				}
 
 				if (is_selected)
@@ -936,6 +1180,7 @@ void DDOPGeneratorGUI::render_device_settings(std::shared_ptr<isobus::task_contr
 				if (ImGui::Selectable(strings[i], is_selected))
 				{
 					temperatureUnitSystem = static_cast<isobus::LanguageCommandInterface::TemperatureUnits>(i);
+					localizationEdited = true;
 				}
 
 				if (is_selected)
@@ -957,6 +1202,7 @@ void DDOPGeneratorGUI::render_device_settings(std::shared_ptr<isobus::task_contr
 				if (ImGui::Selectable(strings[i], is_selected))
 				{
 					genericUnitSystem = static_cast<isobus::LanguageCommandInterface::UnitSystem>(i);
+					localizationEdited = true;
 				}
 
 				if (is_selected)
@@ -979,6 +1225,7 @@ void DDOPGeneratorGUI::render_device_settings(std::shared_ptr<isobus::task_contr
 				if (ImGui::Selectable(strings[i], is_selected))
 				{
 					pressureUnitSystem = static_cast<isobus::LanguageCommandInterface::PressureUnits>(i);
+					localizationEdited = true;
 				}
 
 				if (is_selected)
@@ -990,86 +1237,72 @@ void DDOPGeneratorGUI::render_device_settings(std::shared_ptr<isobus::task_contr
 		}
 	}
 
-	auto localizationData = generate_localization_label();
-	auto currentLocalization = object->get_localization_label();
-
-	if (localizationData != currentLocalization)
+	if (localizationEdited)
 	{
-		object->set_localization_label(localizationData);
+		auto localizationData = generate_localization_label();
+		auto currentLocalization = object.get_localization_label();
+		commit_edit(EditJournal::Delta::text(object.get_object_id(), EditJournal::Field::LocalizationLabel, std::string(currentLocalization.begin(), currentLocalization.end()), std::string(localizationData.begin(), localizationData.end())));
 	}
 }
 
-void DDOPGeneratorGUI::render_device_element_settings(std::shared_ptr<isobus::task_controller_object::DeviceElementObject> object)
+void DDOPGeneratorGUI::render_device_element_settings(isobus::task_controller_object::DeviceElementObject &object)
 {
-	ImGui::InputText("Designator", designatorBuffer, IM_ARRAYSIZE(designatorBuffer));
-
-	auto designator = std::string(designatorBuffer);
-	if (designator != object->get_designator())
-	{
-		object->set_designator(designator);
-	}
-
-	ImGui::InputInt("Element Number", &elementNumberBuffer);
-
-	if (elementNumberBuffer > 4095)
-	{
-		// 12 bits is the max element
-		elementNumberBuffer = 4095;
-	}
-	else if (elementNumberBuffer < 0)
+	if (ImGui::InputText("Designator", designatorBuffer, IM_ARRAYSIZE(designatorBuffer)))
 	{
-		elementNumberBuffer = 0;
+		commit_edit(EditJournal::Delta::text(object.get_object_id(), EditJournal::Field::Designator, object.get_designator(), designatorBuffer));
 	}
 
-	if (object->get_element_number() != elementNumberBuffer)
+	if (ImGui::InputInt("Element Number", &elementNumberBuffer))
 	{
-		object->set_element_number(elementNumberBuffer);
+		if (elementNumberBuffer > 4095)
+		{
+			// 12 bits is the max element
+			elementNumberBuffer = 4095;
+		}
+		else if (elementNumberBuffer < 0)
+		{
+			elementNumberBuffer = 0;
+		}
+		commit_edit(EditJournal::Delta::number(object.get_object_id(), EditJournal::Field::ElementNumber, object.get_element_number(), elementNumberBuffer));
 	}
 
 	ImGui::BeginDisabled();
-	ImGui::InputInt("Object ID", &objectIDBuffer);
-	if (objectIDBuffer < 0)
-	{
-		objectIDBuffer = 0;
-	}
-	else if (objectIDBuffer > 0xFFFF)
+	if (ImGui::InputInt("Object ID", &objectIDBuffer))
 	{
-		objectIDBuffer = 0xFFFF;
-	}
+		if (objectIDBuffer < 0)
+		{
+			objectIDBuffer = 0;
+		}
+		else if (objectIDBuffer > 0xFFFF)
+		{
+			objectIDBuffer = 0xFFFF;
+		}
 
-	if ((objectIDBuffer != object->get_object_id()) &&
-	    (!currentObjectPool->get_object_by_id(objectIDBuffer)))
-	{
-		object->set_object_id(objectIDBuffer);
-	}
-	else
-	{
-		objectIDBuffer = object->get_object_id();
+		if ((objectIDBuffer != object.get_object_id()) &&
+		    (!objectTreeIndex.get_object(objectIDBuffer)))
+		{
+			commit_edit(EditJournal::Delta::number(object.get_object_id(), EditJournal::Field::ObjectID, object.get_object_id(), objectIDBuffer));
+		}
+		else
+		{
+			objectIDBuffer = object.get_object_id();
+		}
 	}
 	ImGui::EndDisabled();
 
-	ImGui::InputInt("Parent Object ID", &parentObjectBuffer);
-
-	if (parentObjectBuffer < 0)
-	{
-		parentObjectBuffer = 0xFFFF;
-	}
-
-	if (object->get_parent_object() > 0xFFFF)
-	{
-		parentObjectBuffer = 0xFFFF;
-	}
-
-	if (parentObjectBuffer != object->get_parent_object())
+	if (ImGui::InputInt("Parent Object ID", &parentObjectBuffer))
 	{
-		object->set_parent_object(parentObjectBuffer);
+		if ((parentObjectBuffer < 0) || (parentObjectBuffer > 0xFFFF))
+		{
+			parentObjectBuffer = 0xFFFF;
+		}
+		commit_edit(EditJournal::Delta::number(object.get_object_id(), EditJournal::Field::ParentObject, object.get_parent_object(), parentObjectBuffer));
 	}
 
-	auto parent = currentObjectPool->get_object_by_id(parentObjectBuffer);
-	if (nullptr != parent)
+	ObjectView parent = objectTreeIndex.get_object_view(parentObjectBuffer);
+	if (parent.is_valid())
 	{
-		std::string designator = "Parent's designator is \"" + parent->get_designator() + "\"";
-		ImGui::Text("%s", designator.c_str());
+		ImGui::Text("Parent's designator is \"%s\"", parent->get_designator().c_str());
 	}
 
 	if (nullptr != currentObjectPool)
@@ -1105,7 +1338,7 @@ void DDOPGeneratorGUI::render_device_element_settings(std::shared_ptr<isobus::ta
 			if (ImGui::Button("Add Object"))
 			{
 				auto childID = currentObjectPool->get_object_by_index(addChildComboIndex)->get_object_id();
-				object->add_reference_to_child_object(childID);
+				commit_edit(EditJournal::Delta::child_reference_added(object.get_object_id(), object.get_number_child_objects(), childID));
 			}
 		}
 		else
@@ -1115,72 +1348,136 @@ void DDOPGeneratorGUI::render_device_element_settings(std::shared_ptr<isobus::ta
 	}
 }
 
-void DDOPGeneratorGUI::render_device_process_data_settings(std::shared_ptr<isobus::task_controller_object::DeviceProcessDataObject> object)
+bool DDOPGeneratorGUI::render_ddi_search(int &ddi)
 {
-	ImGui::InputText("Designator", designatorBuffer, IM_ARRAYSIZE(designatorBuffer));
+	bool retVal = false;
 
-	auto designator = std::string(designatorBuffer);
-	if (designator != object->get_designator())
+	ImGui::SameLine();
+	if (ImGui::Button("Search"))
 	{
-		object->set_designator(designator);
+		// The index covers the whole data dictionary, so it's only built once someone actually searches
+		ddiSearchIndex.build();
+		ddiSearchBuffer[0] = '\0';
+		ddiSearchDirty = true;
+		ImGui::OpenPopup("DDI Search");
 	}
 
-	ImGui::InputInt("DDI", &ddiBuffer);
-	if (ddiBuffer < 0)
+	if (ImGui::BeginPopup("DDI Search"))
 	{
-		ddiBuffer = 0;
-	}
-	else if (ddiBuffer > 0xFFFF)
-	{
-		ddiBuffer = 0xFFFF;
-	}
+		if (ImGui::IsWindowAppearing())
+		{
+			ImGui::SetKeyboardFocusHere();
+		}
+		ImGui::SetNextItemWidth(ImGui::GetFontSize() * 30.0f);
+		if (ImGui::InputTextWithHint("##DDISearch", "Name, unit, DDI, 0x hex or a range like 100-200", ddiSearchBuffer, IM_ARRAYSIZE(ddiSearchBuffer)))
+		{
+			ddiSearchDirty = true;
+		}
 
-	if (ddiBuffer != object->get_ddi())
-	{
-		object->set_ddi(ddiBuffer);
-	}
+		// Only search again when the query changes, not every frame the popup is open
+		if (ddiSearchDirty)
+		{
+			ddiSearchIndex.search(ddiSearchBuffer, ddiSearchIndex.size());
+			ddiSearchDirty = false;
+		}
 
-	ImGui::BeginDisabled();
-	ImGui::InputInt("Object ID", &objectIDBuffer);
-	if (objectIDBuffer < 0)
-	{
-		objectIDBuffer = 0;
+		const auto &matches = ddiSearchIndex.get_results();
+		ImGui::Text("%u matches", static_cast<unsigned int>(matches.size()));
+
+		if (ImGui::BeginChild("##DDISearchResults", ImVec2(ImGui::GetFontSize() * 30.0f, ImGui::GetTextLineHeightWithSpacing() * 15.0f), true))
+		{
+			ImGuiListClipper clipper;
+			clipper.Begin(static_cast<int>(matches.size()));
+			while (clipper.Step())
+			{
+				for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++)
+				{
+					const auto &entry = *matches[i].entry;
+					char label[256];
+					std::snprintf(label, sizeof(label), "%u - %s [%s]", static_cast<unsigned int>(entry.ddi), entry.name.c_str(), entry.units.c_str());
+
+					ImGui::PushID(static_cast<int>(entry.ddi));
+					if (ImGui::Selectable(label, entry.ddi == ddi))
+					{
+						ddi = entry.ddi;
+						retVal = true;
+						ImGui::CloseCurrentPopup();
+					}
+					ImGui::PopID();
+				}
+			}
+		}
+		ImGui::EndChild();
+		ImGui::EndPopup();
 	}
-	else if (objectIDBuffer > 0xFFFF)
+	return retVal;
+}
+
+void DDOPGeneratorGUI::render_device_process_data_settings(isobus::task_controller_object::DeviceProcessDataObject &object)
+{
+	if (ImGui::InputText("Designator", designatorBuffer, IM_ARRAYSIZE(designatorBuffer)))
 	{
-		objectIDBuffer = 0xFFFF;
+		commit_edit(EditJournal::Delta::text(object.get_object_id(), EditJournal::Field::Designator, object.get_designator(), designatorBuffer));
 	}
 
-	if ((objectIDBuffer != object->get_object_id()) &&
-	    (!currentObjectPool->get_object_by_id(objectIDBuffer)))
+	if (ImGui::InputInt("DDI", &ddiBuffer))
 	{
-		object->set_object_id(objectIDBuffer);
+		if (ddiBuffer < 0)
+		{
+			ddiBuffer = 0;
+		}
+		else if (ddiBuffer > 0xFFFF)
+		{
+			ddiBuffer = 0xFFFF;
+		}
+		commit_edit(EditJournal::Delta::number(object.get_object_id(), EditJournal::Field::DDI, object.get_ddi(), ddiBuffer));
 	}
-	else
+	if (render_ddi_search(ddiBuffer))
 	{
-		objectIDBuffer = object->get_object_id();
+		commit_edit(EditJournal::Delta::number(object.get_object_id(), EditJournal::Field::DDI, object.get_ddi(), ddiBuffer));
 	}
-	ImGui::EndDisabled();
 
-	ImGui::InputInt("Presentation Object ID", &presentationObjectBuffer);
-	if (presentationObjectBuffer < 0)
+	ImGui::BeginDisabled();
+	if (ImGui::InputInt("Object ID", &objectIDBuffer))
 	{
-		presentationObjectBuffer = 0;
-	}
-	else if (presentationObjectBuffer > 0xFFFF)
-	{
-		presentationObjectBuffer = 0xFFFF;
+		if (objectIDBuffer < 0)
+		{
+			objectIDBuffer = 0;
+		}
+		else if (objectIDBuffer > 0xFFFF)
+		{
+			objectIDBuffer = 0xFFFF;
+		}
+
+		if ((objectIDBuffer != object.get_object_id()) &&
+		    (!objectTreeIndex.get_object(objectIDBuffer)))
+		{
+			commit_edit(EditJournal::Delta::number(object.get_object_id(), EditJournal::Field::ObjectID, object.get_object_id(), objectIDBuffer));
+		}
+		else
+		{
+			objectIDBuffer = object.get_object_id();
+		}
 	}
+	ImGui::EndDisabled();
 
-	if (presentationObjectBuffer != object->get_device_value_presentation_object_id())
+	if (ImGui::InputInt("Presentation Object ID", &presentationObjectBuffer))
 	{
-		object->set_device_value_presentation_object_id(presentationObjectBuffer);
+		if (presentationObjectBuffer < 0)
+		{
+			presentationObjectBuffer = 0;
+		}
+		else if (presentationObjectBuffer > 0xFFFF)
+		{
+			presentationObjectBuffer = 0xFFFF;
+		}
+		commit_edit(EditJournal::Delta::number(object.get_object_id(), EditJournal::Field::PresentationObject, object.get_device_value_presentation_object_id(), presentationObjectBuffer));
 	}
 
 	ImGui::Text("Properties");
-	ImGui::Checkbox("Member of Default Set", &propertiesBitfieldBuffer[0]);
-	ImGui::Checkbox("Settable", &propertiesBitfieldBuffer[1]);
-	ImGui::Checkbox("Control Source", &propertiesBitfieldBuffer[2]);
+	bool propertiesEdited = ImGui::Checkbox("Member of Default Set", &propertiesBitfieldBuffer[0]);
+	propertiesEdited |= ImGui::Checkbox("Settable", &propertiesBitfieldBuffer[1]);
+	propertiesEdited |= ImGui::Checkbox("Control Source", &propertiesBitfieldBuffer[2]);
 	ImGui::SameLine();
 	ImGui::TextDisabled("(?)");
 	if (ImGui::IsItemHovered(ImGuiHoveredFlags_DelayShort))
@@ -1192,199 +1489,195 @@ void DDOPGeneratorGUI::render_device_process_data_settings(std::shared_ptr<isobu
 		ImGui::EndTooltip();
 	}
 
-	// Mutually exclusive bits
-	if (propertiesBitfieldBuffer[1] && propertiesBitfieldBuffer[2])
+	if (propertiesEdited)
 	{
-		propertiesBitfieldBuffer[2] = false;
-	}
+		// Mutually exclusive bits
+		if (propertiesBitfieldBuffer[1] && propertiesBitfieldBuffer[2])
+		{
+			propertiesBitfieldBuffer[2] = false;
+		}
 
-	std::uint8_t propertiesBitfield = static_cast<std::uint8_t>(propertiesBitfieldBuffer[0]) |
-	  (static_cast<std::uint8_t>(propertiesBitfieldBuffer[1]) << 1) |
-	  (static_cast<std::uint8_t>(propertiesBitfieldBuffer[2]) << 2);
-	if (propertiesBitfield != object->get_properties_bitfield())
-	{
-		object->set_properties_bitfield(propertiesBitfield);
+		std::uint8_t propertiesBitfield = static_cast<std::uint8_t>(propertiesBitfieldBuffer[0]) |
+		  (static_cast<std::uint8_t>(propertiesBitfieldBuffer[1]) << 1) |
+		  (static_cast<std::uint8_t>(propertiesBitfieldBuffer[2]) << 2);
+		commit_edit(EditJournal::Delta::number(object.get_object_id(), EditJournal::Field::PropertiesBitfield, object.get_properties_bitfield(), propertiesBitfield));
 	}
 
 	ImGui::Text("Trigger Settings");
-	ImGui::Checkbox("Time Interval", &triggerBitfieldBuffer[0]);
-	ImGui::Checkbox("Distance Interval", &triggerBitfieldBuffer[1]);
-	ImGui::Checkbox("Threshold Limits", &triggerBitfieldBuffer[2]);
-	ImGui::Checkbox("On Change", &triggerBitfieldBuffer[3]);
-	ImGui::Checkbox("Total", &triggerBitfieldBuffer[4]);
+	bool triggersEdited = ImGui::Checkbox("Time Interval", &triggerBitfieldBuffer[0]);
+	triggersEdited |= ImGui::Checkbox("Distance Interval", &triggerBitfieldBuffer[1]);
+	triggersEdited |= ImGui::Checkbox("Threshold Limits", &triggerBitfieldBuffer[2]);
+	triggersEdited |= ImGui::Checkbox("On Change", &triggerBitfieldBuffer[3]);
+	triggersEdited |= ImGui::Checkbox("Total", &triggerBitfieldBuffer[4]);
 
-	std::uint8_t triggerBitfield = static_cast<std::uint8_t>(triggerBitfieldBuffer[0]) |
-	  (static_cast<std::uint8_t>(triggerBitfieldBuffer[1]) << 1) |
-	  (static_cast<std::uint8_t>(triggerBitfieldBuffer[2]) << 2) |
-	  (static_cast<std::uint8_t>(triggerBitfieldBuffer[3]) << 3) |
-	  (static_cast<std::uint8_t>(triggerBitfieldBuffer[4]) << 4);
-	if (triggerBitfield != object->get_trigger_methods_bitfield())
+	if (triggersEdited)
 	{
-		object->set_trigger_methods_bitfield(triggerBitfield);
+		std::uint8_t triggerBitfield = static_cast<std::uint8_t>(triggerBitfieldBuffer[0]) |
+		  (static_cast<std::uint8_t>(triggerBitfieldBuffer[1]) << 1) |
+		  (static_cast<std::uint8_t>(triggerBitfieldBuffer[2]) << 2) |
+		  (static_cast<std::uint8_t>(triggerBitfieldBuffer[3]) << 3) |
+		  (static_cast<std::uint8_t>(triggerBitfieldBuffer[4]) << 4);
+		commit_edit(EditJournal::Delta::number(object.get_object_id(), EditJournal::Field::TriggerMethodsBitfield, object.get_trigger_methods_bitfield(), triggerBitfield));
 	}
 }
 
-void DDOPGeneratorGUI::render_device_property_settings(std::shared_ptr<isobus::task_controller_object::DevicePropertyObject> object)
+void DDOPGeneratorGUI::render_device_property_settings(isobus::task_controller_object::DevicePropertyObject &object)
 {
-	ImGui::InputText("Designator", designatorBuffer, IM_ARRAYSIZE(designatorBuffer));
-
-	auto designator = std::string(designatorBuffer);
-	if (designator != object->get_designator())
+	if (ImGui::InputText("Designator", designatorBuffer, IM_ARRAYSIZE(designatorBuffer)))
 	{
-		object->set_designator(designator);
+		commit_edit(EditJournal::Delta::text(object.get_object_id(), EditJournal::Field::Designator, object.get_designator(), designatorBuffer));
 	}
 
-	ImGui::InputInt("DDI", &ddiBuffer);
-	if (ddiBuffer < 0)
+	if (ImGui::InputInt("DDI", &ddiBuffer))
 	{
-		ddiBuffer = 0;
-	}
-	else if (ddiBuffer > 0xFFFF)
-	{
-		ddiBuffer = 0xFFFF;
-	}
-
-	if (ddiBuffer != object->get_ddi())
-	{
-		object->set_ddi(ddiBuffer);
+		if (ddiBuffer < 0)
+		{
+			ddiBuffer = 0;
+		}
+		else if (ddiBuffer > 0xFFFF)
+		{
+			ddiBuffer = 0xFFFF;
+		}
+		commit_edit(EditJournal::Delta::number(object.get_object_id(), EditJournal::Field::DDI, object.get_ddi(), ddiBuffer));
 	}
-
-	ImGui::InputInt("Value", &valueBuffer);
-	if (valueBuffer != object->get_value())
+	if (render_ddi_search(ddiBuffer))
 	{
-		object->set_value(valueBuffer);
+		commit_edit(EditJournal::Delta::number(object.get_object_id(), EditJournal::Field::DDI, object.get_ddi(), ddiBuffer));
 	}
 
-	ImGui::InputInt("Presentation Object ID", &presentationObjectBuffer);
-	if (presentationObjectBuffer < 0)
+	if (ImGui::InputInt("Value", &valueBuffer))
 	{
-		presentationObjectBuffer = 0;
-	}
-	else if (presentationObjectBuffer > 0xFFFF)
-	{
-		presentationObjectBuffer = 0xFFFF;
+		commit_edit(EditJournal::Delta::number(object.get_object_id(), EditJournal::Field::Value, object.get_value(), valueBuffer));
 	}
 
-	if (presentationObjectBuffer != object->get_device_value_presentation_object_id())
+	if (ImGui::InputInt("Presentation Object ID", &presentationObjectBuffer))
 	{
-		object->set_device_value_presentation_object_id(presentationObjectBuffer);
+		if (presentationObjectBuffer < 0)
+		{
+			presentationObjectBuffer = 0;
+		}
+		else if (presentationObjectBuffer > 0xFFFF)
+		{
+			presentationObjectBuffer = 0xFFFF;
+		}
+		commit_edit(EditJournal::Delta::number(object.get_object_id(), EditJournal::Field::PresentationObject, object.get_device_value_presentation_object_id(), presentationObjectBuffer));
 	}
 
 	ImGui::BeginDisabled();
-	ImGui::InputInt("Object ID", &objectIDBuffer);
-	if (objectIDBuffer < 0)
+	if (ImGui::InputInt("Object ID", &objectIDBuffer))
 	{
-		objectIDBuffer = 0;
-	}
-	else if (objectIDBuffer > 0xFFFF)
-	{
-		objectIDBuffer = 0xFFFF;
-	}
+		if (objectIDBuffer < 0)
+		{
+			objectIDBuffer = 0;
+		}
+		else if (objectIDBuffer > 0xFFFF)
+		{
+			objectIDBuffer = 0xFFFF;
+		}
 
-	if ((objectIDBuffer != object->get_object_id()) &&
-	    (!currentObjectPool->get_object_by_id(objectIDBuffer)))
-	{
-		object->set_object_id(objectIDBuffer);
-	}
-	else
-	{
-		objectIDBuffer = object->get_object_id();
+		if ((objectIDBuffer != object.get_object_id()) &&
+		    (!objectTreeIndex.get_object(objectIDBuffer)))
+		{
+			commit_edit(EditJournal::Delta::number(object.get_object_id(), EditJournal::Field::ObjectID, object.get_object_id(), objectIDBuffer));
+		}
+		else
+		{
+			objectIDBuffer = object.get_object_id();
+		}
 	}
 	ImGui::EndDisabled();
 }
 
-void DDOPGeneratorGUI::render_device_presentation_settings(std::shared_ptr<isobus::task_controller_object::DeviceValuePresentationObject> object)
+void DDOPGeneratorGUI::render_device_presentation_settings(isobus::task_controller_object::DeviceValuePresentationObject &object)
 {
-	ImGui::InputText("Designator", designatorBuffer, IM_ARRAYSIZE(designatorBuffer));
-
-	auto designator = std::string(designatorBuffer);
-	if (designator != object->get_designator())
-	{
-		object->set_designator(designator);
-	}
-
-	ImGui::InputFloat("Scale", &scaleBuffer, 0.0f, 0.0f, "%.9f");
-	if (scaleBuffer > 100000000.0f)
-	{
-		scaleBuffer = 100000000.0f;
-	}
-	else if (scaleBuffer < 0.000000001f)
-	{
-		scaleBuffer = 0.000000001f;
-	}
-
-	if (object->get_scale() != scaleBuffer)
+	if (ImGui::InputText("Designator", designatorBuffer, IM_ARRAYSIZE(designatorBuffer)))
 	{
-		object->set_scale(scaleBuffer);
+		commit_edit(EditJournal::Delta::text(object.get_object_id(), EditJournal::Field::Designator, object.get_designator(), designatorBuffer));
 	}
 
-	ImGui::InputInt("Offset", &offsetBuffer);
-	if (object->get_offset() != offsetBuffer)
+	if (ImGui::InputFloat("Scale", &scaleBuffer, 0.0f, 0.0f, "%.9f"))
 	{
-		object->set_offset(offsetBuffer);
+		if (scaleBuffer > 100000000.0f)
+		{
+			scaleBuffer = 100000000.0f;
+		}
+		else if (scaleBuffer < 0.000000001f)
+		{
+			scaleBuffer = 0.000000001f;
+		}
+		commit_edit(EditJournal::Delta::scale(object.get_object_id(), object.get_scale(), scaleBuffer));
 	}
 
-	ImGui::InputInt("Number Decimals", &numberDecimalsBuffer);
-	if (numberDecimalsBuffer > 7)
+	if (ImGui::InputInt("Offset", &offsetBuffer))
 	{
-		numberDecimalsBuffer = 7;
+		commit_edit(EditJournal::Delta::number(object.get_object_id(), EditJournal::Field::Offset, object.get_offset(), offsetBuffer));
 	}
 
-	if (object->get_number_of_decimals() != numberDecimalsBuffer)
+	if (ImGui::InputInt("Number Decimals", &numberDecimalsBuffer))
 	{
-		object->set_number_of_decimals(numberDecimalsBuffer);
+		if (numberDecimalsBuffer > 7)
+		{
+			numberDecimalsBuffer = 7;
+		}
+		else if (numberDecimalsBuffer < 0)
+		{
+			numberDecimalsBuffer = 0;
+		}
+		commit_edit(EditJournal::Delta::number(object.get_object_id(), EditJournal::Field::NumberOfDecimals, object.get_number_of_decimals(), numberDecimalsBuffer));
 	}
 
 	ImGui::BeginDisabled();
-	ImGui::InputInt("Object ID", &objectIDBuffer);
-	if (objectIDBuffer < 0)
+	if (ImGui::InputInt("Object ID", &objectIDBuffer))
 	{
-		objectIDBuffer = 0;
-	}
-	else if (objectIDBuffer > 0xFFFF)
-	{
-		objectIDBuffer = 0xFFFF;
-	}
+		if (objectIDBuffer < 0)
+		{
+			objectIDBuffer = 0;
+		}
+		else if (objectIDBuffer > 0xFFFF)
+		{
+			objectIDBuffer = 0xFFFF;
+		}
 
-	if ((objectIDBuffer != object->get_object_id()) &&
-	    (!currentObjectPool->get_object_by_id(objectIDBuffer)))
-	{
-		object->set_object_id(objectIDBuffer);
-	}
-	else
-	{
-		objectIDBuffer = object->get_object_id();
+		if ((objectIDBuffer != object.get_object_id()) &&
+		    (!objectTreeIndex.get_object(objectIDBuffer)))
+		{
+			commit_edit(EditJournal::Delta::number(object.get_object_id(), EditJournal::Field::ObjectID, object.get_object_id(), objectIDBuffer));
+		}
+		else
+		{
+			objectIDBuffer = object.get_object_id();
+		}
 	}
 	ImGui::EndDisabled();
 }
 
-void DDOPGeneratorGUI::render_object_components(std::shared_ptr<isobus::task_controller_object::Object> object)
+void DDOPGeneratorGUI::render_object_components(ObjectView object)
 {
-	if (nullptr != object)
+	if (object.is_valid())
 	{
-		switch (object->get_object_type())
+		switch (object.get_type())
 		{
 			case isobus::task_controller_object::ObjectTypes::DeviceElement:
 			{
-				render_device_element_components(std::dynamic_pointer_cast<isobus::task_controller_object::DeviceElementObject>(object));
+				render_device_element_components(*object.as_element());
 			}
 			break;
 
 			case isobus::task_controller_object::ObjectTypes::DeviceProcessData:
 			{
-				render_device_process_data_components(std::dynamic_pointer_cast<isobus::task_controller_object::DeviceProcessDataObject>(object));
+				render_device_process_data_components(*object.as_process_data());
 			}
 			break;
 
 			case isobus::task_controller_object::ObjectTypes::DeviceProperty:
 			{
-				render_device_property_components(std::dynamic_pointer_cast<isobus::task_controller_object::DevicePropertyObject>(object));
+				render_device_property_components(*object.as_property());
 			}
 			break;
 
 			case isobus::task_controller_object::ObjectTypes::DeviceValuePresentation:
 			{
-				render_device_presentation_components(std::dynamic_pointer_cast<isobus::task_controller_object::DeviceValuePresentationObject>(object));
+				render_device_presentation_components(*object.as_presentation());
 			}
 			break;
 
@@ -1394,61 +1687,63 @@ void DDOPGeneratorGUI::render_object_components(std::shared_ptr<isobus::task_con
 	}
 }
 
-void DDOPGeneratorGUI::render_current_selected_object_settings(std::shared_ptr<isobus::task_controller_object::Object> object)
+void DDOPGeneratorGUI::render_current_selected_object_settings(ObjectView object)
 {
-	if (nullptr != object)
+	FrameProfiler::ScopedZone profilerZone(frameProfiler, FrameProfiler::Zone::SelectedObjectSettings);
+
+	if (object.is_valid())
 	{
-		switch (object->get_object_type())
+		switch (object.get_type())
 		{
 			case isobus::task_controller_object::ObjectTypes::Device:
 			{
-				render_device_settings(std::dynamic_pointer_cast<isobus::task_controller_object::DeviceObject>(object));
+				render_device_settings(*object.as_device());
 			}
 			break;
 
 			case isobus::task_controller_object::ObjectTypes::DeviceElement:
 			{
-				render_device_element_settings(std::dynamic_pointer_cast<isobus::task_controller_object::DeviceElementObject>(object));
+				render_device_element_settings(*object.as_element());
 			}
 			break;
 
 			case isobus::task_controller_object::ObjectTypes::DeviceProcessData:
 			{
-				render_device_process_data_settings(std::dynamic_pointer_cast<isobus::task_controller_object::DeviceProcessDataObject>(object));
+				render_device_process_data_settings(*object.as_process_data());
 			}
 			break;
 
 			case isobus::task_controller_object::ObjectTypes::DeviceProperty:
 			{
-				render_device_property_settings(std::dynamic_pointer_cast<isobus::task_controller_object::DevicePropertyObject>(object));
+				render_device_property_settings(*object.as_property());
 			}
 			break;
 
 			case isobus::task_controller_object::ObjectTypes::DeviceValuePresentation:
 			{
-				render_device_presentation_settings(std::dynamic_pointer_cast<isobus::task_controller_object::DeviceValuePresentationObject>(object));
+				render_device_presentation_settings(*object.as_presentation());
 			}
 			break;
 		}
 	}
 }
 
-void DDOPGeneratorGUI::render_device_element_components(std::shared_ptr<isobus::task_controller_object::DeviceElementObject> object)
+void DDOPGeneratorGUI::render_device_element_components(isobus::task_controller_object::DeviceElementObject &object)
 {
-	ImGui::Text("%s", ("Element Number: " + std::to_string(object->get_element_number())).c_str());
-	ImGui::Text("%s", ("Type: " + get_element_type_string(object->get_type())).c_str());
+	ImGui::Text("Element Number: %u", object.get_element_number());
+	ImGui::Text("%s", ("Type: " + get_element_type_string(object.get_type())).c_str());
 }
 
-void DDOPGeneratorGUI::render_device_process_data_components(std::shared_ptr<isobus::task_controller_object::DeviceProcessDataObject> object)
+void DDOPGeneratorGUI::render_device_process_data_components(isobus::task_controller_object::DeviceProcessDataObject &object)
 {
-	ImGui::TextColored(ImVec4(0.0f, 1.0f, 0.0f, 1.0f), "DDI: %u (%s)", object->get_ddi(), isobus::DataDictionary::get_entry(object->get_ddi()).name.c_str());
+	ImGui::TextColored(ImVec4(0.0f, 1.0f, 0.0f, 1.0f), "DDI: %u (%s)", object.get_ddi(), isobus::DataDictionary::get_entry(object.get_ddi()).name.c_str());
 
 	bool areAnyTriggers = false;
 	ImGui::Text("Triggers:");
 	ImGui::Indent();
 	for (std::uint8_t t = 0; t < 5; t++)
 	{
-		if (0 != ((1 << t) & object->get_trigger_methods_bitfield()))
+		if (0 != ((1 << t) & object.get_trigger_methods_bitfield()))
 		{
 			switch (static_cast<isobus::task_controller_object::DeviceProcessDataObject::AvailableTriggerMethods>(1 << t))
 			{
@@ -1508,7 +1803,7 @@ void DDOPGeneratorGUI::render_device_process_data_components(std::shared_ptr<iso
 	ImGui::Indent();
 	for (std::uint8_t t = 0; t < 3; t++)
 	{
-		if (0 != ((1 << t) & object->get_properties_bitfield()))
+		if (0 != ((1 << t) & object.get_properties_bitfield()))
 		{
 			switch (static_cast<isobus::task_controller_object::DeviceProcessDataObject::PropertiesBit>(1 << t))
 			{
@@ -1550,9 +1845,9 @@ void DDOPGeneratorGUI::render_device_process_data_components(std::shared_ptr<iso
 	ImGui::Unindent();
 
 	// Try and get the presentation
-	if (0xFFFF != object->get_device_value_presentation_object_id())
+	if (0xFFFF != object.get_device_value_presentation_object_id())
 	{
-		auto currentPresentation = std::dynamic_pointer_cast<isobus::task_controller_object::DeviceValuePresentationObject>(currentObjectPool->get_object_by_id(object->get_device_value_presentation_object_id()));
+		auto currentPresentation = objectTreeIndex.get_object_view(object.get_device_value_presentation_object_id()).as_presentation();
 
 		if (nullptr != currentPresentation)
 		{
@@ -1563,7 +1858,7 @@ void DDOPGeneratorGUI::render_device_process_data_components(std::shared_ptr<iso
 			}
 
 			ImGui::Indent();
-			bool isOpen = ImGui::TreeNodeEx(("Presentation: " + currentPresentation->get_designator() + " (" + currentPresentation->get_table_id() + " " + std::to_string(currentPresentation->get_object_id()) + ")").c_str(), flags);
+			bool isOpen = ImGui::TreeNodeEx(get_presentation_label(*currentPresentation).c_str(), flags);
 			ImGui::Unindent();
 
 			if (ImGui::IsItemClicked() && !ImGui::IsItemToggledOpen())
@@ -1585,15 +1880,15 @@ void DDOPGeneratorGUI::render_device_process_data_components(std::shared_ptr<iso
 	}
 }
 
-void DDOPGeneratorGUI::render_device_property_components(std::shared_ptr<isobus::task_controller_object::DevicePropertyObject> object)
+void DDOPGeneratorGUI::render_device_property_components(isobus::task_controller_object::DevicePropertyObject &object)
 {
-	ImGui::TextColored(ImVec4(0.0f, 1.0f, 0.0f, 1.0f), "DDI: %u (%s)", object->get_ddi(), isobus::DataDictionary::get_entry(object->get_ddi()).name.c_str());
-	ImGui::TextColored(ImVec4(1.0f, 0.0f, 0.0f, 1.0f), "Value: %d", object->get_value());
+	ImGui::TextColored(ImVec4(0.0f, 1.0f, 0.0f, 1.0f), "DDI: %u (%s)", object.get_ddi(), isobus::DataDictionary::get_entry(object.get_ddi()).name.c_str());
+	ImGui::TextColored(ImVec4(1.0f, 0.0f, 0.0f, 1.0f), "Value: %d", object.get_value());
 
 	// Try and get the presentation
-	if (0xFFFF != object->get_device_value_presentation_object_id())
+	if (0xFFFF != object.get_device_value_presentation_object_id())
 	{
-		auto currentDVP = std::dynamic_pointer_cast<isobus::task_controller_object::DeviceValuePresentationObject>(currentObjectPool->get_object_by_id(object->get_device_value_presentation_object_id()));
+		auto currentDVP = objectTreeIndex.get_object_view(object.get_device_value_presentation_object_id()).as_presentation();
 
 		if (nullptr != currentDVP)
 		{
@@ -1604,7 +1899,7 @@ void DDOPGeneratorGUI::render_device_property_components(std::shared_ptr<isobus:
 			}
 
 			ImGui::Indent();
-			bool isOpen = ImGui::TreeNodeEx(("Presentation: " + currentDVP->get_designator() + " (" + currentDVP->get_table_id() + " " + std::to_string(currentDVP->get_object_id()) + ")").c_str(), flags);
+			bool isOpen = ImGui::TreeNodeEx(get_presentation_label(*currentDVP).c_str(), flags);
 			ImGui::Unindent();
 
 			if (ImGui::IsItemClicked() && !ImGui::IsItemToggledOpen())
@@ -1615,32 +1910,33 @@ void DDOPGeneratorGUI::render_device_property_components(std::shared_ptr<isobus:
 
 			if (isOpen)
 			{
-				render_device_presentation_components(currentDVP);
+				render_device_presentation_components(*currentDVP);
 				ImGui::TreePop();
 			}
 		}
 	}
 }
 
-void DDOPGeneratorGUI::render_device_presentation_components(std::shared_ptr<isobus::task_controller_object::DeviceValuePresentationObject> object)
+void DDOPGeneratorGUI::render_device_presentation_components(isobus::task_controller_object::DeviceValuePresentationObject &object)
 {
-	ImGui::Text("Number of Decimals: %u", object->get_number_of_decimals());
-	ImGui::Text("Offset: %d", object->get_offset());
-	ImGui::Text("Scale: %f", object->get_scale());
+	ImGui::Text("Number of Decimals: %u", object.get_number_of_decimals());
+	ImGui::Text("Offset: %d", object.get_offset());
+	ImGui::Text("Scale: %f", object.get_scale());
 }
 
-void DDOPGeneratorGUI::on_selected_object_changed(std::shared_ptr<isobus::task_controller_object::Object> newObject)
+void DDOPGeneratorGUI::on_selected_object_changed(ObjectView newObject)
 {
 	memset(designatorBuffer, 0, sizeof(designatorBuffer));
 	memcpy(designatorBuffer, newObject->get_designator().c_str(), newObject->get_designator().length() <= 128 ? newObject->get_designator().length() : 128);
 	objectIDBuffer = newObject->get_object_id();
 	addChildComboIndex = 0;
+	editJournal.seal();
 
-	switch (newObject->get_object_type())
+	switch (newObject.get_type())
 	{
 		case isobus::task_controller_object::ObjectTypes::Device:
 		{
-			auto object = std::dynamic_pointer_cast<isobus::task_controller_object::DeviceObject>(newObject);
+			auto object = newObject.as_device();
 			memset(softwareVersionBuffer, 0, sizeof(softwareVersionBuffer));
 			memset(serialNumberBuffer, 0, sizeof(serialNumberBuffer));
 			memset(structureLabelBuffer, 0, sizeof(structureLabelBuffer));
@@ -1683,7 +1979,7 @@ void DDOPGeneratorGUI::on_selected_object_changed(std::shared_ptr<isobus::task_c
 
 		case isobus::task_controller_object::ObjectTypes::DeviceElement:
 		{
-			auto object = std::dynamic_pointer_cast<isobus::task_controller_object::DeviceElementObject>(newObject);
+			auto object = newObject.as_element();
 			elementNumberBuffer = object->get_element_number();
 			parentObjectBuffer = object->get_parent_object();
 		}
@@ -1691,7 +1987,7 @@ void DDOPGeneratorGUI::on_selected_object_changed(std::shared_ptr<isobus::task_c
 
 		case isobus::task_controller_object::ObjectTypes::DeviceProcessData:
 		{
-			auto object = std::dynamic_pointer_cast<isobus::task_controller_object::DeviceProcessDataObject>(newObject);
+			auto object = newObject.as_process_data();
 			presentationObjectBuffer = object->get_device_value_presentation_object_id();
 			ddiBuffer = object->get_ddi();
 
@@ -1707,7 +2003,7 @@ void DDOPGeneratorGUI::on_selected_object_changed(std::shared_ptr<isobus::task_c
 
 		case isobus::task_controller_object::ObjectTypes::DeviceProperty:
 		{
-			auto object = std::dynamic_pointer_cast<isobus::task_controller_object::DevicePropertyObject>(newObject);
+			auto object = newObject.as_property();
 			ddiBuffer = object->get_ddi();
 			presentationObjectBuffer = object->get_device_value_presentation_object_id();
 			valueBuffer = object->get_value();
@@ -1716,7 +2012,7 @@ void DDOPGeneratorGUI::on_selected_object_changed(std::shared_ptr<isobus::task_c
 
 		case isobus::task_controller_object::ObjectTypes::DeviceValuePresentation:
 		{
-			auto object = std::dynamic_pointer_cast<isobus::task_controller_object::DeviceValuePresentationObject>(newObject);
+			auto object = newObject.as_presentation();
 			numberDecimalsBuffer = object->get_number_of_decimals();
 			offsetBuffer = object->get_offset();
 			scaleBuffer = object->get_scale();
@@ -1824,7 +2120,7 @@ std::string DDOPGeneratorGUI::get_object_type_string(isobus::task_controller_obj
 	return retVal;
 }
 
-std::string DDOPGeneratorGUI::get_object_display_name(std::shared_ptr<isobus::task_controller_object::Object> object)
+std::string DDOPGeneratorGUI::get_object_display_name(ObjectView object)
 {
 	std::string displayName = object->get_designator();
 	
@@ -1835,11 +2131,11 @@ std::string DDOPGeneratorGUI::get_object_display_name(std::shared_ptr<isobus::ta
 	}
 	
 	// If designator is empty or default, use appropriate fallback based on object type
-	const auto objectType = object->get_object_type();
+	const auto objectType = object.get_type();
 	
 	if (objectType == isobus::task_controller_object::ObjectTypes::DeviceProcessData)
 	{
-		auto dpd = std::dynamic_pointer_cast<isobus::task_controller_object::DeviceProcessDataObject>(object);
+		auto dpd = object.as_process_data();
 		if (dpd != nullptr)
 		{
 			displayName = isobus::DataDictionary::get_entry(dpd->get_ddi()).name;
@@ -1847,7 +2143,7 @@ std::string DDOPGeneratorGUI::get_object_display_name(std::shared_ptr<isobus::ta
 	}
 	else if (objectType == isobus::task_controller_object::ObjectTypes::DeviceProperty)
 	{
-		auto dpt = std::dynamic_pointer_cast<isobus::task_controller_object::DevicePropertyObject>(object);
+		auto dpt = object.as_property();
 		if (dpt != nullptr)
 		{
 			displayName = isobus::DataDictionary::get_entry(dpt->get_ddi()).name;
@@ -1855,7 +2151,7 @@ std::string DDOPGeneratorGUI::get_object_display_name(std::shared_ptr<isobus::ta
 	}
 	else if (objectType == isobus::task_controller_object::ObjectTypes::DeviceElement)
 	{
-		auto det = std::dynamic_pointer_cast<isobus::task_controller_object::DeviceElementObject>(object);
+		auto det = object.as_element();
 		if (det != nullptr)
 		{
 			displayName = get_element_type_string(det->get_type()) + " " + std::to_string(det->get_element_number());
@@ -1867,6 +2163,8 @@ std::string DDOPGeneratorGUI::get_object_display_name(std::shared_ptr<isobus::ta
 
 void DDOPGeneratorGUI::render_save()
 {
+	FrameProfiler::ScopedZone profilerZone(frameProfiler, FrameProfiler::Zone::Save);
+
 	bool shouldShowSaveFailed = false;
 	bool shouldShowSaveSucceeded = false;
 	if (ImGui::BeginPopupModal("##Save Modal", NULL, ImGuiWindowFlags_AlwaysAutoResize))
@@ -1877,8 +2175,9 @@ void DDOPGeneratorGUI::render_save()
 		{
 			ImGui::CloseCurrentPopup();
 			std::vector<std::uint8_t> binaryDDOP;
-			logger.logHistory.clear();
-			auto serializationSuccess = currentObjectPool->generate_binary_object_pool(binaryDDOP);
+			operationLog.clear();
+			ScopedLogContext logScope(operationLog);
+			auto serializationSuccess = ddopSerializer.serialize(*currentObjectPool, binaryDDOP);
 
 			if (serializationSuccess)
 			{
@@ -1936,10 +2235,12 @@ void DDOPGeneratorGUI::render_save()
 				{
 					currentObjectPool->set_task_controller_compatibility_level(4);
 				}
+				backgroundValidator.on_pool_edited();
 
 				std::vector<std::uint8_t> binaryDDOP;
-				logger.logHistory.clear();
-				auto serializationSuccess = currentObjectPool->generate_binary_object_pool(binaryDDOP);
+				operationLog.clear();
+				ScopedLogContext logScope(operationLog);
+				auto serializationSuccess = ddopSerializer.serialize(*currentObjectPool, binaryDDOP);
 
 				if (serializationSuccess)
 				{
@@ -1991,29 +2292,23 @@ void DDOPGeneratorGUI::render_save()
 
 			if ((nullptr != currentObjectPool) && currentPoolValid)
 			{
-				std::string taskDataXML;
-				logger.logHistory.clear();
+				operationLog.clear();
+				ScopedLogContext logScope(operationLog);
 
-				if (currentObjectPool->generate_task_data_iso_xml(taskDataXML))
-				{
-					const char *fileName = (0 == filePathBuffer[0]) ? "TASKDATA.XML" : filePathBuffer;
+				const char *fileName = (0 == filePathBuffer[0]) ? "TASKDATA.XML" : filePathBuffer;
 
-					errno = 0;
-					std::ofstream outFile(fileName, std::ios_base::trunc);
-					outFile << taskDataXML;
-					outFile.close();
+				// Stream the XML straight into the file instead of building it in memory first
+				errno = 0;
+				std::ofstream outFile(fileName, std::ios_base::trunc);
+				bool written = outFile.is_open() && IsoXmlWriter::write_task_data(*currentObjectPool, outFile);
+				outFile.close();
 
-					shouldShowSaveSucceeded = outFile.good();
-					shouldShowSaveFailed = !outFile.good();
+				shouldShowSaveSucceeded = written && outFile.good();
+				shouldShowSaveFailed = !shouldShowSaveSucceeded;
 
-					if (shouldShowSaveFailed)
-					{
-						LOG_ERROR("[DDOP]: Could not write \"%s\": %s", fileName, (0 != errno) ? std::strerror(errno) : "unknown error");
-					}
-				}
-				else
+				if (shouldShowSaveFailed)
 				{
-					shouldShowSaveFailed = true;
+					LOG_ERROR("[DDOP]: Could not write \"%s\": %s", fileName, (0 != errno) ? std::strerror(errno) : "the pool has no device object");
 				}
 			}
 		}
@@ -2051,10 +2346,7 @@ void DDOPGeneratorGUI::render_save()
 	{
 		ImGui::Text("File Saving Failed");
 		ImGui::Separator();
-		for (auto &logString : logger.logHistory)
-		{
-			ImGui::Text("%s", logString.logText.c_str());
-		}
+		render_operation_log();
 
 		if (ImGui::Button("OK", ImVec2(120, 0)))
 		{
@@ -2068,37 +2360,157 @@ void DDOPGeneratorGUI::render_save()
 
 void DDOPGeneratorGUI::render_all_objects()
 {
+	FrameProfiler::ScopedZone profilerZone(frameProfiler, FrameProfiler::Zone::AllObjects);
+
 	if (ImGui::TreeNode("All Objects"))
 	{
-		for (std::uint32_t j = 0; j < currentObjectPool->size(); j++)
+		if (ImGui::InputTextWithHint("##AllObjectsFilter", "Filter by type, ID, designator or DDI", allObjectsFilterBuffer, IM_ARRAYSIZE(allObjectsFilterBuffer)))
 		{
-			auto currentObject = currentObjectPool->get_object_by_index(j);
+			allObjectsListDirty = true;
+		}
+
+		const ImGuiTableFlags tableFlags = ImGuiTableFlags_Sortable | ImGuiTableFlags_ScrollY | ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersOuter | ImGuiTableFlags_BordersV | ImGuiTableFlags_Resizable;
+		const float minimumTableHeight = ImGui::GetTextLineHeightWithSpacing() * 10;
+		const float tableHeight = std::max(ImGui::GetContentRegionAvail().y, minimumTableHeight);
 
-			if (nullptr != currentObject)
+		if (ImGui::BeginTable("##AllObjectsTable", 4, tableFlags, ImVec2(0.0f, tableHeight)))
+		{
+			ImGui::TableSetupScrollFreeze(0, 1);
+			ImGui::TableSetupColumn("Type", ImGuiTableColumnFlags_WidthFixed, 0.0f, static_cast<ImGuiID>(ObjectListColumn::Type));
+			ImGui::TableSetupColumn("ID", ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_DefaultSort, 0.0f, static_cast<ImGuiID>(ObjectListColumn::ID));
+			ImGui::TableSetupColumn("Designator", ImGuiTableColumnFlags_WidthStretch, 0.0f, static_cast<ImGuiID>(ObjectListColumn::Designator));
+			ImGui::TableSetupColumn("DDI", ImGuiTableColumnFlags_WidthFixed, 0.0f, static_cast<ImGuiID>(ObjectListColumn::DDI));
+			ImGui::TableHeadersRow();
+
+			ImGuiTableSortSpecs *sortSpecs = ImGui::TableGetSortSpecs();
+			if ((nullptr != sortSpecs) && sortSpecs->SpecsDirty)
+			{
+				allObjectsListDirty = true;
+			}
+
+			if (allObjectsListDirty)
 			{
-				ImGuiTreeNodeFlags base_flags = ImGuiTreeNodeFlags_OpenOnArrow | ImGuiTreeNodeFlags_OpenOnDoubleClick | ImGuiTreeNodeFlags_SpanAvailWidth;
+				rebuild_all_objects_rows(sortSpecs);
+				allObjectsListDirty = false;
+
+				if (nullptr != sortSpecs)
+				{
+					sortSpecs->SpecsDirty = false;
+				}
+			}
 
-				if (selectedObjectID == currentObject->get_object_id())
+			// Only the rows that are scrolled into view get submitted
+			ImGuiListClipper clipper;
+			clipper.Begin(static_cast<int>(allObjectsRows.size()));
+			while (clipper.Step())
+			{
+				for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++)
 				{
-					base_flags |= ImGuiTreeNodeFlags_Selected;
+					const std::uint32_t row = allObjectsRows[i];
+					const std::uint16_t rowObjectID = objectPoolSnapshot.get_object_id(row);
+					const auto designator = objectPoolSnapshot.get_designator(row);
+
+					ImGui::PushID(static_cast<int>(rowObjectID));
+					ImGui::TableNextRow();
+					ImGui::TableNextColumn();
+					if (ImGui::Selectable(ObjectPoolSnapshot::get_table_id(objectPoolSnapshot.get_type(row)), selectedObjectID == rowObjectID, ImGuiSelectableFlags_SpanAllColumns))
+					{
+						selectedObjectID = rowObjectID;
+						on_selected_object_changed(objectTreeIndex.get_object_view(rowObjectID));
+					}
+					ImGui::TableNextColumn();
+					ImGui::Text("%u", rowObjectID);
+					ImGui::TableNextColumn();
+					ImGui::TextUnformatted(designator.data(), designator.data() + designator.size());
+					ImGui::TableNextColumn();
+					if (objectPoolSnapshot.has_ddi(row))
+					{
+						ImGui::Text("%u", objectPoolSnapshot.get_ddi(row));
+					}
+					ImGui::PopID();
 				}
+			}
+			ImGui::EndTable();
+		}
+		ImGui::TreePop();
+	}
+}
 
-				bool isOpen = ImGui::TreeNodeEx((get_object_display_name(currentObject) + " (" + currentObject->get_table_id() + " " + std::to_string(currentObject->get_object_id()) + ")").c_str(), base_flags);
+void DDOPGeneratorGUI::rebuild_all_objects_rows(const ImGuiTableSortSpecs *sortSpecs)
+{
+	std::string filter(allObjectsFilterBuffer);
+	std::transform(filter.begin(), filter.end(), filter.begin(), [](unsigned char character) { return static_cast<char>(std::tolower(character)); });
 
-				if (ImGui::IsItemClicked() && !ImGui::IsItemToggledOpen())
+	allObjectsRows.clear();
+	allObjectsRows.reserve(objectPoolSnapshot.size());
+
+	for (std::uint32_t row = 0; row < objectPoolSnapshot.size(); row++)
+	{
+		if (!filter.empty())
+		{
+			// Match against everything shown in the row, plus the longer names shown in the tree
+			const auto type = objectPoolSnapshot.get_type(row);
+			std::string searchText = get_object_label(objectTreeIndex.get_object_view(objectPoolSnapshot.get_object_id(row))) + " " + get_object_type_string(type) + " ";
+			searchText += objectPoolSnapshot.get_designator(row);
+
+			if (objectPoolSnapshot.has_ddi(row))
+			{
+				searchText += " " + std::to_string(objectPoolSnapshot.get_ddi(row));
+			}
+			std::transform(searchText.begin(), searchText.end(), searchText.begin(), [](unsigned char character) { return static_cast<char>(std::tolower(character)); });
+
+			if (std::string::npos == searchText.find(filter))
+			{
+				continue;
+			}
+		}
+		allObjectsRows.push_back(row);
+	}
+
+	if ((nullptr != sortSpecs) && (sortSpecs->SpecsCount > 0))
+	{
+		const auto column = static_cast<ObjectListColumn>(sortSpecs->Specs[0].ColumnUserID);
+		const bool ascending = (ImGuiSortDirection_Descending != sortSpecs->Specs[0].SortDirection);
+		const ObjectPoolSnapshot &snapshot = objectPoolSnapshot;
+
+		std::stable_sort(allObjectsRows.begin(), allObjectsRows.end(), [column, ascending, &snapshot](std::uint32_t left, std::uint32_t right) {
+			int comparison = 0;
+
+			switch (column)
+			{
+				case ObjectListColumn::Type:
 				{
-					selectedObjectID = currentObject->get_object_id();
-					on_selected_object_changed(currentObject);
+					comparison = std::strcmp(ObjectPoolSnapshot::get_table_id(snapshot.get_type(left)), ObjectPoolSnapshot::get_table_id(snapshot.get_type(right)));
 				}
+				break;
 
-				if (isOpen)
+				case ObjectListColumn::Designator:
 				{
-					render_object_components(currentObject);
-					ImGui::TreePop();
+					comparison = snapshot.get_designator(left).compare(snapshot.get_designator(right));
 				}
+				break;
+
+				case ObjectListColumn::DDI:
+				{
+					// Objects without a DDI sort after all objects that have one
+					comparison = static_cast<int>(snapshot.has_ddi(right)) - static_cast<int>(snapshot.has_ddi(left));
+					if (0 == comparison)
+					{
+						comparison = static_cast<int>(snapshot.get_ddi(left)) - static_cast<int>(snapshot.get_ddi(right));
+					}
+				}
+				break;
+
+				default:
+					break;
 			}
-		}
-		ImGui::TreePop();
+
+			if (0 == comparison)
+			{
+				comparison = static_cast<int>(snapshot.get_object_id(left)) - static_cast<int>(snapshot.get_object_id(right));
+			}
+			return ascending ? (comparison < 0) : (comparison > 0);
+		});
 	}
 }
 
@@ -2133,22 +2545,568 @@ const std::array<std::uint8_t, 7> DDOPGeneratorGUI::generate_localization_label(
 
 std::uint16_t DDOPGeneratorGUI::get_first_unused_id() const
 {
-	std::uint16_t retVal = 0;
+	std::uint16_t retVal = 0xFFFF;
 
 	if (nullptr != currentObjectPool)
 	{
-		for (std::uint16_t i = 0; i < 0xFFFF; i++)
+		retVal = objectIDAllocator.get_first_unused_id();
+	}
+	return retVal;
+}
+
+void DDOPGeneratorGUI::rebuild_object_indexes()
+{
+	if (nullptr != currentObjectPool)
+	{
+		objectTreeIndex.rebuild(*currentObjectPool);
+		objectReferenceIndex.rebuild(*currentObjectPool);
+		objectPoolSnapshot.rebuild(*currentObjectPool);
+		objectIDAllocator.rebuild(*currentObjectPool);
+		backgroundValidator.on_pool_edited();
+	}
+	else
+	{
+		objectTreeIndex.clear();
+		objectReferenceIndex.clear();
+		objectPoolSnapshot.clear();
+		objectIDAllocator.clear();
+		backgroundValidator.clear();
+	}
+	objectLabelCache.clear();
+	editJournal.clear();
+	ddopSerializer.invalidate();
+	allObjectsListDirty = true;
+	objectTreeFilter.on_pool_edited();
+	objectTreeFilterDirty = true;
+}
+
+void DDOPGeneratorGUI::on_object_added(std::shared_ptr<isobus::task_controller_object::Object> object)
+{
+	objectTreeIndex.on_object_added(object);
+	objectReferenceIndex.on_object_added(object);
+	objectPoolSnapshot.on_object_added(*object);
+	objectIDAllocator.mark_used(object->get_object_id());
+	objectLabelCache.invalidate(object->get_object_id());
+	ddopSerializer.invalidate();
+	backgroundValidator.on_pool_edited();
+	allObjectsListDirty = true;
+	objectTreeFilter.on_pool_edited();
+	objectTreeFilterDirty = true;
+}
+
+void DDOPGeneratorGUI::on_object_removed(std::uint16_t objectID)
+{
+	objectReferenceIndex.on_object_removed(objectTreeIndex.get_object(objectID));
+	objectTreeIndex.on_object_removed(objectID);
+	objectPoolSnapshot.on_object_removed(objectID);
+	objectIDAllocator.mark_unused(objectID);
+	objectLabelCache.invalidate(objectID);
+	ddopSerializer.invalidate();
+	backgroundValidator.on_pool_edited();
+	allObjectsListDirty = true;
+	objectTreeFilter.on_pool_edited();
+	objectTreeFilterDirty = true;
+}
+
+void DDOPGeneratorGUI::on_object_id_changed(std::uint16_t oldID, std::uint16_t newID)
+{
+	objectTreeIndex.on_object_id_changed(oldID, newID);
+	objectPoolSnapshot.on_object_id_changed(oldID, newID);
+	objectIDAllocator.mark_unused(oldID);
+	objectIDAllocator.mark_used(newID);
+	objectLabelCache.invalidate(oldID);
+	objectLabelCache.invalidate(newID);
+	ddopSerializer.invalidate();
+	backgroundValidator.on_pool_edited();
+	allObjectsListDirty = true;
+	objectTreeFilter.on_pool_edited();
+	objectTreeFilterDirty = true;
+}
+
+void DDOPGeneratorGUI::delete_objects(const std::vector<std::uint16_t> &objectIDs)
+{
+	std::unordered_set<std::uint16_t> deletedIDs(objectIDs.begin(), objectIDs.end());
+
+	// The whole deletion, including the pruned references, is undone in one step
+	editJournal.begin_group();
+
+	for (auto objectID : objectIDs)
+	{
+		// Copied, since pruning a reference edits the list being iterated
+		auto references = objectReferenceIndex.get_references_to(objectID);
+
+		for (auto &reference : references)
 		{
-			if (nullptr == currentObjectPool->get_object_by_id(i))
+			if (0 != deletedIDs.count(reference.referrer->get_object_id()))
 			{
-				retVal = i;
+				// The referrer is being deleted too, so there is nothing to prune
+				continue;
+			}
+
+			switch (reference.type)
+			{
+				case ObjectReferenceIndex::ReferenceType::ChildObject:
+				{
+					auto element = std::static_pointer_cast<isobus::task_controller_object::DeviceElementObject>(reference.referrer);
+
+					for (std::uint16_t i = 0; i < element->get_number_child_objects(); i++)
+					{
+						if (objectID == element->get_child_object_id(i))
+						{
+							commit_edit(EditJournal::Delta::child_reference_removed(element->get_object_id(), i, objectID));
+							break;
+						}
+					}
+				}
+				break;
+
+				case ObjectReferenceIndex::ReferenceType::ParentObject:
+				{
+					// Orphan elements that had the deleted object as their parent
+					commit_edit(EditJournal::Delta::number(reference.referrer->get_object_id(), EditJournal::Field::ParentObject, objectID, 0xFFFF));
+				}
+				break;
+
+				case ObjectReferenceIndex::ReferenceType::Presentation:
+				{
+					commit_edit(EditJournal::Delta::number(reference.referrer->get_object_id(), EditJournal::Field::PresentationObject, objectID, 0xFFFF));
+				}
 				break;
 			}
 		}
 	}
-	else
+
+	for (auto objectID : objectIDs)
+	{
+		auto object = objectTreeIndex.get_object(objectID);
+
+		if (nullptr != object)
+		{
+			commit_edit(EditJournal::Delta::object_removed(object));
+		}
+	}
+	editJournal.end_group();
+}
+
+std::vector<std::uint16_t> DDOPGeneratorGUI::get_element_subtree(std::uint16_t elementID) const
+{
+	std::vector<std::uint16_t> retVal;
+	std::vector<std::uint16_t> elementsToVisit = { elementID };
+	std::unordered_set<std::uint16_t> subtreeIDs;
+
+	while (!elementsToVisit.empty())
+	{
+		std::uint16_t currentID = elementsToVisit.back();
+		elementsToVisit.pop_back();
+
+		// Guards against parent loops
+		if (subtreeIDs.insert(currentID).second)
+		{
+			retVal.push_back(currentID);
+
+			for (auto &childElement : objectTreeIndex.get_child_elements(currentID))
+			{
+				elementsToVisit.push_back(childElement->get_object_id());
+			}
+		}
+	}
+
+	// Take process data and properties along only if nothing outside the subtree still uses them
+	std::size_t numberOfElements = retVal.size();
+	for (std::size_t i = 0; i < numberOfElements; i++)
 	{
-		retVal = 0xFFFF;
+		auto element = std::static_pointer_cast<isobus::task_controller_object::DeviceElementObject>(objectTreeIndex.get_object(retVal[i]));
+
+		for (std::uint16_t j = 0; j < element->get_number_child_objects(); j++)
+		{
+			std::uint16_t childID = element->get_child_object_id(j);
+			auto child = objectTreeIndex.get_object(childID);
+
+			if ((nullptr == child) ||
+			    (isobus::task_controller_object::ObjectTypes::DeviceElement == child->get_object_type()) ||
+			    (0 != subtreeIDs.count(childID)))
+			{
+				continue;
+			}
+
+			const auto &references = objectReferenceIndex.get_references_to(childID);
+			bool onlyReferencedBySubtree = std::all_of(references.begin(), references.end(), [&subtreeIDs](const ObjectReferenceIndex::Reference &reference) {
+				return 0 != subtreeIDs.count(reference.referrer->get_object_id());
+			});
+
+			if (onlyReferencedBySubtree)
+			{
+				subtreeIDs.insert(childID);
+				retVal.push_back(childID);
+			}
+		}
 	}
 	return retVal;
 }
+
+void DDOPGeneratorGUI::commit_edit(EditJournal::Delta delta)
+{
+	if (delta.oldValue != delta.newValue)
+	{
+		apply_edit(delta, false);
+		editJournal.record(std::move(delta));
+	}
+}
+
+void DDOPGeneratorGUI::apply_edit(const EditJournal::Delta &delta, bool revert)
+{
+	const auto &value = revert ? delta.oldValue : delta.newValue;
+	const auto &previousValue = revert ? delta.newValue : delta.oldValue;
+	std::uint16_t objectID = delta.objectID;
+
+	if (EditJournal::Field::ObjectID == delta.field)
+	{
+		// When reverting, the object is found by the ID the edit gave it
+		objectID = static_cast<std::uint16_t>(std::get<std::int64_t>(previousValue));
+	}
+
+	if (EditJournal::Field::Object == delta.field)
+	{
+		if (auto object = std::get_if<std::shared_ptr<isobus::task_controller_object::Object>>(&value))
+		{
+			// The pool only holds objects it created itself, so the object comes back as a copy
+			if (add_object_copy(*currentObjectPool, *object))
+			{
+				on_object_added(currentObjectPool->get_object_by_index(currentObjectPool->size() - 1));
+			}
+		}
+		else
+		{
+			on_object_removed(objectID);
+			currentObjectPool->remove_object_by_id(objectID);
+
+			if (selectedObjectID == objectID)
+			{
+				selectedObjectID = 0xFFFF;
+			}
+		}
+		return;
+	}
+
+	auto object = objectTreeIndex.get_object(objectID);
+
+	if (nullptr == object)
+	{
+		return;
+	}
+
+	auto number = [&value]() {
+		return std::get<std::int64_t>(value);
+	};
+	auto text = [&value]() -> const std::string & {
+		return std::get<std::string>(value);
+	};
+	ObjectView view(object);
+	auto device = view.as_device();
+	auto element = view.as_element();
+	auto processData = view.as_process_data();
+	auto property = view.as_property();
+	auto presentation = view.as_presentation();
+
+	switch (delta.field)
+	{
+		case EditJournal::Field::Designator:
+		{
+			object->set_designator(text());
+		}
+		break;
+
+		case EditJournal::Field::SoftwareVersion:
+		{
+			device->set_software_version(text());
+		}
+		break;
+
+		case EditJournal::Field::SerialNumber:
+		{
+			device->set_serial_number(text());
+		}
+		break;
+
+		case EditJournal::Field::StructureLabel:
+		{
+			device->set_structure_label(text());
+		}
+		break;
+
+		case EditJournal::Field::ExtendedStructureLabel:
+		{
+			device->set_extended_structure_label(std::vector<std::uint8_t>(text().begin(), text().end()));
+		}
+		break;
+
+		case EditJournal::Field::IsoName:
+		{
+			device->set_iso_name(static_cast<std::uint64_t>(number()));
+		}
+		break;
+
+		case EditJournal::Field::LocalizationLabel:
+		{
+			std::array<std::uint8_t, 7> localizationLabel = { 0 };
+			std::copy_n(text().begin(), std::min(text().size(), localizationLabel.size()), localizationLabel.begin());
+			device->set_localization_label(localizationLabel);
+		}
+		break;
+
+		case EditJournal::Field::ObjectID:
+		{
+			std::uint16_t newID = static_cast<std::uint16_t>(number());
+			on_object_id_changed(objectID, newID);
+			object->set_object_id(newID);
+
+			if (selectedObjectID == objectID)
+			{
+				selectedObjectID = newID;
+			}
+		}
+		break;
+
+		case EditJournal::Field::ElementNumber:
+		{
+			element->set_element_number(static_cast<std::uint16_t>(number()));
+		}
+		break;
+
+		case EditJournal::Field::ParentObject:
+		{
+			std::uint16_t newParentID = static_cast<std::uint16_t>(number());
+			objectTreeIndex.on_parent_changed(objectID, element->get_parent_object(), newParentID);
+			objectReferenceIndex.on_parent_changed(object, element->get_parent_object(), newParentID);
+			element->set_parent_object(newParentID);
+			objectPoolSnapshot.on_object_changed(*element);
+			on_object_references_changed();
+		}
+		break;
+
+		case EditJournal::Field::ChildReference:
+		{
+			std::vector<std::uint16_t> childIDs;
+
+			for (std::uint16_t i = 0; i < element->get_number_child_objects(); i++)
+			{
+				childIDs.push_back(element->get_child_object_id(i));
+			}
+
+			if (std::holds_alternative<std::int64_t>(value))
+			{
+				std::uint16_t childID = static_cast<std::uint16_t>(number());
+				childIDs.insert(childIDs.begin() + std::min<std::size_t>(delta.position, childIDs.size()), childID);
+				objectReferenceIndex.on_child_reference_added(object, childID);
+			}
+			else
+			{
+				std::uint16_t childID = static_cast<std::uint16_t>(std::get<std::int64_t>(previousValue));
+				auto child = ((delta.position < childIDs.size()) && (childID == childIDs.at(delta.position))) ? (childIDs.begin() + delta.position) : std::find(childIDs.begin(), childIDs.end(), childID);
+
+				if (childIDs.end() != child)
+				{
+					childIDs.erase(child);
+					objectReferenceIndex.on_child_reference_removed(object, childID);
+				}
+			}
+
+			// Elements can only append child references, so the list is rebuilt to keep its order
+			while (0 != element->get_number_child_objects())
+			{
+				element->remove_reference_to_child_object(element->get_child_object_id(0));
+			}
+			for (auto childID : childIDs)
+			{
+				element->add_reference_to_child_object(childID);
+			}
+			on_object_references_changed();
+		}
+		break;
+
+		case EditJournal::Field::DDI:
+		{
+			if (nullptr != processData)
+			{
+				processData->set_ddi(static_cast<std::uint16_t>(number()));
+			}
+			else
+			{
+				property->set_ddi(static_cast<std::uint16_t>(number()));
+			}
+		}
+		break;
+
+		case EditJournal::Field::PropertiesBitfield:
+		{
+			processData->set_properties_bitfield(static_cast<std::uint8_t>(number()));
+		}
+		break;
+
+		case EditJournal::Field::TriggerMethodsBitfield:
+		{
+			processData->set_trigger_methods_bitfield(static_cast<std::uint8_t>(number()));
+		}
+		break;
+
+		case EditJournal::Field::Value:
+		{
+			property->set_value(static_cast<std::int32_t>(number()));
+		}
+		break;
+
+		case EditJournal::Field::PresentationObject:
+		{
+			std::uint16_t newPresentationID = static_cast<std::uint16_t>(number());
+
+			if (nullptr != processData)
+			{
+				objectReferenceIndex.on_presentation_changed(object, processData->get_device_value_presentation_object_id(), newPresentationID);
+				processData->set_device_value_presentation_object_id(newPresentationID);
+			}
+			else
+			{
+				objectReferenceIndex.on_presentation_changed(object, property->get_device_value_presentation_object_id(), newPresentationID);
+				property->set_device_value_presentation_object_id(newPresentationID);
+			}
+			objectPoolSnapshot.on_object_changed(*object);
+			on_object_references_changed();
+		}
+		break;
+
+		case EditJournal::Field::Offset:
+		{
+			presentation->set_offset(static_cast<std::int32_t>(number()));
+		}
+		break;
+
+		case EditJournal::Field::Scale:
+		{
+			presentation->set_scale(std::get<float>(value));
+		}
+		break;
+
+		case EditJournal::Field::NumberOfDecimals:
+		{
+			presentation->set_number_of_decimals(static_cast<std::uint8_t>(number()));
+		}
+		break;
+
+		case EditJournal::Field::Object:
+			break;
+	}
+
+	if ((EditJournal::Field::ObjectID != delta.field) &&
+	    (EditJournal::Field::ParentObject != delta.field) &&
+	    (EditJournal::Field::ChildReference != delta.field) &&
+	    (EditJournal::Field::PresentationObject != delta.field))
+	{
+		on_object_changed(objectID);
+	}
+}
+
+void DDOPGeneratorGUI::undo_edit()
+{
+	auto entry = editJournal.undo();
+
+	if (nullptr != entry)
+	{
+		for (auto delta = entry->deltas.rbegin(); delta != entry->deltas.rend(); delta++)
+		{
+			apply_edit(*delta, true);
+		}
+		reload_selected_object();
+	}
+}
+
+void DDOPGeneratorGUI::redo_edit()
+{
+	auto entry = editJournal.redo();
+
+	if (nullptr != entry)
+	{
+		for (const auto &delta : entry->deltas)
+		{
+			apply_edit(delta, false);
+		}
+		reload_selected_object();
+	}
+}
+
+void DDOPGeneratorGUI::reload_selected_object()
+{
+	// The edit buffers are compared against the object every frame, so they must match it again
+	auto selectedObject = objectTreeIndex.get_object(selectedObjectID);
+
+	if (nullptr != selectedObject)
+	{
+		on_selected_object_changed(selectedObject);
+	}
+	else
+	{
+		selectedObjectID = 0xFFFF;
+	}
+}
+
+void DDOPGeneratorGUI::on_object_references_changed()
+{
+	ddopSerializer.invalidate();
+	backgroundValidator.on_pool_edited();
+	objectTreeFilter.on_pool_edited();
+	objectTreeFilterDirty = true;
+}
+
+void DDOPGeneratorGUI::on_object_changed(std::uint16_t objectID)
+{
+	auto object = objectTreeIndex.get_object_view(objectID);
+
+	if (object.is_valid())
+	{
+		objectPoolSnapshot.on_object_changed(*object.get());
+	}
+	objectLabelCache.invalidate(objectID);
+	ddopSerializer.mark_dirty(objectID);
+	backgroundValidator.on_pool_edited();
+	allObjectsListDirty = true;
+	objectTreeFilter.on_pool_edited();
+	objectTreeFilterDirty = true;
+}
+
+const std::string &DDOPGeneratorGUI::get_object_label(ObjectView object)
+{
+	auto cachedLabel = objectLabelCache.get(object->get_object_id(), ObjectLabelCache::LabelType::Name);
+
+	if (nullptr == cachedLabel)
+	{
+		cachedLabel = &objectLabelCache.set(object->get_object_id(),
+		                                    ObjectLabelCache::LabelType::Name,
+		                                    get_object_display_name(object) + " (" + object->get_table_id() + " " + std::to_string(object->get_object_id()) + ")");
+	}
+	return *cachedLabel;
+}
+
+const std::string &DDOPGeneratorGUI::get_presentation_label(const isobus::task_controller_object::DeviceValuePresentationObject &object)
+{
+	auto cachedLabel = objectLabelCache.get(object.get_object_id(), ObjectLabelCache::LabelType::Presentation);
+
+	if (nullptr == cachedLabel)
+	{
+		cachedLabel = &objectLabelCache.set(object.get_object_id(),
+		                                    ObjectLabelCache::LabelType::Presentation,
+		                                    "Presentation: " + object.get_designator() + " (" + object.get_table_id() + " " + std::to_string(object.get_object_id()) + ")");
+	}
+	return *cachedLabel;
+}
+
+void DDOPGeneratorGUI::render_operation_log() const
+{
+	std::size_t numberOfOverwrittenMessages = operationLog.get_number_of_overwritten_messages();
+
+	if (0 != numberOfOverwrittenMessages)
+	{
+		ImGui::Text("(%zu earlier messages not shown)", numberOfOverwrittenMessages);
+	}
+	operationLog.for_each_message([](isobus::CANStackLogger::LoggingLevel, const char *text) {
+		ImGui::TextUnformatted(text);
+	});
+}
@@ -0,0 +1,159 @@
+//================================================================================================
+/// @file incremental_serializer.cpp
+///
+/// @brief Implements a serializer that only re-encodes the DDOP objects that changed
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso and the Open-Agriculture developers
+//================================================================================================
+#include "incremental_serializer.hpp"
+
+#include <algorithm>
+
+void IncrementalSerializer::mark_dirty(std::uint16_t objectID)
+{
+	if (cacheValid)
+	{
+		dirtyObjectIDs.insert(objectID);
+	}
+}
+
+void IncrementalSerializer::invalidate()
+{
+	cacheValid = false;
+	dirtyObjectIDs.clear();
+}
+
+bool IncrementalSerializer::serialize(isobus::DeviceDescriptorObjectPool &pool, std::vector<std::uint8_t> &binaryPool)
+{
+	bool retVal = false;
+
+	// The encoding of some objects depends on the compatibility level, and objects may have been added
+	// or removed without invalidate() being called, so either of those means starting over.
+	if ((!cacheValid) ||
+	    (pool.get_task_controller_compatibility_level() != cachedCompatibilityLevel) ||
+	    (pool.size() != cachedObjects.size()))
+	{
+		retVal = serialize_full(pool);
+	}
+	else
+	{
+		retVal = serialize_dirty_objects(pool);
+
+		if (!retVal)
+		{
+			retVal = serialize_full(pool);
+		}
+	}
+
+	if (retVal)
+	{
+		binaryPool = cachedBinary;
+	}
+	else
+	{
+		binaryPool.clear();
+	}
+	return retVal;
+}
+
+bool IncrementalSerializer::serialize_full(isobus::DeviceDescriptorObjectPool &pool)
+{
+	invalidate();
+	cachedObjects.clear();
+	cachedObjectIndexByID.clear();
+
+	// The pool does the validation and logs what is wrong, so it stays the authority on whether the DDOP is valid
+	bool retVal = pool.generate_binary_object_pool(cachedBinary);
+
+	if (retVal)
+	{
+		std::size_t offset = 0;
+
+		cachedObjects.reserve(pool.size());
+		cachedObjectIndexByID.reserve(pool.size());
+
+		for (std::uint32_t i = 0; i < pool.size(); i++)
+		{
+			auto object = pool.get_object_by_index(i);
+			std::size_t length = object->get_binary_object().size();
+
+			cachedObjectIndexByID[object->get_object_id()] = cachedObjects.size();
+			cachedObjects.push_back({ object, offset, length });
+			offset += length;
+		}
+
+		// Only patch the binary later if it really is the objects laid end to end
+		cacheValid = (offset == cachedBinary.size());
+		cachedCompatibilityLevel = pool.get_task_controller_compatibility_level();
+	}
+	else
+	{
+		cachedBinary.clear();
+	}
+	return retVal;
+}
+
+bool IncrementalSerializer::serialize_dirty_objects(isobus::DeviceDescriptorObjectPool &pool)
+{
+	std::unordered_map<std::size_t, std::vector<std::uint8_t>> resizedObjects;
+
+	for (auto objectID : dirtyObjectIDs)
+	{
+		auto cachedIndex = cachedObjectIndexByID.find(objectID);
+
+		if ((cachedObjectIndexByID.end() == cachedIndex) ||
+		    (pool.get_object_by_index(static_cast<std::uint32_t>(cachedIndex->second)) != cachedObjects.at(cachedIndex->second).object))
+		{
+			return false;
+		}
+
+		auto &cachedObject = cachedObjects.at(cachedIndex->second);
+		auto encodedObject = cachedObject.object->get_binary_object();
+
+		if (encodedObject.empty())
+		{
+			// The object can't be encoded as it is, let the pool report why
+			return false;
+		}
+		else if (encodedObject.size() == cachedObject.length)
+		{
+			std::copy(encodedObject.begin(), encodedObject.end(), cachedBinary.begin() + cachedObject.offset);
+		}
+		else
+		{
+			resizedObjects[cachedIndex->second] = std::move(encodedObject);
+		}
+	}
+	dirtyObjectIDs.clear();
+
+	if (!resizedObjects.empty())
+	{
+		// Something like a designator changed length, so the objects after it move
+		std::vector<std::uint8_t> newBinary;
+		std::size_t offset = 0;
+
+		newBinary.reserve(cachedBinary.size());
+
+		for (std::size_t i = 0; i < cachedObjects.size(); i++)
+		{
+			auto &cachedObject = cachedObjects.at(i);
+			auto resizedObject = resizedObjects.find(i);
+
+			if (resizedObjects.end() != resizedObject)
+			{
+				newBinary.insert(newBinary.end(), resizedObject->second.begin(), resizedObject->second.end());
+				cachedObject.length = resizedObject->second.size();
+			}
+			else
+			{
+				auto begin = cachedBinary.begin() + cachedObject.offset;
+				newBinary.insert(newBinary.end(), begin, begin + cachedObject.length);
+			}
+			cachedObject.offset = offset;
+			offset += cachedObject.length;
+		}
+		cachedBinary = std::move(newBinary);
+	}
+	return true;
+}
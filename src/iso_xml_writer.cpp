@@ -0,0 +1,299 @@
+//================================================================================================
+/// @file iso_xml_writer.cpp
+///
+/// @brief Implements a streaming ISOXML (TASKDATA.XML) writer
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso and the Open-Agriculture developers
+//================================================================================================
+#include "iso_xml_writer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+IsoXmlWriter::IsoXmlWriter(std::ostream &outputStream) :
+  output(outputStream)
+{
+}
+
+void IsoXmlWriter::begin_task_data(std::uint8_t versionMajor)
+{
+	output << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+	output << "<ISO11783_TaskData VersionMajor=\"" << static_cast<int>(versionMajor) << "\" VersionMinor=\"0\" DataTransferOrigin=\"1\">\n";
+}
+
+bool IsoXmlWriter::write_device(isobus::DeviceDescriptorObjectPool &pool)
+{
+	std::shared_ptr<isobus::task_controller_object::DeviceObject> device;
+
+	for (std::uint32_t i = 0; i < pool.size(); i++)
+	{
+		auto object = pool.get_object_by_index(i);
+
+		if ((nullptr != object) && (isobus::task_controller_object::ObjectTypes::Device == object->get_object_type()))
+		{
+			device = std::static_pointer_cast<isobus::task_controller_object::DeviceObject>(object);
+			break;
+		}
+	}
+
+	if (nullptr == device)
+	{
+		return false;
+	}
+
+	numberOfDevices++;
+	output << "\t<DVC A=\"DVC-" << numberOfDevices << '"';
+	write_attribute('B', device->get_designator());
+	write_attribute('C', device->get_software_version());
+	write_hex_attribute('D', device->get_iso_name(), 16);
+	write_attribute('E', device->get_serial_number());
+
+	// The structure label is always 7 bytes, padded with spaces like in the binary pool
+	std::array<std::uint8_t, 7> structureLabel;
+	structureLabel.fill(' ');
+	std::string structureLabelText = device->get_structure_label();
+	std::memcpy(structureLabel.data(), structureLabelText.data(), std::min(structureLabelText.size(), structureLabel.size()));
+	write_hex_attribute('F', structureLabel.data(), structureLabel.size());
+
+	auto localizationLabel = device->get_localization_label();
+	write_hex_attribute('G', localizationLabel.data(), localizationLabel.size());
+	output << ">\n";
+
+	// The schema wants all DETs first, then the DPDs, DPTs and DVPs, so the pool is walked once per type
+	// instead of sorting a copy of it.
+	for (std::uint32_t i = 0; i < pool.size(); i++)
+	{
+		auto object = pool.get_object_by_index(i);
+
+		if ((nullptr != object) && (isobus::task_controller_object::ObjectTypes::DeviceElement == object->get_object_type()))
+		{
+			write_device_element(*std::static_pointer_cast<isobus::task_controller_object::DeviceElementObject>(object));
+		}
+	}
+	for (std::uint32_t i = 0; i < pool.size(); i++)
+	{
+		auto object = pool.get_object_by_index(i);
+
+		if ((nullptr != object) && (isobus::task_controller_object::ObjectTypes::DeviceProcessData == object->get_object_type()))
+		{
+			write_process_data(*std::static_pointer_cast<isobus::task_controller_object::DeviceProcessDataObject>(object));
+		}
+	}
+	for (std::uint32_t i = 0; i < pool.size(); i++)
+	{
+		auto object = pool.get_object_by_index(i);
+
+		if ((nullptr != object) && (isobus::task_controller_object::ObjectTypes::DeviceProperty == object->get_object_type()))
+		{
+			write_property(*std::static_pointer_cast<isobus::task_controller_object::DevicePropertyObject>(object));
+		}
+	}
+	for (std::uint32_t i = 0; i < pool.size(); i++)
+	{
+		auto object = pool.get_object_by_index(i);
+
+		if ((nullptr != object) && (isobus::task_controller_object::ObjectTypes::DeviceValuePresentation == object->get_object_type()))
+		{
+			write_presentation(*std::static_pointer_cast<isobus::task_controller_object::DeviceValuePresentationObject>(object));
+		}
+	}
+
+	output << "\t</DVC>\n";
+	return static_cast<bool>(output);
+}
+
+bool IsoXmlWriter::end_task_data()
+{
+	output << "</ISO11783_TaskData>\n";
+	output.flush();
+	return static_cast<bool>(output);
+}
+
+bool IsoXmlWriter::write_task_data(isobus::DeviceDescriptorObjectPool &pool, std::ostream &outputStream)
+{
+	IsoXmlWriter writer(outputStream);
+	writer.begin_task_data(pool.get_task_controller_compatibility_level());
+	bool retVal = writer.write_device(pool);
+	return writer.end_task_data() && retVal;
+}
+
+std::string IsoXmlWriter::escape(const std::string &text)
+{
+	std::string retVal;
+	retVal.reserve(text.size());
+
+	for (char character : text)
+	{
+		switch (character)
+		{
+			case '&':
+				retVal += "&amp;";
+				break;
+			case '<':
+				retVal += "&lt;";
+				break;
+			case '>':
+				retVal += "&gt;";
+				break;
+			case '"':
+				retVal += "&quot;";
+				break;
+			case '\'':
+				retVal += "&apos;";
+				break;
+			case '\t':
+				retVal += "&#9;";
+				break;
+			case '\n':
+				retVal += "&#10;";
+				break;
+			case '\r':
+				retVal += "&#13;";
+				break;
+			default:
+			{
+				// Other control characters are not allowed in XML 1.0 at all, not even escaped
+				if (static_cast<unsigned char>(character) >= 0x20)
+				{
+					retVal += character;
+				}
+			}
+			break;
+		}
+	}
+	return retVal;
+}
+
+void IsoXmlWriter::write_device_element(isobus::task_controller_object::DeviceElementObject &element)
+{
+	numberOfDeviceElements++;
+	output << "\t\t<DET A=\"DET-" << numberOfDeviceElements << '"';
+	write_attribute('B', static_cast<std::int64_t>(element.get_object_id()));
+	write_attribute('C', static_cast<std::int64_t>(element.get_type()));
+	write_attribute('D', element.get_designator());
+	write_attribute('E', static_cast<std::int64_t>(element.get_element_number()));
+	write_attribute('F', static_cast<std::int64_t>(element.get_parent_object()));
+
+	if (0 == element.get_number_child_objects())
+	{
+		output << "/>\n";
+	}
+	else
+	{
+		output << ">\n";
+
+		for (std::uint16_t i = 0; i < element.get_number_child_objects(); i++)
+		{
+			output << "\t\t\t<DOR A=\"" << element.get_child_object_id(i) << "\"/>\n";
+		}
+		output << "\t\t</DET>\n";
+	}
+}
+
+void IsoXmlWriter::write_process_data(const isobus::task_controller_object::DeviceProcessDataObject &processData)
+{
+	output << "\t\t<DPD";
+	write_attribute('A', static_cast<std::int64_t>(processData.get_object_id()));
+	write_hex_attribute('B', processData.get_ddi(), 4);
+	write_attribute('C', static_cast<std::int64_t>(processData.get_properties_bitfield()));
+	write_attribute('D', static_cast<std::int64_t>(processData.get_trigger_methods_bitfield()));
+
+	if (!processData.get_designator().empty())
+	{
+		write_attribute('E', processData.get_designator());
+	}
+	if (isobus::task_controller_object::Object::NULL_OBJECT_ID != processData.get_device_value_presentation_object_id())
+	{
+		write_attribute('F', static_cast<std::int64_t>(processData.get_device_value_presentation_object_id()));
+	}
+	output << "/>\n";
+}
+
+void IsoXmlWriter::write_property(const isobus::task_controller_object::DevicePropertyObject &property)
+{
+	output << "\t\t<DPT";
+	write_attribute('A', static_cast<std::int64_t>(property.get_object_id()));
+	write_hex_attribute('B', property.get_ddi(), 4);
+	write_attribute('C', static_cast<std::int64_t>(property.get_value()));
+
+	if (!property.get_designator().empty())
+	{
+		write_attribute('D', property.get_designator());
+	}
+	if (isobus::task_controller_object::Object::NULL_OBJECT_ID != property.get_device_value_presentation_object_id())
+	{
+		write_attribute('E', static_cast<std::int64_t>(property.get_device_value_presentation_object_id()));
+	}
+	output << "/>\n";
+}
+
+void IsoXmlWriter::write_presentation(const isobus::task_controller_object::DeviceValuePresentationObject &presentation)
+{
+	output << "\t\t<DVP";
+	write_attribute('A', static_cast<std::int64_t>(presentation.get_object_id()));
+	write_attribute('B', static_cast<std::int64_t>(presentation.get_offset()));
+	write_decimal_attribute('C', presentation.get_scale());
+	write_attribute('D', static_cast<std::int64_t>(presentation.get_number_of_decimals()));
+
+	if (!presentation.get_designator().empty())
+	{
+		write_attribute('E', presentation.get_designator());
+	}
+	output << "/>\n";
+}
+
+void IsoXmlWriter::write_attribute(char name, const std::string &value)
+{
+	output << ' ' << name << "=\"" << escape(value) << '"';
+}
+
+void IsoXmlWriter::write_attribute(char name, std::int64_t value)
+{
+	output << ' ' << name << "=\"" << value << '"';
+}
+
+void IsoXmlWriter::write_hex_attribute(char name, std::uint64_t value, int numberOfDigits)
+{
+	char text[17];
+	std::snprintf(text, sizeof(text), "%0*llX", numberOfDigits, static_cast<unsigned long long>(value));
+	output << ' ' << name << "=\"" << text << '"';
+}
+
+void IsoXmlWriter::write_hex_attribute(char name, const std::uint8_t *data, std::size_t length)
+{
+	static constexpr char HEX_DIGITS[] = "0123456789ABCDEF";
+
+	output << ' ' << name << "=\"";
+	for (std::size_t i = 0; i < length; i++)
+	{
+		output << HEX_DIGITS[data[i] >> 4] << HEX_DIGITS[data[i] & 0x0F];
+	}
+	output << '"';
+}
+
+void IsoXmlWriter::write_decimal_attribute(char name, float value)
+{
+	// xs:decimal has no exponent notation, so write a fixed point number and drop the trailing zeros
+	char text[64] = "0";
+
+	if (std::isfinite(value))
+	{
+		std::snprintf(text, sizeof(text), "%.10f", static_cast<double>(value));
+
+		char *end = text + std::strlen(text);
+		while ((end > text) && ('0' == *(end - 1)))
+		{
+			end--;
+		}
+		if ((end > text) && ('.' == *(end - 1)))
+		{
+			end--;
+		}
+		*end = '\0';
+	}
+	output << ' ' << name << "=\"" << text << '"';
+}
@@ -0,0 +1,194 @@
+//================================================================================================
+/// @file mapped_file.cpp
+///
+/// @brief Implements a read-only memory mapping of a file
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso and the Open-Agriculture developers
+//================================================================================================
+#include "mapped_file.hpp"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const std::string &path)
+{
+	open(path);
+}
+
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+{
+	move_from(other);
+}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept
+{
+	if (this != &other)
+	{
+		close();
+		move_from(other);
+	}
+	return *this;
+}
+
+#ifdef _WIN32
+bool MappedFile::open(const std::string &path)
+{
+	close();
+
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+	if (INVALID_HANDLE_VALUE == file)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER fileSize;
+	if ((0 == GetFileSizeEx(file, &fileSize)) || (0 == fileSize.QuadPart))
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+	if (nullptr == mapping)
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+
+	if (nullptr == view)
+	{
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+
+	fileHandle = file;
+	mappingHandle = mapping;
+	data = static_cast<const std::uint8_t *>(view);
+	size = static_cast<std::size_t>(fileSize.QuadPart);
+	return true;
+}
+
+void MappedFile::close()
+{
+	if (nullptr != data)
+	{
+		UnmapViewOfFile(data);
+	}
+	if (nullptr != mappingHandle)
+	{
+		CloseHandle(mappingHandle);
+	}
+	if (nullptr != fileHandle)
+	{
+		CloseHandle(fileHandle);
+	}
+	data = nullptr;
+	size = 0;
+	mappingHandle = nullptr;
+	fileHandle = nullptr;
+}
+
+void MappedFile::move_from(MappedFile &other)
+{
+	data = other.data;
+	size = other.size;
+	fileHandle = other.fileHandle;
+	mappingHandle = other.mappingHandle;
+	other.data = nullptr;
+	other.size = 0;
+	other.fileHandle = nullptr;
+	other.mappingHandle = nullptr;
+}
+#else
+bool MappedFile::open(const std::string &path)
+{
+	close();
+
+	int fileDescriptor = ::open(path.c_str(), O_RDONLY);
+
+	if (fileDescriptor < 0)
+	{
+		return false;
+	}
+
+	struct stat fileStatus;
+	if ((0 != fstat(fileDescriptor, &fileStatus)) || (!S_ISREG(fileStatus.st_mode)) || (0 == fileStatus.st_size))
+	{
+		::close(fileDescriptor);
+		return false;
+	}
+
+	void *view = mmap(nullptr, static_cast<std::size_t>(fileStatus.st_size), PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+
+	// The mapping keeps its own reference to the file, so the descriptor isn't needed any more
+	::close(fileDescriptor);
+
+	if (MAP_FAILED == view)
+	{
+		return false;
+	}
+
+	// The parser reads the pool front to back exactly once
+	madvise(view, static_cast<std::size_t>(fileStatus.st_size), MADV_SEQUENTIAL);
+
+	data = static_cast<const std::uint8_t *>(view);
+	size = static_cast<std::size_t>(fileStatus.st_size);
+	return true;
+}
+
+void MappedFile::close()
+{
+	if (nullptr != data)
+	{
+		munmap(const_cast<std::uint8_t *>(data), size);
+	}
+	data = nullptr;
+	size = 0;
+}
+
+void MappedFile::move_from(MappedFile &other)
+{
+	data = other.data;
+	size = other.size;
+	other.data = nullptr;
+	other.size = 0;
+}
+#endif
+
+bool MappedFile::is_open() const
+{
+	return nullptr != data;
+}
+
+const std::uint8_t *MappedFile::get_data() const
+{
+	return data;
+}
+
+std::size_t MappedFile::get_size() const
+{
+	return size;
+}
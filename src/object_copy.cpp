@@ -0,0 +1,86 @@
+//================================================================================================
+/// @file object_copy.cpp
+///
+/// @brief Implements copying DDOP objects from one object pool into another
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso and the Open-Agriculture developers
+//================================================================================================
+#include "object_copy.hpp"
+
+bool add_object_copy(isobus::DeviceDescriptorObjectPool &pool, const std::shared_ptr<isobus::task_controller_object::Object> &object)
+{
+	bool added = false;
+
+	switch (object->get_object_type())
+	{
+		case isobus::task_controller_object::ObjectTypes::Device:
+		{
+			auto device = std::static_pointer_cast<isobus::task_controller_object::DeviceObject>(object);
+			added = pool.add_device(device->get_designator(),
+			                        device->get_software_version(),
+			                        device->get_serial_number(),
+			                        device->get_structure_label(),
+			                        device->get_localization_label(),
+			                        device->get_extended_structure_label(),
+			                        device->get_iso_name());
+		}
+		break;
+
+		case isobus::task_controller_object::ObjectTypes::DeviceElement:
+		{
+			auto element = std::static_pointer_cast<isobus::task_controller_object::DeviceElementObject>(object);
+			added = pool.add_device_element(element->get_designator(),
+			                                element->get_element_number(),
+			                                element->get_parent_object(),
+			                                element->get_type(),
+			                                element->get_object_id());
+
+			if (added)
+			{
+				auto copiedElement = std::static_pointer_cast<isobus::task_controller_object::DeviceElementObject>(pool.get_object_by_index(pool.size() - 1));
+
+				for (std::uint16_t j = 0; j < element->get_number_child_objects(); j++)
+				{
+					copiedElement->add_reference_to_child_object(element->get_child_object_id(j));
+				}
+			}
+		}
+		break;
+
+		case isobus::task_controller_object::ObjectTypes::DeviceProcessData:
+		{
+			auto processData = std::static_pointer_cast<isobus::task_controller_object::DeviceProcessDataObject>(object);
+			added = pool.add_device_process_data(processData->get_designator(),
+			                                     processData->get_ddi(),
+			                                     processData->get_device_value_presentation_object_id(),
+			                                     processData->get_properties_bitfield(),
+			                                     processData->get_trigger_methods_bitfield(),
+			                                     processData->get_object_id());
+		}
+		break;
+
+		case isobus::task_controller_object::ObjectTypes::DeviceProperty:
+		{
+			auto property = std::static_pointer_cast<isobus::task_controller_object::DevicePropertyObject>(object);
+			added = pool.add_device_property(property->get_designator(),
+			                                 property->get_value(),
+			                                 property->get_ddi(),
+			                                 property->get_device_value_presentation_object_id(),
+			                                 property->get_object_id());
+		}
+		break;
+
+		case isobus::task_controller_object::ObjectTypes::DeviceValuePresentation:
+		{
+			auto presentation = std::static_pointer_cast<isobus::task_controller_object::DeviceValuePresentationObject>(object);
+			added = pool.add_device_value_presentation(presentation->get_designator(),
+			                                           presentation->get_offset(),
+			                                           presentation->get_scale(),
+			                                           presentation->get_number_of_decimals(),
+			                                           presentation->get_object_id());
+		}
+		break;
+	}
+	return added;
+}
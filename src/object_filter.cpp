@@ -0,0 +1,432 @@
+//================================================================================================
+/// @file object_filter.cpp
+///
+/// @brief Implements the search filter of the object tree
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso and the Open-Agriculture developers
+//================================================================================================
+#include "object_filter.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <limits>
+
+namespace
+{
+	constexpr std::size_t NUMBER_OF_IDS = static_cast<std::size_t>(std::numeric_limits<std::uint16_t>::max()) + 1;
+
+	std::uint8_t get_type_bit(isobus::task_controller_object::ObjectTypes type)
+	{
+		return static_cast<std::uint8_t>(1 << static_cast<std::uint8_t>(type));
+	}
+}
+
+bool ObjectFilter::parse(const std::string &text)
+{
+	std::vector<std::string> termTexts;
+	split_terms(text, termTexts);
+
+	terms.clear();
+	error.clear();
+	parseFailed = false;
+
+	for (const auto &termText : termTexts)
+	{
+		Term term;
+		std::string lowerText = termText;
+		std::transform(lowerText.begin(), lowerText.end(), lowerText.begin(), [](unsigned char character) { return static_cast<char>(std::tolower(character)); });
+
+		const auto colon = lowerText.find(':');
+		const std::string prefix = (std::string::npos == colon) ? std::string() : lowerText.substr(0, colon);
+		const std::string value = (std::string::npos == colon) ? std::string() : lowerText.substr(colon + 1);
+
+		if ("type" == prefix)
+		{
+			term.type = TermType::Type;
+			if (!parse_types(value, term.typeMask))
+			{
+				error = "Unknown type in \"" + termText + "\". Use DVC, DET, DPD, DPT or DVP.";
+			}
+		}
+		else if ("ddi" == prefix)
+		{
+			term.type = TermType::DDI;
+			if (!parse_range(value, term.low, term.high))
+			{
+				// Anything that isn't a number is looked up by name in the data dictionary
+				term.type = TermType::DDIName;
+				term.text = value;
+
+				if (value.empty())
+				{
+					error = "\"" + termText + "\" needs a DDI number, range or name.";
+				}
+			}
+		}
+		else if ("id" == prefix)
+		{
+			term.type = TermType::ObjectID;
+			if (!parse_range(value, term.low, term.high))
+			{
+				error = "\"" + termText + "\" needs an object ID or a range like id:100-200.";
+			}
+		}
+		else if ("under" == prefix)
+		{
+			term.type = TermType::Under;
+			if (!parse_number(value, term.low))
+			{
+				error = "\"" + termText + "\" needs the object ID of an element.";
+			}
+		}
+		else
+		{
+			term.type = TermType::Designator;
+			term.text = lowerText;
+		}
+
+		if (!error.empty())
+		{
+			terms.clear();
+			parseFailed = true;
+			break;
+		}
+		terms.push_back(std::move(term));
+	}
+	return !parseFailed;
+}
+
+bool ObjectFilter::is_empty() const
+{
+	return terms.empty() && !parseFailed;
+}
+
+const std::string &ObjectFilter::get_error() const
+{
+	return error;
+}
+
+void ObjectFilter::on_pool_edited()
+{
+	isSubtreeValid = false;
+}
+
+void ObjectFilter::apply(const ObjectPoolSnapshot &snapshot, const ObjectTreeIndex &treeIndex, DdiSearchIndex &ddiIndex, std::vector<std::uint32_t> &rows)
+{
+	rows.clear();
+
+	if (parseFailed)
+	{
+		return;
+	}
+
+	// Start from the cheapest selective scan there is, so the other terms only see its matches
+	auto seed = std::find_if(terms.begin(), terms.end(), [](const Term &term) {
+		return ((TermType::Type == term.type) && (0 == (term.typeMask & (term.typeMask - 1)))) ||
+		  ((TermType::DDI == term.type) && (term.low == term.high));
+	});
+
+	if (terms.end() == seed)
+	{
+		rows.resize(snapshot.size());
+		for (std::uint32_t row = 0; row < rows.size(); row++)
+		{
+			rows[row] = row;
+		}
+	}
+	else if (TermType::Type == seed->type)
+	{
+		for (std::uint8_t type = 0; type < 8; type++)
+		{
+			if (seed->typeMask == (1 << type))
+			{
+				snapshot.select_type(static_cast<isobus::task_controller_object::ObjectTypes>(type), rows);
+			}
+		}
+	}
+	else
+	{
+		snapshot.select_ddi(seed->low, rows);
+	}
+
+	for (auto term = terms.begin(); term != terms.end(); term++)
+	{
+		if (term == seed)
+		{
+			continue;
+		}
+
+		if (TermType::DDIName == term->type)
+		{
+			ddiIndex.build();
+			markedDDIs.assign(NUMBER_OF_IDS, false);
+			ddiIndex.search(term->text, ddiIndex.size(), ddiMatches);
+			for (const auto &match : ddiMatches)
+			{
+				markedDDIs[match.entry->ddi] = true;
+			}
+		}
+		else if ((TermType::Under == term->type) && ((!isSubtreeValid) || (subtreeRootID != term->low)))
+		{
+			subtreeIDs.assign(NUMBER_OF_IDS, false);
+			mark_subtree(term->low, snapshot, treeIndex);
+			subtreeRootID = term->low;
+			isSubtreeValid = true;
+		}
+
+		filter_rows(*term, snapshot, rows);
+	}
+}
+
+void ObjectFilter::split_terms(const std::string &text, std::vector<std::string> &terms)
+{
+	std::string term;
+	bool isQuoted = false;
+
+	for (char character : text)
+	{
+		if ('"' == character)
+		{
+			isQuoted = !isQuoted;
+		}
+		else if ((!isQuoted) && (0 != std::isspace(static_cast<unsigned char>(character))))
+		{
+			if (!term.empty())
+			{
+				terms.push_back(term);
+				term.clear();
+			}
+		}
+		else
+		{
+			term += character;
+		}
+	}
+
+	if (!term.empty())
+	{
+		terms.push_back(term);
+	}
+}
+
+bool ObjectFilter::parse_number(const std::string &text, std::uint16_t &value)
+{
+	const bool isHex = (text.size() > 2) && ('0' == text[0]) && ('x' == text[1]);
+	const std::size_t start = isHex ? 2 : 0;
+	std::uint32_t parsedValue = 0;
+
+	if (text.size() <= start)
+	{
+		return false;
+	}
+
+	for (std::size_t i = start; i < text.size(); i++)
+	{
+		auto digit = static_cast<unsigned char>(text[i]);
+
+		if (isHex && (0 != std::isxdigit(digit)))
+		{
+			parsedValue = (parsedValue * 16) + static_cast<std::uint32_t>(std::isdigit(digit) ? (digit - '0') : (digit - 'a' + 10));
+		}
+		else if ((!isHex) && (0 != std::isdigit(digit)))
+		{
+			parsedValue = (parsedValue * 10) + (digit - '0');
+		}
+		else
+		{
+			return false;
+		}
+
+		if (parsedValue > std::numeric_limits<std::uint16_t>::max())
+		{
+			return false;
+		}
+	}
+	value = static_cast<std::uint16_t>(parsedValue);
+	return true;
+}
+
+bool ObjectFilter::parse_range(const std::string &text, std::uint16_t &low, std::uint16_t &high)
+{
+	const auto dash = text.find('-');
+
+	if (std::string::npos == dash)
+	{
+		bool retVal = parse_number(text, low);
+		high = low;
+		return retVal;
+	}
+
+	if (parse_number(text.substr(0, dash), low) && parse_number(text.substr(dash + 1), high))
+	{
+		if (low > high)
+		{
+			std::swap(low, high);
+		}
+		return true;
+	}
+	return false;
+}
+
+bool ObjectFilter::parse_types(const std::string &text, std::uint8_t &typeMask)
+{
+	std::size_t start = 0;
+	typeMask = 0;
+
+	while (start <= text.size())
+	{
+		auto comma = text.find(',', start);
+		const std::string name = text.substr(start, (std::string::npos == comma) ? std::string::npos : comma - start);
+
+		if ("dvc" == name)
+		{
+			typeMask |= get_type_bit(isobus::task_controller_object::ObjectTypes::Device);
+		}
+		else if ("det" == name)
+		{
+			typeMask |= get_type_bit(isobus::task_controller_object::ObjectTypes::DeviceElement);
+		}
+		else if ("dpd" == name)
+		{
+			typeMask |= get_type_bit(isobus::task_controller_object::ObjectTypes::DeviceProcessData);
+		}
+		else if ("dpt" == name)
+		{
+			typeMask |= get_type_bit(isobus::task_controller_object::ObjectTypes::DeviceProperty);
+		}
+		else if ("dvp" == name)
+		{
+			typeMask |= get_type_bit(isobus::task_controller_object::ObjectTypes::DeviceValuePresentation);
+		}
+		else
+		{
+			return false;
+		}
+
+		if (std::string::npos == comma)
+		{
+			break;
+		}
+		start = comma + 1;
+	}
+	return 0 != typeMask;
+}
+
+void ObjectFilter::mark_subtree(std::uint16_t objectID, const ObjectPoolSnapshot &snapshot, const ObjectTreeIndex &treeIndex)
+{
+	// Follows the same links the tree is drawn from: child elements by their parent ID, other
+	// children from the element's child list, and the presentation of process data and properties
+	std::vector<std::uint16_t> pendingIDs;
+	auto markObject = [this, &pendingIDs](std::uint16_t markedID) {
+		if (!subtreeIDs[markedID])
+		{
+			subtreeIDs[markedID] = true;
+			pendingIDs.push_back(markedID);
+		}
+	};
+
+	markObject(objectID);
+
+	while (!pendingIDs.empty())
+	{
+		const std::uint16_t currentID = pendingIDs.back();
+		const std::uint32_t row = snapshot.find_row(currentID);
+		pendingIDs.pop_back();
+
+		if (ObjectPoolSnapshot::NO_ROW == row)
+		{
+			continue;
+		}
+
+		switch (snapshot.get_type(row))
+		{
+			case isobus::task_controller_object::ObjectTypes::Device:
+			case isobus::task_controller_object::ObjectTypes::DeviceElement:
+			{
+				for (const auto &childElement : treeIndex.get_child_elements(currentID))
+				{
+					markObject(childElement->get_object_id());
+				}
+
+				if (auto element = treeIndex.get_object_view(currentID).as_element())
+				{
+					for (std::uint16_t i = 0; i < element->get_number_child_objects(); i++)
+					{
+						markObject(element->get_child_object_id(i));
+					}
+				}
+			}
+			break;
+
+			case isobus::task_controller_object::ObjectTypes::DeviceProcessData:
+			case isobus::task_controller_object::ObjectTypes::DeviceProperty:
+			{
+				if (ObjectPoolSnapshot::NULL_OBJECT_ID != snapshot.get_presentation_id(row))
+				{
+					markObject(snapshot.get_presentation_id(row));
+				}
+			}
+			break;
+
+			default:
+				break;
+		}
+	}
+}
+
+void ObjectFilter::filter_rows(const Term &term, const ObjectPoolSnapshot &snapshot, std::vector<std::uint32_t> &rows) const
+{
+	// One pass per term with the test chosen up front, rather than a switch for every row
+	auto removeRowsWhere = [&rows](auto &&isRejected) {
+		rows.erase(std::remove_if(rows.begin(), rows.end(), isRejected), rows.end());
+	};
+
+	switch (term.type)
+	{
+		case TermType::Type:
+		{
+			removeRowsWhere([&term, &snapshot](std::uint32_t row) { return 0 == (term.typeMask & get_type_bit(snapshot.get_type(row))); });
+		}
+		break;
+
+		case TermType::DDI:
+		{
+			removeRowsWhere([&term, &snapshot](std::uint32_t row) {
+				const std::uint16_t ddi = snapshot.get_ddi(row);
+				return (!snapshot.has_ddi(row)) || (ddi < term.low) || (ddi > term.high);
+			});
+		}
+		break;
+
+		case TermType::DDIName:
+		{
+			removeRowsWhere([this, &snapshot](std::uint32_t row) { return (!snapshot.has_ddi(row)) || (!markedDDIs[snapshot.get_ddi(row)]); });
+		}
+		break;
+
+		case TermType::ObjectID:
+		{
+			removeRowsWhere([&term, &snapshot](std::uint32_t row) {
+				const std::uint16_t objectID = snapshot.get_object_id(row);
+				return (objectID < term.low) || (objectID > term.high);
+			});
+		}
+		break;
+
+		case TermType::Under:
+		{
+			removeRowsWhere([this, &term, &snapshot](std::uint32_t row) {
+				const std::uint16_t objectID = snapshot.get_object_id(row);
+				return (objectID == term.low) || (!subtreeIDs[objectID]);
+			});
+		}
+		break;
+
+		case TermType::Designator:
+		{
+			removeRowsWhere([&term, &snapshot](std::uint32_t row) { return std::string_view::npos == snapshot.get_folded_designator(row).find(term.text); });
+		}
+		break;
+	}
+}
@@ -0,0 +1,93 @@
+//================================================================================================
+/// @file object_id_allocator.cpp
+///
+/// @brief Implements a bitset of used object IDs
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso and the Open-Agriculture developers
+//================================================================================================
+#include "object_id_allocator.hpp"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+ObjectIDAllocator::ObjectIDAllocator()
+{
+	clear();
+}
+
+void ObjectIDAllocator::rebuild(isobus::DeviceDescriptorObjectPool &pool)
+{
+	clear();
+
+	for (std::uint32_t i = 0; i < pool.size(); i++)
+	{
+		auto object = pool.get_object_by_index(i);
+
+		if (nullptr != object)
+		{
+			mark_used(object->get_object_id());
+		}
+	}
+}
+
+void ObjectIDAllocator::clear()
+{
+	usedIDs.fill(0);
+	fullWords.fill(0);
+	mark_used(isobus::task_controller_object::Object::NULL_OBJECT_ID);
+}
+
+void ObjectIDAllocator::mark_used(std::uint16_t objectID)
+{
+	std::size_t word = objectID / BITS_PER_WORD;
+	usedIDs[word] |= (1ULL << (objectID % BITS_PER_WORD));
+
+	if (FULL_WORD == usedIDs[word])
+	{
+		fullWords[word / BITS_PER_WORD] |= (1ULL << (word % BITS_PER_WORD));
+	}
+}
+
+void ObjectIDAllocator::mark_unused(std::uint16_t objectID)
+{
+	if (isobus::task_controller_object::Object::NULL_OBJECT_ID != objectID)
+	{
+		std::size_t word = objectID / BITS_PER_WORD;
+		usedIDs[word] &= ~(1ULL << (objectID % BITS_PER_WORD));
+		fullWords[word / BITS_PER_WORD] &= ~(1ULL << (word % BITS_PER_WORD));
+	}
+}
+
+bool ObjectIDAllocator::is_used(std::uint16_t objectID) const
+{
+	return 0 != (usedIDs[objectID / BITS_PER_WORD] & (1ULL << (objectID % BITS_PER_WORD)));
+}
+
+std::uint16_t ObjectIDAllocator::get_first_unused_id() const
+{
+	std::uint16_t retVal = isobus::task_controller_object::Object::NULL_OBJECT_ID;
+
+	for (std::size_t i = 0; i < NUMBER_OF_SUMMARY_WORDS; i++)
+	{
+		if (FULL_WORD != fullWords[i])
+		{
+			std::size_t word = (i * BITS_PER_WORD) + count_trailing_zeros(~fullWords[i]);
+			retVal = static_cast<std::uint16_t>((word * BITS_PER_WORD) + count_trailing_zeros(~usedIDs[word]));
+			break;
+		}
+	}
+	return retVal;
+}
+
+std::uint32_t ObjectIDAllocator::count_trailing_zeros(std::uint64_t value)
+{
+#ifdef _MSC_VER
+	unsigned long index = 0;
+	_BitScanForward64(&index, value);
+	return static_cast<std::uint32_t>(index);
+#else
+	return static_cast<std::uint32_t>(__builtin_ctzll(value));
+#endif
+}
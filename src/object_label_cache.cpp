@@ -0,0 +1,40 @@
+//================================================================================================
+/// @file object_label_cache.cpp
+///
+/// @brief Implements a cache of the display labels shown for each object in the GUI
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso and the Open-Agriculture developers
+//================================================================================================
+#include "object_label_cache.hpp"
+
+#include <utility>
+
+const std::string *ObjectLabelCache::get(std::uint16_t objectID, LabelType type) const
+{
+	const std::string *retVal = nullptr;
+	auto labelSet = labels.find(objectID);
+
+	if ((labels.end() != labelSet) && (!labelSet->second[static_cast<std::size_t>(type)].empty()))
+	{
+		retVal = &labelSet->second[static_cast<std::size_t>(type)];
+	}
+	return retVal;
+}
+
+const std::string &ObjectLabelCache::set(std::uint16_t objectID, LabelType type, std::string label)
+{
+	auto &storedLabel = labels[objectID][static_cast<std::size_t>(type)];
+	storedLabel = std::move(label);
+	return storedLabel;
+}
+
+void ObjectLabelCache::invalidate(std::uint16_t objectID)
+{
+	labels.erase(objectID);
+}
+
+void ObjectLabelCache::clear()
+{
+	labels.clear();
+}
@@ -0,0 +1,390 @@
+//================================================================================================
+/// @file object_pool_snapshot.cpp
+///
+/// @brief Implements a compact, column oriented copy of the object pool for fast searching
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso and the Open-Agriculture developers
+//================================================================================================
+#include "object_pool_snapshot.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define OBJECT_POOL_SNAPSHOT_USE_SSE2
+#endif
+
+namespace
+{
+	/// @brief Appends the index of every value equal to the one searched for
+	void select_equal(const std::uint8_t *values, std::size_t count, std::uint8_t value, std::vector<std::uint32_t> &rows)
+	{
+		std::size_t i = 0;
+
+#ifdef OBJECT_POOL_SNAPSHOT_USE_SSE2
+		const __m128i searchedValue = _mm_set1_epi8(static_cast<char>(value));
+
+		for (; i + 16 <= count; i += 16)
+		{
+			__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(values + i));
+			int matches = _mm_movemask_epi8(_mm_cmpeq_epi8(block, searchedValue));
+
+			for (std::size_t lane = 0; (0 != matches) && (lane < 16); lane++, matches >>= 1)
+			{
+				if (0 != (matches & 1))
+				{
+					rows.push_back(static_cast<std::uint32_t>(i + lane));
+				}
+			}
+		}
+#endif
+
+		for (; i < count; i++)
+		{
+			if (value == values[i])
+			{
+				rows.push_back(static_cast<std::uint32_t>(i));
+			}
+		}
+	}
+
+	/// @brief Appends the index of every value equal to the one searched for
+	void select_equal(const std::uint16_t *values, std::size_t count, std::uint16_t value, std::vector<std::uint32_t> &rows)
+	{
+		std::size_t i = 0;
+
+#ifdef OBJECT_POOL_SNAPSHOT_USE_SSE2
+		const __m128i searchedValue = _mm_set1_epi16(static_cast<short>(value));
+
+		for (; i + 8 <= count; i += 8)
+		{
+			__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(values + i));
+
+			// The mask has one bit per byte, so each 16 bit lane that matches sets two bits
+			int matches = _mm_movemask_epi8(_mm_cmpeq_epi16(block, searchedValue));
+
+			for (std::size_t lane = 0; (0 != matches) && (lane < 8); lane++, matches >>= 2)
+			{
+				if (0 != (matches & 1))
+				{
+					rows.push_back(static_cast<std::uint32_t>(i + lane));
+				}
+			}
+		}
+#endif
+
+		for (; i < count; i++)
+		{
+			if (value == values[i])
+			{
+				rows.push_back(static_cast<std::uint32_t>(i));
+			}
+		}
+	}
+}
+
+void ObjectPoolSnapshot::rebuild(isobus::DeviceDescriptorObjectPool &pool)
+{
+	clear();
+
+	objectIDs.reserve(pool.size());
+	types.reserve(pool.size());
+	parentIDs.reserve(pool.size());
+	ddis.reserve(pool.size());
+	presentationIDs.reserve(pool.size());
+	designatorOffsets.reserve(pool.size());
+	designatorLengths.reserve(pool.size());
+
+	for (std::uint32_t i = 0; i < pool.size(); i++)
+	{
+		auto object = pool.get_object_by_index(i);
+
+		if (nullptr != object)
+		{
+			on_object_added(*object);
+		}
+	}
+}
+
+void ObjectPoolSnapshot::clear()
+{
+	objectIDs.clear();
+	types.clear();
+	parentIDs.clear();
+	ddis.clear();
+	presentationIDs.clear();
+	designatorOffsets.clear();
+	designatorLengths.clear();
+	designatorArena.clear();
+	foldedDesignatorArena.clear();
+	unusedArenaBytes = 0;
+	rowsByObjectID.assign(static_cast<std::size_t>(std::numeric_limits<std::uint16_t>::max()) + 1, NO_ROW);
+}
+
+void ObjectPoolSnapshot::on_object_added(const isobus::task_controller_object::Object &object)
+{
+	if (rowsByObjectID.empty())
+	{
+		clear();
+	}
+
+	const auto row = static_cast<std::uint32_t>(objectIDs.size());
+
+	objectIDs.push_back(object.get_object_id());
+	types.push_back(static_cast<std::uint8_t>(object.get_object_type()));
+	parentIDs.push_back(NULL_OBJECT_ID);
+	ddis.push_back(NO_DDI);
+	presentationIDs.push_back(NULL_OBJECT_ID);
+	designatorOffsets.push_back(0);
+	designatorLengths.push_back(0);
+	rowsByObjectID[object.get_object_id()] = row;
+	set_row(row, object);
+}
+
+void ObjectPoolSnapshot::on_object_removed(std::uint16_t objectID)
+{
+	const std::uint32_t row = find_row(objectID);
+
+	if (NO_ROW == row)
+	{
+		return;
+	}
+
+	// Erasing keeps the rows in pool order, which the pool itself also does
+	unusedArenaBytes += designatorLengths[row];
+	objectIDs.erase(objectIDs.begin() + row);
+	types.erase(types.begin() + row);
+	parentIDs.erase(parentIDs.begin() + row);
+	ddis.erase(ddis.begin() + row);
+	presentationIDs.erase(presentationIDs.begin() + row);
+	designatorOffsets.erase(designatorOffsets.begin() + row);
+	designatorLengths.erase(designatorLengths.begin() + row);
+
+	rowsByObjectID[objectID] = NO_ROW;
+	for (std::uint32_t i = row; i < objectIDs.size(); i++)
+	{
+		rowsByObjectID[objectIDs[i]] = i;
+	}
+	compact_designators();
+}
+
+void ObjectPoolSnapshot::on_object_id_changed(std::uint16_t oldID, std::uint16_t newID)
+{
+	const std::uint32_t row = find_row(oldID);
+
+	if (NO_ROW != row)
+	{
+		objectIDs[row] = newID;
+		rowsByObjectID[oldID] = NO_ROW;
+		rowsByObjectID[newID] = row;
+	}
+}
+
+void ObjectPoolSnapshot::on_object_changed(const isobus::task_controller_object::Object &object)
+{
+	const std::uint32_t row = find_row(object.get_object_id());
+
+	if (NO_ROW != row)
+	{
+		set_row(row, object);
+		compact_designators();
+	}
+}
+
+std::size_t ObjectPoolSnapshot::size() const
+{
+	return objectIDs.size();
+}
+
+std::uint32_t ObjectPoolSnapshot::find_row(std::uint16_t objectID) const
+{
+	return rowsByObjectID.empty() ? NO_ROW : rowsByObjectID[objectID];
+}
+
+std::uint16_t ObjectPoolSnapshot::get_object_id(std::uint32_t row) const
+{
+	return objectIDs[row];
+}
+
+isobus::task_controller_object::ObjectTypes ObjectPoolSnapshot::get_type(std::uint32_t row) const
+{
+	return static_cast<isobus::task_controller_object::ObjectTypes>(types[row]);
+}
+
+std::uint16_t ObjectPoolSnapshot::get_parent_id(std::uint32_t row) const
+{
+	return parentIDs[row];
+}
+
+bool ObjectPoolSnapshot::has_ddi(std::uint32_t row) const
+{
+	return (isobus::task_controller_object::ObjectTypes::DeviceProcessData == get_type(row)) ||
+	  (isobus::task_controller_object::ObjectTypes::DeviceProperty == get_type(row));
+}
+
+std::uint16_t ObjectPoolSnapshot::get_ddi(std::uint32_t row) const
+{
+	return ddis[row];
+}
+
+std::uint16_t ObjectPoolSnapshot::get_presentation_id(std::uint32_t row) const
+{
+	return presentationIDs[row];
+}
+
+std::string_view ObjectPoolSnapshot::get_designator(std::uint32_t row) const
+{
+	return std::string_view(designatorArena.data() + designatorOffsets[row], designatorLengths[row]);
+}
+
+std::string_view ObjectPoolSnapshot::get_folded_designator(std::uint32_t row) const
+{
+	return std::string_view(foldedDesignatorArena.data() + designatorOffsets[row], designatorLengths[row]);
+}
+
+void ObjectPoolSnapshot::select_type(isobus::task_controller_object::ObjectTypes type, std::vector<std::uint32_t> &rows) const
+{
+	select_equal(types.data(), types.size(), static_cast<std::uint8_t>(type), rows);
+}
+
+void ObjectPoolSnapshot::select_ddi(std::uint16_t ddi, std::vector<std::uint32_t> &rows) const
+{
+	const std::size_t firstMatch = rows.size();
+	select_equal(ddis.data(), ddis.size(), ddi, rows);
+
+	if (NO_DDI == ddi)
+	{
+		// NO_DDI is also a DDI a user can type in, so the rows of objects without a DDI are dropped again
+		rows.erase(std::remove_if(rows.begin() + firstMatch, rows.end(), [this](std::uint32_t row) { return !has_ddi(row); }), rows.end());
+	}
+}
+
+const char *ObjectPoolSnapshot::get_table_id(isobus::task_controller_object::ObjectTypes type)
+{
+	const char *retVal = "";
+
+	switch (type)
+	{
+		case isobus::task_controller_object::ObjectTypes::Device:
+		{
+			retVal = "DVC";
+		}
+		break;
+
+		case isobus::task_controller_object::ObjectTypes::DeviceElement:
+		{
+			retVal = "DET";
+		}
+		break;
+
+		case isobus::task_controller_object::ObjectTypes::DeviceProcessData:
+		{
+			retVal = "DPD";
+		}
+		break;
+
+		case isobus::task_controller_object::ObjectTypes::DeviceProperty:
+		{
+			retVal = "DPT";
+		}
+		break;
+
+		case isobus::task_controller_object::ObjectTypes::DeviceValuePresentation:
+		{
+			retVal = "DVP";
+		}
+		break;
+
+		default:
+			break;
+	}
+	return retVal;
+}
+
+void ObjectPoolSnapshot::set_row(std::uint32_t row, const isobus::task_controller_object::Object &object)
+{
+	switch (object.get_object_type())
+	{
+		case isobus::task_controller_object::ObjectTypes::DeviceElement:
+		{
+			parentIDs[row] = static_cast<const isobus::task_controller_object::DeviceElementObject &>(object).get_parent_object();
+		}
+		break;
+
+		case isobus::task_controller_object::ObjectTypes::DeviceProcessData:
+		{
+			const auto &processData = static_cast<const isobus::task_controller_object::DeviceProcessDataObject &>(object);
+			ddis[row] = processData.get_ddi();
+			presentationIDs[row] = processData.get_device_value_presentation_object_id();
+		}
+		break;
+
+		case isobus::task_controller_object::ObjectTypes::DeviceProperty:
+		{
+			const auto &property = static_cast<const isobus::task_controller_object::DevicePropertyObject &>(object);
+			ddis[row] = property.get_ddi();
+			presentationIDs[row] = property.get_device_value_presentation_object_id();
+		}
+		break;
+
+		default:
+			break;
+	}
+	set_designator(row, object.get_designator());
+}
+
+void ObjectPoolSnapshot::set_designator(std::uint32_t row, const std::string &designator)
+{
+	const auto length = static_cast<std::uint16_t>(std::min<std::size_t>(designator.size(), std::numeric_limits<std::uint16_t>::max()));
+
+	if (std::string_view(designator.data(), length) == get_designator(row))
+	{
+		return;
+	}
+
+	if (length <= designatorLengths[row])
+	{
+		// Fits where the old one was, which is the common case of deleting characters
+		unusedArenaBytes += designatorLengths[row] - length;
+	}
+	else
+	{
+		unusedArenaBytes += designatorLengths[row];
+		designatorOffsets[row] = static_cast<std::uint32_t>(designatorArena.size());
+		designatorArena.append(length, '\0');
+		foldedDesignatorArena.append(length, '\0');
+	}
+	designator.copy(&designatorArena[designatorOffsets[row]], length);
+	std::transform(designator.begin(), designator.begin() + length, foldedDesignatorArena.begin() + designatorOffsets[row], [](unsigned char character) {
+		return static_cast<char>(std::tolower(character));
+	});
+	designatorLengths[row] = length;
+}
+
+void ObjectPoolSnapshot::compact_designators()
+{
+	// Rebuilding the arena is linear, so it's only done once at least half of it is unused
+	if ((unusedArenaBytes < MINIMUM_COMPACTION_SIZE) || (unusedArenaBytes * 2 < designatorArena.size()))
+	{
+		return;
+	}
+
+	std::string compactedArena;
+	std::string compactedFoldedArena;
+	compactedArena.reserve(designatorArena.size() - unusedArenaBytes);
+	compactedFoldedArena.reserve(designatorArena.size() - unusedArenaBytes);
+
+	for (std::size_t row = 0; row < objectIDs.size(); row++)
+	{
+		const auto offset = static_cast<std::uint32_t>(compactedArena.size());
+		compactedArena.append(designatorArena, designatorOffsets[row], designatorLengths[row]);
+		compactedFoldedArena.append(foldedDesignatorArena, designatorOffsets[row], designatorLengths[row]);
+		designatorOffsets[row] = offset;
+	}
+	designatorArena = std::move(compactedArena);
+	foldedDesignatorArena = std::move(compactedFoldedArena);
+	unusedArenaBytes = 0;
+}
@@ -0,0 +1,184 @@
+//================================================================================================
+/// @file object_reference_index.cpp
+///
+/// @brief Implements an index from each object ID to the objects that refer to it
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso and the Open-Agriculture developers
+//================================================================================================
+#include "object_reference_index.hpp"
+
+#include <algorithm>
+
+const std::vector<ObjectReferenceIndex::Reference> ObjectReferenceIndex::EMPTY_REFERENCE_LIST;
+
+void ObjectReferenceIndex::rebuild(isobus::DeviceDescriptorObjectPool &pool)
+{
+	clear();
+	referencesByObjectID.reserve(pool.size());
+
+	for (std::uint32_t i = 0; i < pool.size(); i++)
+	{
+		on_object_added(pool.get_object_by_index(i));
+	}
+}
+
+void ObjectReferenceIndex::clear()
+{
+	referencesByObjectID.clear();
+}
+
+void ObjectReferenceIndex::on_object_added(const std::shared_ptr<isobus::task_controller_object::Object> &object)
+{
+	if (nullptr == object)
+	{
+		return;
+	}
+
+	switch (object->get_object_type())
+	{
+		case isobus::task_controller_object::ObjectTypes::DeviceElement:
+		{
+			auto element = std::static_pointer_cast<isobus::task_controller_object::DeviceElementObject>(object);
+
+			add_reference(element->get_parent_object(), object, ReferenceType::ParentObject);
+
+			for (std::uint16_t i = 0; i < element->get_number_child_objects(); i++)
+			{
+				add_reference(element->get_child_object_id(i), object, ReferenceType::ChildObject);
+			}
+		}
+		break;
+
+		case isobus::task_controller_object::ObjectTypes::DeviceProcessData:
+		{
+			auto processData = std::static_pointer_cast<isobus::task_controller_object::DeviceProcessDataObject>(object);
+			add_reference(processData->get_device_value_presentation_object_id(), object, ReferenceType::Presentation);
+		}
+		break;
+
+		case isobus::task_controller_object::ObjectTypes::DeviceProperty:
+		{
+			auto property = std::static_pointer_cast<isobus::task_controller_object::DevicePropertyObject>(object);
+			add_reference(property->get_device_value_presentation_object_id(), object, ReferenceType::Presentation);
+		}
+		break;
+
+		default:
+			break;
+	}
+}
+
+void ObjectReferenceIndex::on_object_removed(const std::shared_ptr<isobus::task_controller_object::Object> &object)
+{
+	if (nullptr == object)
+	{
+		return;
+	}
+
+	switch (object->get_object_type())
+	{
+		case isobus::task_controller_object::ObjectTypes::DeviceElement:
+		{
+			auto element = std::static_pointer_cast<isobus::task_controller_object::DeviceElementObject>(object);
+
+			remove_reference(element->get_parent_object(), object, ReferenceType::ParentObject);
+
+			for (std::uint16_t i = 0; i < element->get_number_child_objects(); i++)
+			{
+				remove_reference(element->get_child_object_id(i), object, ReferenceType::ChildObject);
+			}
+		}
+		break;
+
+		case isobus::task_controller_object::ObjectTypes::DeviceProcessData:
+		{
+			auto processData = std::static_pointer_cast<isobus::task_controller_object::DeviceProcessDataObject>(object);
+			remove_reference(processData->get_device_value_presentation_object_id(), object, ReferenceType::Presentation);
+		}
+		break;
+
+		case isobus::task_controller_object::ObjectTypes::DeviceProperty:
+		{
+			auto property = std::static_pointer_cast<isobus::task_controller_object::DevicePropertyObject>(object);
+			remove_reference(property->get_device_value_presentation_object_id(), object, ReferenceType::Presentation);
+		}
+		break;
+
+		default:
+			break;
+	}
+}
+
+void ObjectReferenceIndex::on_child_reference_added(const std::shared_ptr<isobus::task_controller_object::Object> &element, std::uint16_t childID)
+{
+	add_reference(childID, element, ReferenceType::ChildObject);
+}
+
+void ObjectReferenceIndex::on_child_reference_removed(const std::shared_ptr<isobus::task_controller_object::Object> &element, std::uint16_t childID)
+{
+	remove_reference(childID, element, ReferenceType::ChildObject);
+}
+
+void ObjectReferenceIndex::on_parent_changed(const std::shared_ptr<isobus::task_controller_object::Object> &element, std::uint16_t oldParentID, std::uint16_t newParentID)
+{
+	if (oldParentID != newParentID)
+	{
+		remove_reference(oldParentID, element, ReferenceType::ParentObject);
+		add_reference(newParentID, element, ReferenceType::ParentObject);
+	}
+}
+
+void ObjectReferenceIndex::on_presentation_changed(const std::shared_ptr<isobus::task_controller_object::Object> &object, std::uint16_t oldPresentationID, std::uint16_t newPresentationID)
+{
+	if (oldPresentationID != newPresentationID)
+	{
+		remove_reference(oldPresentationID, object, ReferenceType::Presentation);
+		add_reference(newPresentationID, object, ReferenceType::Presentation);
+	}
+}
+
+const std::vector<ObjectReferenceIndex::Reference> &ObjectReferenceIndex::get_references_to(std::uint16_t objectID) const
+{
+	auto references = referencesByObjectID.find(objectID);
+
+	if (referencesByObjectID.end() != references)
+	{
+		return references->second;
+	}
+	return EMPTY_REFERENCE_LIST;
+}
+
+void ObjectReferenceIndex::add_reference(std::uint16_t objectID, const std::shared_ptr<isobus::task_controller_object::Object> &referrer, ReferenceType type)
+{
+	// The NULL object ID means "no reference"
+	if (isobus::task_controller_object::Object::NULL_OBJECT_ID != objectID)
+	{
+		referencesByObjectID[objectID].push_back({ referrer, type });
+	}
+}
+
+void ObjectReferenceIndex::remove_reference(std::uint16_t objectID, const std::shared_ptr<isobus::task_controller_object::Object> &referrer, ReferenceType type)
+{
+	auto references = referencesByObjectID.find(objectID);
+
+	if (referencesByObjectID.end() != references)
+	{
+		auto &referenceList = references->second;
+
+		// An element may list the same child more than once, so only one matching reference is removed
+		auto reference = std::find_if(referenceList.begin(), referenceList.end(), [&referrer, type](const Reference &candidate) {
+			return (candidate.referrer == referrer) && (candidate.type == type);
+		});
+
+		if (referenceList.end() != reference)
+		{
+			referenceList.erase(reference);
+		}
+
+		if (referenceList.empty())
+		{
+			referencesByObjectID.erase(references);
+		}
+	}
+}
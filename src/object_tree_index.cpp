@@ -0,0 +1,165 @@
+//================================================================================================
+/// @file object_tree_index.cpp
+///
+/// @brief Implements an index of the parent/child relationships in a DDOP
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso and the Open-Agriculture developers
+//================================================================================================
+#include "object_tree_index.hpp"
+
+#include <algorithm>
+
+const ObjectTreeIndex::ElementList ObjectTreeIndex::EMPTY_ELEMENT_LIST;
+
+void ObjectTreeIndex::rebuild(isobus::DeviceDescriptorObjectPool &pool)
+{
+	clear();
+	objectsByID.reserve(pool.size());
+
+	for (std::uint32_t i = 0; i < pool.size(); i++)
+	{
+		on_object_added(pool.get_object_by_index(i));
+	}
+}
+
+void ObjectTreeIndex::clear()
+{
+	objectsByID.clear();
+	childElementsByParentID.clear();
+	device.reset();
+}
+
+void ObjectTreeIndex::on_object_added(std::shared_ptr<isobus::task_controller_object::Object> object)
+{
+	if (nullptr != object)
+	{
+		objectsByID[object->get_object_id()] = object;
+
+		switch (object->get_object_type())
+		{
+			case isobus::task_controller_object::ObjectTypes::Device:
+			{
+				device = std::static_pointer_cast<isobus::task_controller_object::DeviceObject>(object);
+			}
+			break;
+
+			case isobus::task_controller_object::ObjectTypes::DeviceElement:
+			{
+				auto element = std::static_pointer_cast<isobus::task_controller_object::DeviceElementObject>(object);
+				add_child_element(element->get_parent_object(), element);
+			}
+			break;
+
+			default:
+				break;
+		}
+	}
+}
+
+void ObjectTreeIndex::on_object_removed(std::uint16_t objectID)
+{
+	auto object = get_object(objectID);
+
+	if (nullptr != object)
+	{
+		if (isobus::task_controller_object::ObjectTypes::DeviceElement == object->get_object_type())
+		{
+			auto element = std::static_pointer_cast<isobus::task_controller_object::DeviceElementObject>(object);
+			remove_child_element(element->get_parent_object(), element);
+		}
+		else if (object == device)
+		{
+			device.reset();
+		}
+		objectsByID.erase(objectID);
+	}
+}
+
+void ObjectTreeIndex::on_parent_changed(std::uint16_t elementID, std::uint16_t oldParentID, std::uint16_t newParentID)
+{
+	auto object = get_object(elementID);
+
+	if ((oldParentID != newParentID) &&
+	    (nullptr != object) &&
+	    (isobus::task_controller_object::ObjectTypes::DeviceElement == object->get_object_type()))
+	{
+		auto element = std::static_pointer_cast<isobus::task_controller_object::DeviceElementObject>(object);
+		remove_child_element(oldParentID, element);
+		add_child_element(newParentID, element);
+	}
+}
+
+void ObjectTreeIndex::on_object_id_changed(std::uint16_t oldID, std::uint16_t newID)
+{
+	auto object = objectsByID.find(oldID);
+
+	if ((oldID != newID) && (objectsByID.end() != object))
+	{
+		// Children keep referring to the old ID as their parent, just like they do in the pool,
+		// so only the object itself needs to be re-keyed.
+		objectsByID[newID] = object->second;
+		objectsByID.erase(oldID);
+	}
+}
+
+std::shared_ptr<isobus::task_controller_object::Object> ObjectTreeIndex::get_object(std::uint16_t objectID) const
+{
+	std::shared_ptr<isobus::task_controller_object::Object> retVal;
+	auto object = objectsByID.find(objectID);
+
+	if (objectsByID.end() != object)
+	{
+		retVal = object->second;
+	}
+	return retVal;
+}
+
+ObjectView ObjectTreeIndex::get_object_view(std::uint16_t objectID) const
+{
+	ObjectView retVal;
+	auto object = objectsByID.find(objectID);
+
+	if (objectsByID.end() != object)
+	{
+		retVal = ObjectView(object->second);
+	}
+	return retVal;
+}
+
+const std::shared_ptr<isobus::task_controller_object::DeviceObject> &ObjectTreeIndex::get_device() const
+{
+	return device;
+}
+
+const ObjectTreeIndex::ElementList &ObjectTreeIndex::get_child_elements(std::uint16_t parentID) const
+{
+	auto children = childElementsByParentID.find(parentID);
+
+	if (childElementsByParentID.end() != children)
+	{
+		return children->second;
+	}
+	return EMPTY_ELEMENT_LIST;
+}
+
+void ObjectTreeIndex::add_child_element(std::uint16_t parentID, std::shared_ptr<isobus::task_controller_object::DeviceElementObject> element)
+{
+	childElementsByParentID[parentID].push_back(element);
+}
+
+void ObjectTreeIndex::remove_child_element(std::uint16_t parentID, const std::shared_ptr<isobus::task_controller_object::DeviceElementObject> &element)
+{
+	auto children = childElementsByParentID.find(parentID);
+
+	if (childElementsByParentID.end() != children)
+	{
+		auto &elements = children->second;
+		elements.erase(std::remove(elements.begin(), elements.end(), element), elements.end());
+
+		if (elements.empty())
+		{
+			childElementsByParentID.erase(children);
+		}
+	}
+}
@@ -0,0 +1,87 @@
+//================================================================================================
+/// @file task_data_aggregator.cpp
+///
+/// @brief Implements an exporter that merges many DDOP files into a single TASKDATA.XML
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso and the Open-Agriculture developers
+//================================================================================================
+#include "task_data_aggregator.hpp"
+#include "iso_xml_writer.hpp"
+#include "isobus/isobus/isobus_device_descriptor_object_pool.hpp"
+#include "mapped_file.hpp"
+#include "work_stealing_pool.hpp"
+
+#include <algorithm>
+#include <memory>
+
+bool TaskDataAggregator::Result::passed() const
+{
+	return fileRead && deserialized && written;
+}
+
+TaskDataAggregator::TaskDataAggregator(std::uint8_t taskControllerVersion, std::size_t numberOfThreads) :
+  numberOfThreads(numberOfThreads),
+  taskControllerVersion(taskControllerVersion)
+{
+}
+
+std::vector<TaskDataAggregator::Result> TaskDataAggregator::aggregate(const std::vector<std::string> &filePaths, std::ostream &output) const
+{
+	std::vector<Result> results(filePaths.size());
+	WorkStealingPool threadPool(numberOfThreads);
+	std::vector<std::unique_ptr<LogContext>> workerLogs;
+
+	for (std::size_t i = 0; i < threadPool.get_number_of_threads(); i++)
+	{
+		workerLogs.push_back(std::make_unique<LogContext>());
+	}
+
+	const std::size_t windowSize = threadPool.get_number_of_threads() * FILES_PER_THREAD;
+	std::vector<std::unique_ptr<isobus::DeviceDescriptorObjectPool>> loadedPools(windowSize);
+	IsoXmlWriter writer(output);
+	writer.begin_task_data(taskControllerVersion);
+
+	for (std::size_t windowStart = 0; windowStart < filePaths.size(); windowStart += windowSize)
+	{
+		const std::size_t windowLength = std::min(windowSize, filePaths.size() - windowStart);
+
+		threadPool.run(windowLength, [&](std::size_t taskIndex, std::size_t workerIndex) {
+			auto &result = results[windowStart + taskIndex];
+			auto &fileLog = *workerLogs[workerIndex];
+			fileLog.clear();
+			ScopedLogContext logScope(fileLog);
+
+			result.filePath = filePaths[windowStart + taskIndex];
+			MappedFile iopFile(result.filePath);
+			result.fileRead = iopFile.is_open() && (iopFile.get_size() <= UINT32_MAX);
+
+			if (result.fileRead)
+			{
+				auto objectPool = std::make_unique<isobus::DeviceDescriptorObjectPool>();
+				objectPool->set_task_controller_compatibility_level(taskControllerVersion);
+				result.deserialized = objectPool->deserialize_binary_object_pool(iopFile.get_data(), static_cast<std::uint32_t>(iopFile.get_size()), isobus::NAME(0));
+				result.numberOfObjects = objectPool->size();
+
+				if (result.deserialized)
+				{
+					loadedPools[taskIndex] = std::move(objectPool);
+				}
+			}
+			result.diagnostics = fileLog.get_messages();
+		});
+
+		// Devices are written in file order, so the DVC numbering is the same on every run
+		for (std::size_t i = 0; i < windowLength; i++)
+		{
+			if (nullptr != loadedPools[i])
+			{
+				results[windowStart + i].written = writer.write_device(*loadedPools[i]);
+				loadedPools[i].reset();
+			}
+		}
+	}
+
+	writer.end_task_data();
+	return results;
+}
@@ -0,0 +1,305 @@
+//================================================================================================
+/// @file validation_cache.cpp
+///
+/// @brief Implements an on-disk cache of validation results, keyed by the content of the DDOP
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso and the Open-Agriculture developers
+//================================================================================================
+#include "validation_cache.hpp"
+#include "agisostack_version.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+
+namespace
+{
+	constexpr std::uint64_t PRIME_1 = 0x9E3779B185EBCA87ULL;
+	constexpr std::uint64_t PRIME_2 = 0xC2B2AE3D27D4EB4FULL;
+	constexpr std::uint64_t PRIME_3 = 0x165667B19E3779F9ULL;
+	constexpr std::uint64_t PRIME_4 = 0x85EBCA77C2B2AE63ULL;
+	constexpr std::uint64_t PRIME_5 = 0x27D4EB2F165667C5ULL;
+	constexpr char ENTRY_MAGIC[4] = { 'D', 'D', 'V', 'C' };
+
+	std::uint64_t rotate_left(std::uint64_t value, int bits)
+	{
+		return (value << bits) | (value >> (64 - bits));
+	}
+
+	std::uint64_t read_little_endian(const std::uint8_t *data, std::size_t numberOfBytes)
+	{
+		std::uint64_t retVal = 0;
+
+		for (std::size_t i = 0; i < numberOfBytes; i++)
+		{
+			retVal |= static_cast<std::uint64_t>(data[i]) << (8 * i);
+		}
+		return retVal;
+	}
+
+	std::uint64_t hash_round(std::uint64_t accumulator, std::uint64_t input)
+	{
+		accumulator += input * PRIME_2;
+		return rotate_left(accumulator, 31) * PRIME_1;
+	}
+
+	std::uint64_t hash_merge_round(std::uint64_t accumulator, std::uint64_t value)
+	{
+		accumulator ^= hash_round(0, value);
+		return (accumulator * PRIME_1) + PRIME_4;
+	}
+
+	void append_little_endian(std::string &buffer, std::uint64_t value, std::size_t numberOfBytes)
+	{
+		for (std::size_t i = 0; i < numberOfBytes; i++)
+		{
+			buffer.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+		}
+	}
+
+	/// @brief Reads the fields of an entry in order, and remembers if it ran past the end
+	class EntryReader
+	{
+	public:
+		explicit EntryReader(const std::string &buffer) :
+		  buffer(buffer)
+		{
+		}
+
+		std::uint64_t read(std::size_t numberOfBytes)
+		{
+			std::uint64_t retVal = 0;
+
+			if (is_valid() && (buffer.size() - position >= numberOfBytes))
+			{
+				retVal = read_little_endian(reinterpret_cast<const std::uint8_t *>(buffer.data()) + position, numberOfBytes);
+				position += numberOfBytes;
+			}
+			else
+			{
+				position = std::string::npos;
+			}
+			return retVal;
+		}
+
+		std::string read_text(std::size_t length)
+		{
+			std::string retVal;
+
+			if (is_valid() && (buffer.size() - position >= length))
+			{
+				retVal = buffer.substr(position, length);
+				position += length;
+			}
+			else
+			{
+				position = std::string::npos;
+			}
+			return retVal;
+		}
+
+		bool is_valid() const
+		{
+			return std::string::npos != position;
+		}
+
+		bool is_at_end() const
+		{
+			return buffer.size() == position;
+		}
+
+	private:
+		const std::string &buffer;
+		std::size_t position = 0;
+	};
+}
+
+ValidationCache::ValidationCache(const std::string &directory) :
+  directory(directory)
+{
+	std::error_code errorCode;
+	std::filesystem::create_directories(directory, errorCode);
+
+	// Start numbering temporary files at a random point, so processes sharing the cache don't collide
+	nextTemporaryFile = std::random_device()();
+}
+
+bool ValidationCache::is_supported()
+{
+	return '\0' != DDOP_AGISOSTACK_VERSION[0];
+}
+
+std::uint64_t ValidationCache::get_key(const std::uint8_t *data, std::size_t size, std::uint8_t taskControllerVersion)
+{
+	const std::string seedText = std::to_string(FORMAT_VERSION) + ";" + std::to_string(taskControllerVersion) + ";" + DDOP_AGISOSTACK_VERSION;
+	const std::uint64_t seed = hash(reinterpret_cast<const std::uint8_t *>(seedText.data()), seedText.size(), 0);
+	return hash(data, size, seed);
+}
+
+bool ValidationCache::find(std::uint64_t key, std::size_t size, Entry &entry)
+{
+	std::ifstream entryFile(get_entry_path(key), std::ios_base::binary);
+	bool retVal = false;
+
+	if (entryFile)
+	{
+		const std::string buffer((std::istreambuf_iterator<char>(entryFile)), std::istreambuf_iterator<char>());
+		EntryReader reader(buffer);
+		bool isHeaderValid = (0 == buffer.compare(0, sizeof(ENTRY_MAGIC), ENTRY_MAGIC, sizeof(ENTRY_MAGIC)));
+
+		reader.read(sizeof(ENTRY_MAGIC));
+		isHeaderValid = isHeaderValid && (FORMAT_VERSION == reader.read(1));
+		isHeaderValid = isHeaderValid && (key == reader.read(8));
+		isHeaderValid = isHeaderValid && (size == reader.read(8));
+
+		if (isHeaderValid)
+		{
+			const std::uint64_t flags = reader.read(1);
+			entry.deserialized = (0 != (flags & 0x01));
+			entry.serialized = (0 != (flags & 0x02));
+			entry.numberOfObjects = static_cast<std::size_t>(reader.read(4));
+			entry.diagnostics.clear();
+
+			for (std::uint64_t i = reader.read(4); (i > 0) && reader.is_valid(); i--)
+			{
+				LogContext::LogInfo diagnostic;
+				diagnostic.logLevel = static_cast<isobus::CANStackLogger::LoggingLevel>(reader.read(1));
+				diagnostic.logText = reader.read_text(static_cast<std::size_t>(reader.read(4)));
+				entry.diagnostics.push_back(std::move(diagnostic));
+			}
+
+			// A damaged entry is treated like a missing one, and gets overwritten by the next store
+			retVal = reader.is_valid() && reader.is_at_end();
+		}
+	}
+
+	if (retVal)
+	{
+		numberOfHits++;
+	}
+	else
+	{
+		numberOfMisses++;
+	}
+	return retVal;
+}
+
+bool ValidationCache::store(std::uint64_t key, std::size_t size, const Entry &entry)
+{
+	std::string buffer(ENTRY_MAGIC, sizeof(ENTRY_MAGIC));
+	append_little_endian(buffer, FORMAT_VERSION, 1);
+	append_little_endian(buffer, key, 8);
+	append_little_endian(buffer, size, 8);
+	append_little_endian(buffer, (entry.deserialized ? 0x01 : 0x00) | (entry.serialized ? 0x02 : 0x00), 1);
+	append_little_endian(buffer, entry.numberOfObjects, 4);
+	append_little_endian(buffer, entry.diagnostics.size(), 4);
+
+	for (const auto &diagnostic : entry.diagnostics)
+	{
+		append_little_endian(buffer, static_cast<std::uint8_t>(diagnostic.logLevel), 1);
+		append_little_endian(buffer, diagnostic.logText.size(), 4);
+		buffer += diagnostic.logText;
+	}
+
+	const std::string entryPath = get_entry_path(key);
+	const std::string temporaryPath = entryPath + "." + std::to_string(nextTemporaryFile.fetch_add(1)) + ".tmp";
+	bool retVal = false;
+	{
+		std::ofstream temporaryFile(temporaryPath, std::ios_base::binary | std::ios_base::trunc);
+		temporaryFile.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+		retVal = static_cast<bool>(temporaryFile);
+	}
+
+	// Renaming over an existing entry is atomic, and two workers storing the same pool write the same bytes
+	std::error_code errorCode;
+
+	if (retVal)
+	{
+		std::filesystem::rename(temporaryPath, entryPath, errorCode);
+		retVal = !errorCode;
+	}
+
+	if (!retVal)
+	{
+		std::filesystem::remove(temporaryPath, errorCode);
+	}
+	return retVal;
+}
+
+std::size_t ValidationCache::get_number_of_hits() const
+{
+	return numberOfHits;
+}
+
+std::size_t ValidationCache::get_number_of_misses() const
+{
+	return numberOfMisses;
+}
+
+std::uint64_t ValidationCache::hash(const std::uint8_t *data, std::size_t size, std::uint64_t seed)
+{
+	const std::uint8_t *const end = data + size;
+	std::uint64_t retVal;
+
+	if (size >= 32)
+	{
+		std::uint64_t accumulators[4] = { seed + PRIME_1 + PRIME_2, seed + PRIME_2, seed, seed - PRIME_1 };
+
+		for (; end - data >= 32; data += 32)
+		{
+			for (std::size_t lane = 0; lane < 4; lane++)
+			{
+				accumulators[lane] = hash_round(accumulators[lane], read_little_endian(data + (8 * lane), 8));
+			}
+		}
+
+		retVal = rotate_left(accumulators[0], 1) + rotate_left(accumulators[1], 7) + rotate_left(accumulators[2], 12) + rotate_left(accumulators[3], 18);
+
+		for (std::uint64_t accumulator : accumulators)
+		{
+			retVal = hash_merge_round(retVal, accumulator);
+		}
+	}
+	else
+	{
+		retVal = seed + PRIME_5;
+	}
+
+	retVal += size;
+
+	for (; end - data >= 8; data += 8)
+	{
+		retVal ^= hash_round(0, read_little_endian(data, 8));
+		retVal = (rotate_left(retVal, 27) * PRIME_1) + PRIME_4;
+	}
+
+	if (end - data >= 4)
+	{
+		retVal ^= read_little_endian(data, 4) * PRIME_1;
+		retVal = (rotate_left(retVal, 23) * PRIME_2) + PRIME_3;
+		data += 4;
+	}
+
+	for (; data < end; data++)
+	{
+		retVal ^= (*data) * PRIME_5;
+		retVal = rotate_left(retVal, 11) * PRIME_1;
+	}
+
+	retVal ^= retVal >> 33;
+	retVal *= PRIME_2;
+	retVal ^= retVal >> 29;
+	retVal *= PRIME_3;
+	retVal ^= retVal >> 32;
+	return retVal;
+}
+
+std::string ValidationCache::get_entry_path(std::uint64_t key) const
+{
+	char fileName[32];
+	std::snprintf(fileName, sizeof(fileName), "%016llx.ddvc", static_cast<unsigned long long>(key));
+	return (std::filesystem::path(directory) / fileName).string();
+}
@@ -0,0 +1,101 @@
+//================================================================================================
+/// @file work_stealing_pool.cpp
+///
+/// @brief Implements a small work stealing thread pool
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso and the Open-Agriculture developers
+//================================================================================================
+#include "work_stealing_pool.hpp"
+
+#include <algorithm>
+#include <thread>
+
+WorkStealingPool::WorkStealingPool(std::size_t numberOfThreads)
+{
+	if (0 == numberOfThreads)
+	{
+		numberOfThreads = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+	}
+
+	for (std::size_t i = 0; i < numberOfThreads; i++)
+	{
+		queues.push_back(std::make_unique<WorkQueue>());
+	}
+}
+
+std::size_t WorkStealingPool::get_number_of_threads() const
+{
+	return queues.size();
+}
+
+void WorkStealingPool::run(std::size_t numberOfTasks, const Task &task)
+{
+	std::size_t numberOfWorkers = std::min(queues.size(), numberOfTasks);
+
+	for (std::size_t i = 0; i < numberOfWorkers; i++)
+	{
+		std::size_t firstTask = (i * numberOfTasks) / numberOfWorkers;
+		std::size_t endTask = ((i + 1) * numberOfTasks) / numberOfWorkers;
+		std::lock_guard<std::mutex> lock(queues[i]->mutex);
+
+		for (std::size_t j = firstTask; j < endTask; j++)
+		{
+			queues[i]->tasks.push_back(j);
+		}
+	}
+
+	std::vector<std::thread> workers;
+	workers.reserve(numberOfWorkers);
+
+	for (std::size_t i = 0; i < numberOfWorkers; i++)
+	{
+		workers.emplace_back([this, i, &task]() {
+			std::size_t taskIndex = 0;
+
+			while (pop_task(i, taskIndex) || steal_task(i, taskIndex))
+			{
+				task(taskIndex, i);
+			}
+		});
+	}
+
+	for (auto &worker : workers)
+	{
+		worker.join();
+	}
+}
+
+bool WorkStealingPool::pop_task(std::size_t workerIndex, std::size_t &taskIndex)
+{
+	bool retVal = false;
+	std::lock_guard<std::mutex> lock(queues[workerIndex]->mutex);
+
+	if (!queues[workerIndex]->tasks.empty())
+	{
+		taskIndex = queues[workerIndex]->tasks.front();
+		queues[workerIndex]->tasks.pop_front();
+		retVal = true;
+	}
+	return retVal;
+}
+
+bool WorkStealingPool::steal_task(std::size_t thiefIndex, std::size_t &taskIndex)
+{
+	bool retVal = false;
+
+	// Tasks are never added while running, so once every other queue is seen empty we are done
+	for (std::size_t offset = 1; (offset < queues.size()) && (!retVal); offset++)
+	{
+		std::size_t victimIndex = (thiefIndex + offset) % queues.size();
+		std::lock_guard<std::mutex> lock(queues[victimIndex]->mutex);
+
+		if (!queues[victimIndex]->tasks.empty())
+		{
+			taskIndex = queues[victimIndex]->tasks.back();
+			queues[victimIndex]->tasks.pop_back();
+			retVal = true;
+		}
+	}
+	return retVal;
+}
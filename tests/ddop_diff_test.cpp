@@ -0,0 +1,182 @@
+//================================================================================================
+/// @file ddop_diff_test.cpp
+///
+/// @brief Checks the comparison and three-way merge of DDOPs on small hand-built pools
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso and the Open-Agriculture developers
+//================================================================================================
+#include "ddop_diff.hpp"
+#include "isobus/isobus/isobus_device_descriptor_object_pool.hpp"
+
+#include <array>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+	using isobus::task_controller_object::DeviceElementObject;
+	using isobus::task_controller_object::DeviceProcessDataObject;
+
+	constexpr std::uint16_t NULL_OBJECT_ID = 0xFFFF;
+
+	std::size_t numberOfFailures = 0;
+
+	void check(bool condition, const std::string &description)
+	{
+		if (!condition)
+		{
+			std::cerr << "FAILED: " << description << std::endl;
+			numberOfFailures++;
+		}
+	}
+
+	/// @brief Builds a device with one element holding two process data objects, and a section
+	/// holding a property. Every ID except the device's is shifted by idOffset.
+	void build_pool(isobus::DeviceDescriptorObjectPool &pool, std::uint16_t idOffset)
+	{
+		const std::uint16_t deviceElementID = 1 + idOffset;
+		const std::uint16_t sectionID = 4 + idOffset;
+
+		pool.add_device("Sprayer", "1.0.0", "123", "TEST01", std::array<std::uint8_t, 7>(), std::vector<std::uint8_t>(), 0);
+		pool.add_device_value_presentation("Litres", 0, 0.001f, 1, 6 + idOffset);
+		pool.add_device_element("Sprayer", 0, 0, DeviceElementObject::Type::Device, deviceElementID);
+		pool.add_device_process_data("Rate", 1, 6 + idOffset, 0x01, 0x08, 2 + idOffset);
+		pool.add_device_process_data("Total", 80, 6 + idOffset, 0x01, 0x08, 3 + idOffset);
+		pool.add_device_element("Section", 1, deviceElementID, DeviceElementObject::Type::Section, sectionID);
+		pool.add_device_property("Width", 3000, 67, NULL_OBJECT_ID, 5 + idOffset);
+
+		auto deviceElement = std::static_pointer_cast<DeviceElementObject>(pool.get_object_by_id(deviceElementID));
+		deviceElement->add_reference_to_child_object(2 + idOffset);
+		deviceElement->add_reference_to_child_object(3 + idOffset);
+		std::static_pointer_cast<DeviceElementObject>(pool.get_object_by_id(sectionID))->add_reference_to_child_object(5 + idOffset);
+	}
+
+	bool has_conflict(const std::vector<DdopDiff::Conflict> &conflicts, std::uint16_t objectID, DdopDiff::Field field, const std::string &theirValue)
+	{
+		bool retVal = false;
+
+		for (const auto &conflict : conflicts)
+		{
+			retVal = retVal || ((objectID == conflict.objectID) && (field == conflict.field) && (theirValue == conflict.theirValue));
+		}
+		return retVal;
+	}
+
+	bool has_child(isobus::DeviceDescriptorObjectPool &pool, std::uint16_t elementID, std::uint16_t childID)
+	{
+		auto element = std::static_pointer_cast<DeviceElementObject>(pool.get_object_by_id(elementID));
+		bool retVal = false;
+
+		for (std::uint16_t i = 0; (nullptr != element) && (i < element->get_number_child_objects()); i++)
+		{
+			retVal = retVal || (childID == element->get_child_object_id(i));
+		}
+		return retVal;
+	}
+
+	void test_renumbered_pairing()
+	{
+		isobus::DeviceDescriptorObjectPool basePool;
+		isobus::DeviceDescriptorObjectPool renumberedPool;
+		build_pool(basePool, 0);
+		build_pool(renumberedPool, 100);
+
+		bool onlyIDsChanged = true;
+		for (const auto &change : DdopDiff::compare(basePool, renumberedPool))
+		{
+			onlyIDsChanged = onlyIDsChanged && (DdopDiff::ChangeType::Modified == change.type);
+
+			for (const auto &fieldChange : change.fieldChanges)
+			{
+				onlyIDsChanged = onlyIDsChanged && (DdopDiff::Field::ObjectID == fieldChange.field);
+			}
+		}
+		check(onlyIDsChanged, "renumbered objects are paired, and only their IDs differ");
+
+		isobus::DeviceDescriptorObjectPool mergedPool;
+		std::vector<DdopDiff::Conflict> conflicts;
+		check(DdopDiff::merge(basePool, basePool, renumberedPool, mergedPool, conflicts), "merging a renumbered pool succeeds");
+		check(conflicts.empty(), "merging a renumbered pool has no conflicts");
+		check(DdopDiff::compare(basePool, mergedPool).empty(), "merging a renumbered pool keeps our pool");
+	}
+
+	void test_delete_modify_conflicts()
+	{
+		isobus::DeviceDescriptorObjectPool basePool;
+		isobus::DeviceDescriptorObjectPool ourPool;
+		isobus::DeviceDescriptorObjectPool theirPool;
+		build_pool(basePool, 0);
+		build_pool(ourPool, 0);
+		build_pool(theirPool, 0);
+
+		// We delete process data 3, they rename it. We rename process data 2, they delete it.
+		std::static_pointer_cast<DeviceElementObject>(ourPool.get_object_by_id(1))->remove_reference_to_child_object(3);
+		ourPool.remove_object_by_id(3);
+		ourPool.get_object_by_id(2)->set_designator("Our rate");
+		theirPool.get_object_by_id(3)->set_designator("Their total");
+		std::static_pointer_cast<DeviceElementObject>(theirPool.get_object_by_id(1))->remove_reference_to_child_object(2);
+		theirPool.remove_object_by_id(2);
+
+		isobus::DeviceDescriptorObjectPool mergedPool;
+		std::vector<DdopDiff::Conflict> conflicts;
+		DdopDiff::merge(basePool, ourPool, theirPool, mergedPool, conflicts);
+		check(has_conflict(conflicts, 3, DdopDiff::Field::Object, "modified"), "deleting an object they modified is a conflict");
+		check(has_conflict(conflicts, 2, DdopDiff::Field::Object, "deleted"), "modifying an object they deleted is a conflict");
+		check(nullptr == mergedPool.get_object_by_id(3), "our deletion is kept");
+		check((nullptr != mergedPool.get_object_by_id(2)) && has_child(mergedPool, 1, 2), "our modified object is kept");
+	}
+
+	void test_their_added_references()
+	{
+		isobus::DeviceDescriptorObjectPool basePool;
+		isobus::DeviceDescriptorObjectPool ourPool;
+		isobus::DeviceDescriptorObjectPool theirPool;
+		build_pool(basePool, 0);
+		build_pool(ourPool, 0);
+		build_pool(theirPool, 0);
+
+		// We delete the property 5. They add process data 20 to the section, a new element 21
+		// holding the property, and a reference to the property to the device element.
+		std::static_pointer_cast<DeviceElementObject>(ourPool.get_object_by_id(4))->remove_reference_to_child_object(5);
+		ourPool.remove_object_by_id(5);
+		theirPool.add_device_process_data("Count", 2, 6, 0x01, 0x08, 20);
+		std::static_pointer_cast<DeviceElementObject>(theirPool.get_object_by_id(4))->add_reference_to_child_object(20);
+		theirPool.add_device_element("Boom", 2, 1, DeviceElementObject::Type::Section, 21);
+		std::static_pointer_cast<DeviceElementObject>(theirPool.get_object_by_id(21))->add_reference_to_child_object(5);
+		std::static_pointer_cast<DeviceElementObject>(theirPool.get_object_by_id(1))->add_reference_to_child_object(5);
+
+		isobus::DeviceDescriptorObjectPool mergedPool;
+		std::vector<DdopDiff::Conflict> conflicts;
+		check(DdopDiff::merge(basePool, ourPool, theirPool, mergedPool, conflicts), "merging their added objects succeeds");
+
+		auto addedProcessData = std::static_pointer_cast<DeviceProcessDataObject>(mergedPool.get_object_by_id(20));
+		check((nullptr != addedProcessData) && (6 == addedProcessData->get_device_value_presentation_object_id()), "their added object keeps its references");
+		check(has_child(mergedPool, 4, 20), "their added child reference is merged");
+		check((nullptr != mergedPool.get_object_by_id(21)) && !has_child(mergedPool, 21, 5), "a child we deleted isn't copied into their added element");
+		check(has_conflict(conflicts, 21, DdopDiff::Field::ChildObjects, "5"), "a child dropped from their added element is a conflict");
+		check(!has_child(mergedPool, 1, 5), "a child we deleted isn't added to an existing element");
+		check(has_conflict(conflicts, 1, DdopDiff::Field::ChildObjects, "5"), "a child dropped from an existing element is a conflict");
+		check(2 == conflicts.size(), "only the dropped references are conflicts");
+
+		std::vector<std::uint8_t> binaryPool;
+		check(mergedPool.generate_binary_object_pool(binaryPool), "the merged pool is valid");
+	}
+}
+
+int main()
+{
+	test_renumbered_pairing();
+	test_delete_modify_conflicts();
+	test_their_added_references();
+
+	if (0 == numberOfFailures)
+	{
+		std::cout << "All checks passed" << std::endl;
+		return EXIT_SUCCESS;
+	}
+	return EXIT_FAILURE;
+}